@@ -78,6 +78,13 @@ void rosToOpen3d(const sensor_msgs::PointCloud2ConstPtr& ros_pc2, open3d::t::geo
                  bool skip_colors = false);
 
 
+/**
+ * @brief Copy a triangle mesh to a open3d_slam_msgs::PolygonMesh, vertex colors are kept if present
+ *
+ * @param mesh Reference to the open3d mesh, only TriangleMesh is supported
+ * @param frameId The string to be placed in the frame_id of the message and its cloud
+ * @param msg Reference to the PolygonMesh
+ */
 void open3dToRos(const open3d::geometry::MeshBase &mesh, const std::string &frameId,  open3d_slam_msgs::PolygonMesh &msg);
 
 
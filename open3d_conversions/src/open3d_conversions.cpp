@@ -281,7 +281,9 @@ void open3dToRos(const open3d::geometry::MeshBase &mesh, const std::string &fram
 	PointCloud pointCloud;
 	const int nVertices = mesh.vertices_.size();
 	pointCloud.points_ = mesh.vertices_;
+	pointCloud.colors_ = mesh.vertex_colors_;
 	open3dToRos(pointCloud, msg.cloud, frameId);
+	msg.header = msg.cloud.header;
 
 	if (mesh.GetGeometryType() != Geometry::GeometryType::TriangleMesh) {
 		throw std::runtime_error("Only triangle mesh supported for now!");
@@ -319,6 +321,7 @@ void rosToOpen3d(const open3d_slam_msgs::PolygonMesh &msg, open3d::geometry::Tri
 
 		rosToOpen3d(msg.cloud,pointCloud);
 		mesh.vertices_=pointCloud.points_;
+		mesh.vertex_colors_=pointCloud.colors_;
 
 		// add triangles
 			const int nTriangles = msg.polygons.size();
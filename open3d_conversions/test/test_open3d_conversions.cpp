@@ -163,6 +163,33 @@ TEST(ConversionFunctions, rosToOpen3d_colored)
   }
 }
 
+TEST(ConversionFunctions, open3dToRos_colored_mesh)
+{
+  open3d::geometry::TriangleMesh o3d_mesh;
+  for (int i = 0; i < 5; ++i)
+  {
+    o3d_mesh.vertices_.push_back(Eigen::Vector3d(0.5 * i, i * i, 10.5 * i));
+    o3d_mesh.vertex_colors_.push_back(Eigen::Vector3d(2 * i / 255.0, 5 * i / 255.0, 10 * i / 255.0));
+  }
+  o3d_mesh.triangles_.push_back(Eigen::Vector3i(0, 1, 2));
+  o3d_mesh.triangles_.push_back(Eigen::Vector3i(2, 3, 4));
+  open3d_slam_msgs::PolygonMesh msg;
+  open3d_conversions::open3dToRos(o3d_mesh, "o3d_frame", msg);
+  EXPECT_EQ(msg.header.frame_id, "o3d_frame");
+  EXPECT_EQ(msg.polygons.size(), o3d_mesh.triangles_.size());
+  open3d::geometry::TriangleMesh converted;
+  open3d_conversions::rosToOpen3d(msg, converted);
+  EXPECT_EQ(converted.vertices_.size(), o3d_mesh.vertices_.size());
+  ASSERT_EQ(converted.vertex_colors_.size(), o3d_mesh.vertex_colors_.size());
+  ASSERT_EQ(converted.triangles_.size(), o3d_mesh.triangles_.size());
+  for (int i = 0; i < 5; i++)
+  {
+    EXPECT_EQ(converted.vertices_[i], o3d_mesh.vertices_[i]);
+    EXPECT_EQ(converted.vertex_colors_[i], o3d_mesh.vertex_colors_[i]);
+  }
+  EXPECT_EQ(converted.triangles_[1], o3d_mesh.triangles_[1]);
+}
+
 TEST(ConversionFunctionsTgeometry, open3dToRos_uncolored_tgeometry)
 {
   open3d::t::geometry::PointCloud o3d_tpc;
@@ -7,8 +7,6 @@
 #pragma once
 
 #include <vector>
-#include <unordered_map>
-#include <set>
 #include <Eigen/Core>
 #include "open3d_slam/Voxel.hpp"
 #include "open3d_slam/typedefs.hpp"
@@ -24,15 +22,18 @@ public:
 	void addEdge(SubmapId id1, SubmapId id2);
 	bool isAdjacent(SubmapId id1, SubmapId id2) const;
 	void markAsLoopClosureSubmap(SubmapId id);
+	// number of submaps in between, max int if no loop closure submap is connected
 	int getDistanceToNearestLoopClosureSubmap(SubmapId id) const;
 	void print() const;
 	void clear();
 private:
+	void addNode(SubmapId id);
+	// multi source bfs from the loop closure submaps, edges and sources are only ever added so distances only shrink
+	void propagateDistance(SubmapId id, int distance);
 
-
-	std::unordered_map<SubmapId, std::set<SubmapId>> adjacency_;
-	std::unordered_map<SubmapId, bool> isLoopClosureSubmap_;
-
+	// indexed by submap id
+	std::vector<std::vector<SubmapId>> adjacency_; // sorted
+	std::vector<int> distanceToLoopClosureSubmap_; // in edges
 
 };
 } //namespace o3d_slam
@@ -25,7 +25,8 @@ public:
 	virtual RegistrationResult registerClouds(const PointCloud &source, const PointCloud &target,
 			const Transform &init) const = 0;
 	virtual void estimateNormalsOrCovariancesIfNeeded(PointCloud *cloud) const {}
-
+	virtual void setMaxCorrespondenceDistance(double distance) = 0;
+	virtual void setMaxNumIterations(int maxNumIter) = 0;
 
 };
 
@@ -37,6 +38,12 @@ public:
 	RegistrationResult registerClouds(const PointCloud &source, const PointCloud &target,
 			const Transform &init) const final;
 	void estimateNormalsOrCovariancesIfNeeded(PointCloud *cloud) const final;
+	void setMaxCorrespondenceDistance(double distance) final {
+		maxCorrespondenceDistance_ = distance;
+	}
+	void setMaxNumIterations(int maxNumIter) final {
+		icpConvergenceCriteria_.max_iteration_ = maxNumIter;
+	}
 
 	double maxCorrespondenceDistance_ = 1.0;
 	int knnNormalEstimation_ = 10;
@@ -52,6 +59,12 @@ public:
 	~RegistrationIcpPointToPoint() override = default;
 	RegistrationResult registerClouds(const PointCloud &source, const PointCloud &target,
 			const Transform &init) const final;
+	void setMaxCorrespondenceDistance(double distance) final {
+		maxCorrespondenceDistance_ = distance;
+	}
+	void setMaxNumIterations(int maxNumIter) final {
+		icpConvergenceCriteria_.max_iteration_ = maxNumIter;
+	}
 
 	double maxCorrespondenceDistance_ = 1.0;
 	open3d::pipelines::registration::ICPConvergenceCriteria icpConvergenceCriteria_;
@@ -65,6 +78,12 @@ public:
 	RegistrationResult registerClouds(const PointCloud &source, const PointCloud &target,
 			const Transform &init) const final;
 	void estimateNormalsOrCovariancesIfNeeded(PointCloud *cloud) const final;
+	void setMaxCorrespondenceDistance(double distance) final {
+		maxCorrespondenceDistance_ = distance;
+	}
+	void setMaxNumIterations(int maxNumIter) final {
+		icpConvergenceCriteria_.max_iteration_ = maxNumIter;
+	}
 
 	double maxCorrespondenceDistance_ = 1.0;
 	int knnNormalEstimation_ = 10;
@@ -0,0 +1,44 @@
+/*
+ * CompactPointCloud.hpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#pragma once
+
+#include <array>
+#include <vector>
+#include "open3d_slam/Transform.hpp"
+#include "open3d_slam/typedefs.hpp"
+
+namespace o3d_slam {
+
+// Point cloud stored relative to an origin with points quantized to a fixed resolution, normals
+// octahedral encoded, colors as RGB8 and covariances as the upper triangle in single precision.
+// Decoded points are off by at most half the resolution along each axis of the origin.
+// Optional per-point weights (e.g. voxel point counts) are kept as uint16, saturating at its max.
+class CompactPointCloud {
+public:
+	EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+	void encode(const PointCloud &cloud, const Transform &origin, double resolution,
+			const std::vector<int> &weights = {});
+	void decode(PointCloud *cloud, std::vector<int> *weights = nullptr) const;
+	// moves the origin, the stored points are left untouched
+	void transform(const Transform &T);
+	size_t size() const;
+	bool empty() const;
+	void clear();
+	size_t getNumBytes() const;
+
+private:
+	Transform origin_ = Transform::Identity();
+	double resolution_ = 0.01;
+	std::vector<std::array<int16, 3>> points16_;
+	std::vector<std::array<int32, 3>> points32_; // only if the extent does not fit into int16
+	std::vector<std::array<int16, 2>> normals_;
+	std::vector<std::array<uint8, 3>> colors_;
+	std::vector<std::array<float, 6>> covariances_;
+	std::vector<uint16> weights_;
+};
+
+} // namespace o3d_slam
@@ -0,0 +1,35 @@
+/*
+ * GaussNewton.hpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#pragma once
+
+#include <functional>
+#include <Eigen/Dense>
+#include "open3d/pipelines/registration/Registration.h"
+#include "open3d_slam/Transform.hpp"
+
+namespace o3d_slam {
+
+// Normal equations of a rigid transform, perturbations are [rotation, translation] applied from the left.
+struct GaussNewtonSystem {
+	EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+	Eigen::Matrix<double, 6, 6> H_ = Eigen::Matrix<double, 6, 6>::Zero();
+	Eigen::Matrix<double, 6, 1> g_ = Eigen::Matrix<double, 6, 1>::Zero();
+	double sumSquaredResiduals_ = 0.0;
+	int numCorrespondences_ = 0;
+};
+
+// jacobian of T*p w.r.t. a small left perturbation, p already transformed
+Eigen::Matrix<double, 3, 6> pointJacobian(const Eigen::Vector3d &p);
+
+// Iterates until the increment is below convergenceThreshold, maxNumIter is reached or the linearization has
+// fewer than minNumCorrespondences. Fitness is numCorrespondences / numSourcePoints.
+using LinearizeFunction = std::function<void(const Transform &T, GaussNewtonSystem *system)>;
+open3d::pipelines::registration::RegistrationResult optimizeRigidTransform(const Transform &init,
+		size_t numSourcePoints, int maxNumIter, int minNumCorrespondences, double convergenceThreshold,
+		const LinearizeFunction &linearize);
+
+} // namespace o3d_slam
@@ -0,0 +1,35 @@
+/*
+ * InitialMapCache.hpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#pragma once
+#include <string>
+#include <vector>
+#include "open3d_slam/Parameters.hpp"
+#include "open3d_slam/Relocalization.hpp"
+#include "open3d_slam/typedefs.hpp"
+
+namespace o3d_slam {
+
+// Binary cache of the prepared (normals estimated and voxelized) initial map.
+// Entries are keyed by a hash of the raw map and of the parameters that affect the preparation.
+uint64 computeInitialMapCacheKey(const PointCloud &rawMap, const MapperParameters &p);
+std::string getInitialMapCacheFilename(const std::string &directory, uint64 key);
+bool saveInitialMapCache(const std::string &filename, uint64 key, const PointCloud &preparedMap);
+
+// Memory maps the file and copies the arrays out of it, returns false if the file
+// is missing, corrupted or written for another key.
+bool loadInitialMapCache(const std::string &filename, uint64 key, PointCloud *preparedMap);
+
+// The relocalization places (with their features) of the prepared initial map, stored next to it.
+// The key combines the initial map key with the parameters that affect the places.
+uint64 computeRelocalizationPlacesCacheKey(uint64 initialMapKey, const MapperParameters &p);
+std::string getRelocalizationPlacesCacheFilename(const std::string &directory, uint64 key);
+bool saveRelocalizationPlacesCache(const std::string &filename, uint64 key,
+		const std::vector<Relocalizer::Place> &places);
+bool loadRelocalizationPlacesCache(const std::string &filename, uint64 key,
+		std::vector<Relocalizer::Place> *places);
+
+} // namespace o3d_slam
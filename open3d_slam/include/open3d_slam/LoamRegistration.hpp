@@ -0,0 +1,40 @@
+/*
+ * LoamRegistration.hpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#pragma once
+
+#include "open3d_slam/CloudRegistration.hpp"
+
+namespace o3d_slam {
+
+// Edge and planar points picked by curvature along each ring, evenly over the sectors of the ring.
+// Planar features carry their normal, edge features a zero normal.
+PointCloudPtr extractLoamFeatures(const PointCloud &scan, const LoamParameters &p);
+bool isLoamEdgeFeature(const PointCloud &features, size_t idx);
+
+// Point to line distance for edges and point to plane distance for planar features,
+// minimized with Gauss-Newton. Both clouds have to come from extractLoamFeatures.
+class RegistrationLoam: public CloudRegistration {
+public:
+	using RegistrationResult = open3d::pipelines::registration::RegistrationResult;
+	RegistrationLoam() = default;
+	~RegistrationLoam() override = default;
+	RegistrationResult registerClouds(const PointCloud &source, const PointCloud &target,
+			const Transform &init) const final;
+	void setMaxCorrespondenceDistance(double distance) final {
+		maxCorrespondenceDistance_ = distance;
+	}
+	void setMaxNumIterations(int maxNumIter) final {
+		maxNumIter_ = maxNumIter;
+	}
+
+	double maxCorrespondenceDistance_ = 1.0;
+	int maxNumIter_ = 20;
+};
+
+std::unique_ptr<RegistrationLoam> createLoam(const CloudRegistrationParameters &p);
+
+} // namespace o3d_slam
@@ -0,0 +1,60 @@
+/*
+ * LocalizationMap.hpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <open3d/geometry/KDTreeFlann.h>
+#include <open3d/pipelines/registration/Registration.h>
+#include "open3d_slam/Parameters.hpp"
+#include "open3d_slam/Transform.hpp"
+#include "open3d_slam/typedefs.hpp"
+#include "open3d_slam/VoxelHashMap.hpp"
+
+namespace o3d_slam {
+
+// Static prior map used in localization only mode. The map is split once into tiles,
+// each tile has a k-d tree and precomputed normals (and covariances for GICP). Tiles
+// are padded with the points of their neighbors within the max correspondence distance,
+// hence each correspondence search touches only the tile containing the query point.
+class LocalizationMap {
+
+public:
+	using RegistrationResult = open3d::pipelines::registration::RegistrationResult;
+
+	LocalizationMap() = default;
+	~LocalizationMap() = default;
+
+	void setParameters(const MapperParameters &p);
+	void build(const PointCloud &map);
+	// built only once, even from an empty map
+	bool isBuilt() const;
+	bool isEmpty() const;
+	size_t getNumTiles() const;
+	PointCloud getMapPointCloudCopy() const;
+	RegistrationResult registerScan(const PointCloud &scan, const Transform &initialGuess) const;
+
+private:
+	struct Tile {
+		PointCloud cloud_;
+		std::shared_ptr<open3d::geometry::KDTreeFlann> kdTree_;
+	};
+
+	const Tile *findTile(const Eigen::Vector3d &p) const;
+	bool isGeneralizedIcp() const;
+
+	MapperParameters params_;
+	Eigen::Vector3d tileSize_ = Eigen::Vector3d::Constant(20.0);
+	std::unordered_map<Eigen::Vector3i, Tile, EigenVec3iHash> tiles_;
+	PointCloud map_;
+	bool isBuilt_ = false;
+	std::unique_ptr<open3d::pipelines::registration::TransformationEstimation> estimation_;
+	mutable std::mutex mapMutex_;
+};
+
+} // namespace o3d_slam
@@ -15,10 +15,18 @@
 #include "open3d_slam/croppers.hpp"
 #include "open3d_slam/SubmapCollection.hpp"
 #include "open3d_slam/TransformInterpolationBuffer.hpp"
+#include "open3d_slam/ResolutionController.hpp"
 
 namespace o3d_slam {
 
 class ScanToMapRegistration;
+class LocalizationMap;
+class Relocalizer;
+
+struct KeyframeStatistics {
+	size_t numScans_ = 0;
+	size_t numKeyframes_ = 0;
+};
 
 class Mapper {
 
@@ -33,6 +41,8 @@ public:
 	void setParameters(const MapperParameters &p);
 	void setMapToRangeSensor(const Transform &t);
 	void setMapToRangeSensorInitial(const Transform &t);
+	// unlike setParameters keeps the submaps
+	void setScanResolution(const ScanResolution &resolution);
 
 	const Submap& getActiveSubmap() const;
 	const SubmapCollection& getSubmaps() const;
@@ -47,16 +57,35 @@ public:
 
 	void loopClosureUpdate(const Transform &loopClosureCorrection);
 	bool hasProcessedMeasurements() const;
+	bool isUseLocalizationMap() const;
+	bool isRelocalizationNeeded() const;
 	bool addRangeMeasurement(const PointCloud &cloud, const Time &timestamp);
+	// places already set on the relocalizer (e.g. loaded from the initial map cache) are kept
+	void buildRelocalizationPlacesIfNeeded(const PointCloud &initialMap);
+	// nullptr unless relocalization is enabled and a map is loaded
+	std::shared_ptr<Relocalizer> getRelocalizer() const;
+	// i.e. the last scan was refined against the map, possibly unsuccessfully
+	bool isLastScanKeyframe() const;
+	KeyframeStatistics getAndResetKeyframeStatistics();
 	
 private:
 	void update(const MapperParameters &p);
 	void checkTransformChainingAndPrintResult(bool isCheckTransformChainingAndPrintResult) const;
+	bool isKeyframe(const Transform &mapToRangeSensorEstimate, const Time &timestamp) const;
+	// failed attempts are retried at most once per min time between attempts
+	bool isRelocalizationAttemptDue(const Time &timestamp) const;
+	bool relocalize(const PointCloud &scan, const Time &timestamp);
 
 	Time lastMeasurementTimestamp_;
 	Transform mapToRangeSensor_ = Transform::Identity();
 	Transform mapToRangeSensorPrev_ = Transform::Identity();
 	Transform mapToRangeSensorLastScanInsertion_ = Transform::Identity();
+	Transform mapToRangeSensorLastKeyframe_ = Transform::Identity();
+	Time lastKeyframeTimestamp_;
+	double lastRefinementFitness_ = 0.0;
+	bool isForceKeyframe_ = false; // set by a rejected refinement, the next scan is refined again
+	KeyframeStatistics keyframeStatistics_;
+	bool isLastScanKeyframe_ = false;
 
 	MapperParameters params_;
 	std::mutex mapManipulationMutex_;
@@ -67,6 +96,12 @@ private:
 	bool isNewInitialValueSet_ = false;
 	bool isIgnoreOdometryPrediction_ = false;
 	std::shared_ptr<ScanToMapRegistration> scan2MapReg_;
+	std::shared_ptr<LocalizationMap> localizationMap_;
+	std::shared_ptr<Relocalizer> relocalizer_;
+	bool isRelocalizationNeeded_ = false;
+	size_t numFailedRefinements_ = 0;
+	bool isLastRelocalizationFailed_ = false;
+	Time lastRelocalizationAttemptTimestamp_;
 
 };
 
@@ -15,6 +15,12 @@
 
 namespace o3d_slam {
 
+// phase in [0,1] of a point within a sweep of a spinning lidar, computed in the lidar frame
+double computeScanPhase(double x, double y, bool isSpinningClockwise);
+// body frame velocities from the last numPoses poses in the buffer, zero if there are not enough poses
+void estimateConstantVelocity(const TransformBufferSnapshot &buffer, int numPoses, Eigen::Vector3d *linearVelocity,
+		Eigen::Vector3d *angularVelocityRpy);
+
 class MotionCompensation {
 
 public:
@@ -0,0 +1,47 @@
+/*
+ * OccupancyMap.hpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#pragma once
+
+#include <Eigen/Core>
+#include <vector>
+#include "open3d_slam/Parameters.hpp"
+#include "open3d_slam/VoxelHashMap.hpp"
+
+namespace o3d_slam {
+
+struct OccupancyVoxel {
+	float logOdds_ = 0.0f;
+	Eigen::Vector3f normal_ = Eigen::Vector3f::Zero(); // of the last hit, zero if unknown
+	size_t lastUpdate_ = 0; // each voxel is updated at most once per scan, hits take precedence
+	std::vector<size_t> pointIdxs_; // of the map points inside, removed together with the voxel
+};
+
+// Log-odds occupancy of the voxels that were hit by a scan. Rays are traversed with an integer DDA
+// and lower the occupancy of the stored voxels they pass through, free space itself is not stored.
+// Each voxel knows the map points inside it, hence freeing a voxel never searches the map.
+class OccupancyVoxelMap : public VoxelHashMap<OccupancyVoxel> {
+	using BASE = VoxelHashMap<OccupancyVoxel>;
+public:
+	EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+	OccupancyVoxelMap();
+	OccupancyVoxelMap(const Eigen::Vector3d &voxelSize, const SpaceCarvingParameters &params);
+	// scan in the map frame, returns the idxs of the map points in the voxels freed by it, these voxels are erased
+	std::vector<size_t> insertScan(const PointCloud &scan, const Eigen::Vector3d &sensorPosition);
+	// assigns the points of map starting at startIdx to their voxels, voxels created for them count as hit once
+	void addPoints(const PointCloud &map, size_t startIdx = 0);
+	// call after the idxs of the map points changed, removed points are skipped
+	void rebuildPoints(const PointCloud &map, const std::vector<bool> &isPointRemoved = {});
+
+private:
+	void traverse(const Eigen::Vector3d &sensorPosition, const Eigen::Vector3d &p,
+			std::vector<Eigen::Vector3i> *missedKeys) const;
+	void addPoint(const Eigen::Vector3d &p, size_t idx);
+	SpaceCarvingParameters params_;
+	size_t nScans_ = 0;
+};
+
+} // namespace o3d_slam
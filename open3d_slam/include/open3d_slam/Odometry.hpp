@@ -12,11 +12,26 @@
 #include "open3d_slam/Parameters.hpp"
 #include "open3d_slam/croppers.hpp"
 #include "open3d_slam/TransformInterpolationBuffer.hpp"
+#include "open3d_slam/ResolutionController.hpp"
 
 namespace o3d_slam {
 
 class CloudRegistration;
 
+// KISS-ICP style correspondence distance, 3 sigma of the deviation between the predicted
+// and the registered motion. Uses initialDistance until the first motion was observed.
+class AdaptiveCorrespondenceDistance {
+public:
+	AdaptiveCorrespondenceDistance(double initialDistance, double minDistance, double maxRange, double minMotion);
+	double getDistance() const;
+	void update(const Transform &predictionToRegistration);
+
+private:
+	double initialDistance_, minDistance_, maxRange_, minMotion_;
+	double sumSquaredDeviations_ = 0.0;
+	int numSamples_ = 0;
+};
+
 class LidarOdometry {
 
 public:
@@ -29,6 +44,8 @@ public:
 	const Transform getOdomToRangeSensor(const Time &t) const;
 	const open3d::geometry::PointCloud &getPreProcessedCloud() const;
 	void setParameters (const OdometryParameters &p);
+	// unlike setParameters keeps the registration state
+	void setScanResolution(const ScanResolution &resolution);
 	const TransformInterpolationBuffer &getBuffer() const;
 	bool hasProcessedMeasurements() const;
 	void setInitialTransform(const Eigen::Matrix4d &initialTransform);
@@ -46,6 +63,8 @@ private:
 	Eigen::Matrix4d initialTransform_ = Eigen::Matrix4d::Identity();
 	bool isInitialTransformSet_ = false;
 	std::shared_ptr<CloudRegistration> cloudRegistration_;
+	std::shared_ptr<AdaptiveCorrespondenceDistance> adaptiveCorrespondenceDistance_;
+	Transform lastRegistration_ = Transform::Identity(); // constant velocity prediction for the next scan
 };
 
 } // namespace o3d_slam
@@ -39,6 +39,7 @@ public:
 	void loadFromFile(const std::string &filename);
 	void setParameters(const MapperParameters &p);
 	const Constraints &getLoopClosureConstraints() const;
+	const Constraints &getOdometryConstraints() const;
 	void updateLoopClosureConstraint(size_t idx, const Constraint &c);
 
 private:
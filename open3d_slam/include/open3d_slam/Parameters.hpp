@@ -39,25 +39,29 @@ struct Parameters {
 enum class CloudRegistrationType : int {
 	PointToPlaneIcp,
 	PointToPointIcp,
-	GeneralizedIcp
+	GeneralizedIcp,
+	LoamFeatures
 };
 
 static const std::map<std::string, CloudRegistrationType> CloudRegistrationStringToEnumMap {
 	{"PointToPlaneIcp",CloudRegistrationType::PointToPlaneIcp},
 	{"PointToPointIcp",CloudRegistrationType::PointToPointIcp},
-	{"GeneralizedIcp",CloudRegistrationType::GeneralizedIcp}
+	{"GeneralizedIcp",CloudRegistrationType::GeneralizedIcp},
+	{"LoamFeatures",CloudRegistrationType::LoamFeatures}
 };
 
 enum class ScanToMapRegistrationType : int {
 	PointToPlaneIcp,
 	PointToPointIcp,
-	GeneralizedIcp
+	GeneralizedIcp,
+	Ndt
 };
 
 static const std::map<std::string, ScanToMapRegistrationType> ScanToMapRegistrationStringToEnumMap {
 	{"PointToPlaneIcp",ScanToMapRegistrationType::PointToPlaneIcp},
 	{"PointToPointIcp",ScanToMapRegistrationType::PointToPointIcp},
-	{"GeneralizedIcp",ScanToMapRegistrationType::GeneralizedIcp}
+	{"GeneralizedIcp",ScanToMapRegistrationType::GeneralizedIcp},
+	{"Ndt",ScanToMapRegistrationType::Ndt}
 };
 
 struct ScanCroppingParameters {
@@ -79,19 +83,62 @@ struct IcpParameters {
 	double maxCorrespondenceDistance_ = 0.2;
 	int knn_ = 5;
 	double maxDistanceKnn_ = 10.0;
+	double relativeFitness_ = 1e-6; // stops before max num iter once fitness and rmse stop changing
+	double relativeRmse_ = 1e-6;
+};
+
+struct AdaptiveResolutionParameters {
+	bool isEnabled_ = false;
+	double targetLatencyMsec_ = 100.0;
+	size_t maxQueueSize_ = 1; // more queued scans make the resolution coarser regardless of the latency
+	double maxVoxelSize_ = 0.5; // coarsest bounds, the configured scan processing values are the finest
+	double minDownSamplingRatio_ = 0.3;
+	int minNumIter_ = 10;
+};
+
+struct AdaptiveCorrespondenceDistanceParameters {
+	bool isEnabled_ = false;
+	double minMotion_ = 0.1; // m, smaller motions don't update the deviation statistics
+};
+
+struct LoamParameters {
+	int numRings_ = 64; // the scan is projected into a range image by elevation in the frame of the spinning lidar
+	double minElevation_ = -22.5; // deg
+	double maxElevation_ = 22.5; // deg
+	int numColumns_ = 1024;
+	int numSectors_ = 6; // features are selected evenly in sectors of each ring
+	int maxNumEdgesPerSector_ = 4;
+	int maxNumPlanarsPerSector_ = 8;
+	double edgeCurvatureThreshold_ = 0.1;
+	double planarCurvatureThreshold_ = 0.05;
+	// pose of the spinning lidar in the frame of the scan, e.g. for tilted lidars or fused clouds
+	Eigen::Isometry3d rangeSensorToLidar_ = Eigen::Isometry3d::Identity();
 };
 
 struct CloudRegistrationParameters : public Parameters {
 	CloudRegistrationType regType_ = CloudRegistrationType::PointToPlaneIcp;
 	IcpParameters icp_;
+	LoamParameters loam_;
 };
 
 struct OdometryParameters {
 	CloudRegistrationParameters scanMatcher_;
 	ScanProcessingParameters scanProcessing_;
+	AdaptiveCorrespondenceDistanceParameters adaptiveCorrespondenceDistance_;
+	AdaptiveResolutionParameters adaptiveResolution_;
+	double minFitness_ = 0.1;
   bool isPublishOdometryMsgs_ = false;
 };
 
+struct OccupancyParameters{
+	bool isEnabled_ = false;
+	double hitLogOdds_ = 0.85;
+	double missLogOdds_ = -0.4;
+	double minLogOdds_ = -2.0;
+	double maxLogOdds_ = 3.5;
+	double removalLogOdds_ = -1.0;
+};
+
 struct SpaceCarvingParameters{
 	double voxelSize_=0.1;
 	double maxRaytracingLength_ = 20.0;
@@ -99,6 +146,20 @@ struct SpaceCarvingParameters{
 	int carveSpaceEveryNscans_ = 10;
 	double minDotProductWithNormal_ = 0.5;
 	double neighborhoodRadiusDenseMap_ = 0.1;
+	OccupancyParameters occupancy_;
+	bool isKeepCarvedPointsForDebugging_ = false;
+};
+
+struct CompactStorageParameters {
+	bool isEnabled_ = false;
+	double resolutionRatio_ = 0.05; // quantization step as a fraction of the map voxel size
+};
+
+struct MeshingParameters {
+	bool isEnabled_ = false;
+	double voxelSize_ = 0.0; // zero means the voxel size of the meshed map
+	double truncationDistanceRatio_ = 2.0; // in voxels
+	int knnNormalEstimation_ = 10;
 };
 
 struct MapBuilderParameters{
@@ -151,10 +212,40 @@ struct GlobalOptimizationParameters {
 	int referenceNode_ = 0;
 };
 
+struct NdtParameters {
+	double voxelSize_ = 1.0; // distributions are kept per voxel of the submap
+	int minNumPointsPerVoxel_ = 5;
+	int maxNumIter_ = 30; // finest resolution, the resolution controller lowers it like the icp one
+};
+
 struct ScanToMapRegistrationParameters : public Parameters {
 	ScanToMapRegistrationType scanToMapRegType_ = ScanToMapRegistrationType::PointToPlaneIcp;
 	double minRefinementFitness_ = 0.7;
 	IcpParameters icp_;
+	NdtParameters ndt_;
+};
+
+struct LocalizationMapParameters {
+	bool isUseTiledMap_ = false; // only used when localizing without merging scans into the map
+	double tileSize_ = 20.0;
+};
+
+struct RelocalizationParameters {
+	bool isRelocalizeOnStartup_ = false; // only used with an initial map
+	bool isRelocalizeWhenLost_ = false;
+	size_t numFailedRefinementsToBeLost_ = 5;
+	double placeSize_ = 20.0;
+	double placePaddingRatio_ = 0.5; // of the cropping radius
+	double minRefinementFitness_ = 0.7;
+	double minTimeBetweenAttempts_ = 1.0; // sec
+};
+
+struct KeyframeParameters {
+	bool isEnabled_ = false; // scans in between keyframes are not refined, their pose is chained from the odometry
+	double minDistance_ = 0.5;
+	double minRotation_ = 10.0 * params_internal::kDegToRad;
+	double maxTimeBetweenKeyframes_ = 1.0; // sec
+	double minFitness_ = 0.5; // every scan is a keyframe while the fitness of the last refinement attempt is lower
 };
 
 struct MapperParameters {
@@ -175,6 +266,14 @@ struct MapperParameters {
 	bool isRefineOdometryConstraintsBetweenSubmaps_ = false;
 	bool isUseInitialMap_ = false;
   bool isMergeScansIntoMap_ = true;
+	bool isCacheInitialMap_ = false;
+	std::string loadSessionFolderPath_ = ""; // empty means start a fresh map
+	LocalizationMapParameters localizationMap_;
+	RelocalizationParameters relocalization_;
+	KeyframeParameters keyframes_;
+	AdaptiveResolutionParameters adaptiveResolution_;
+	CompactStorageParameters compactStorage_;
+	MeshingParameters meshing_;
 };
 
 struct VisualizationParameters {
@@ -188,6 +287,8 @@ struct SavingParameters {
 	bool isSaveMap_ = false;
 	bool isSaveSubmaps_ = false;
 	bool isSaveDenseSubmaps_ = false;
+	bool isSaveSession_ = false;
+	bool isSaveMeshes_ = false;
 };
 
 struct ConstantVelocityMotionCompensationParameters {
@@ -197,6 +298,54 @@ struct ConstantVelocityMotionCompensationParameters {
 	int numPosesVelocityEstimation_ = 3;
 };
 
+struct PoseExtrapolationParameters {
+	int numPosesVelocityEstimation_ = 3;
+	double maxExtrapolationTime_ = 0.5; // sec, queries further in the future are clamped
+};
+
+struct LidarFusionParameters {
+	std::string topic_ = "";
+	Eigen::Isometry3d rangeSensorToLidar_ = Eigen::Isometry3d::Identity();
+	bool isSpinningClockwise_ = true;
+	double scanDuration_ = 0.1; // sec
+};
+
+struct RangeDataFusionParameters {
+	std::vector<LidarFusionParameters> lidars_; // the first one is the reference, its timestamps are used
+	double maxTimeDifference_ = 0.05; // sec
+	bool isUndistortLidars_ = false;
+	int numPosesVelocityEstimation_ = 3;
+};
+
+struct RangeImageParameters {
+	bool isUseRangeImage_ = false;
+	int numColumns_ = 1024; // azimuth bins for clouds that are not organized
+	// clouds that are neither organized nor have a ring field are projected by the elevation (deg) of each point
+	int numRings_ = 64;
+	double minElevation_ = -22.5;
+	double maxElevation_ = 22.5;
+	int ringStep_ = 1; // keep every n-th ring
+	int columnStep_ = 1; // keep every n-th column
+	bool isEstimateNormals_ = true;
+	int normalEstimationHalfWindow_ = 2; // neighbours within +-n rings and columns
+	double maxNeighbourDistance_ = 0.5; // m
+	double maxGroundAngle_ = 10.0; // deg
+	double edgeCurvatureThreshold_ = 0.1;
+	double planarCurvatureThreshold_ = 0.05;
+};
+
+struct ThreadingParameters {
+	int numThreads_ = 0; // shared thread pool size, 0 means number of hardware threads
+	int numOmpThreads_ = 0; // 0 keeps the OpenMP default
+	std::vector<int> cpuAffinity_; // cpus the slam threads are pinned to, empty means no pinning
+	bool isSetThreadPriorities_ = false; // mapping > odometry > dense map > features > loop closure > meshing
+};
+
+void loadParameters(const YAML::Node &node, PoseExtrapolationParameters *p);
+void loadParameters(const YAML::Node &node, RangeDataFusionParameters *p);
+void loadParameters(const YAML::Node &node, ThreadingParameters *p);
+void loadParameters(const YAML::Node &node, RangeImageParameters *p);
+void loadParameters(const YAML::Node &node, LidarFusionParameters *p);
 void loadParameters(const YAML::Node &node, ConstantVelocityMotionCompensationParameters *p);
 void loadParameters(const YAML::Node &node, SavingParameters *p);
 void loadParameters(const YAML::Node &node, PlaceRecognitionConsistencyCheckParameters *p);
@@ -206,14 +355,28 @@ void loadParameters(const YAML::Node &node, VisualizationParameters *p);
 void loadParameters(const YAML::Node &node, SubmapParameters *p);
 void loadParameters(const YAML::Node &node, ScanProcessingParameters *p);
 void loadParameters(const YAML::Node &node, IcpParameters *p);
+void loadParameters(const YAML::Node &node, LoamParameters *p);
+void loadParameters(const YAML::Node &node, AdaptiveCorrespondenceDistanceParameters *p);
+void loadParameters(const YAML::Node &node, AdaptiveResolutionParameters *p);
 void loadParameters(const YAML::Node &node, CloudRegistrationParameters *p);
 void loadParameters(const YAML::Node &node, MapperParameters *p);
 void loadParameters(const YAML::Node &node, MapBuilderParameters *p);
 void loadParameters(const YAML::Node &node, OdometryParameters *p);
 void loadParameters(const YAML::Node &node, SpaceCarvingParameters *p);
+void loadParameters(const YAML::Node &node, OccupancyParameters *p);
 void loadParameters(const YAML::Node &node, ScanCroppingParameters *p);
 void loadParameters(const YAML::Node &node, ScanToMapRegistrationParameters *p);
+void loadParameters(const YAML::Node &node, NdtParameters *p);
+void loadParameters(const YAML::Node &node, LocalizationMapParameters *p);
+void loadParameters(const YAML::Node &node, RelocalizationParameters *p);
+void loadParameters(const YAML::Node &node, KeyframeParameters *p);
+void loadParameters(const YAML::Node &node, CompactStorageParameters *p);
+void loadParameters(const YAML::Node &node, MeshingParameters *p);
 
+void loadParameters(const std::string &filename, PoseExtrapolationParameters *p);
+void loadParameters(const std::string &filename, RangeDataFusionParameters *p);
+void loadParameters(const std::string &filename, ThreadingParameters *p);
+void loadParameters(const std::string &filename, RangeImageParameters *p);
 void loadParameters(const std::string &filename, ConstantVelocityMotionCompensationParameters *p);
 void loadParameters(const std::string &filename, SavingParameters *p);
 void loadParameters(const std::string &filename, PlaceRecognitionConsistencyCheckParameters *p);
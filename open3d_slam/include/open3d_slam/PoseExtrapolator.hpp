@@ -0,0 +1,38 @@
+/*
+ * PoseExtrapolator.hpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#pragma once
+
+#include "open3d_slam/Parameters.hpp"
+#include "open3d_slam/time.hpp"
+#include "open3d_slam/Transform.hpp"
+#include "open3d_slam/TransformInterpolationBuffer.hpp"
+
+namespace o3d_slam {
+
+// Answers map->range sensor pose queries at arbitrary times. The latest scan-to-map
+// pose is chained with the odometry motion since then, and beyond the latest odometry
+// measurement the motion is extrapolated with a constant velocity model.
+// Only reads snapshots of the pose buffers, hence it is cheap and safe to call from any thread.
+class PoseExtrapolator {
+
+public:
+	PoseExtrapolator(const TransformInterpolationBuffer &odomToRangeSensorBuffer,
+			const TransformInterpolationBuffer &mapToRangeSensorBuffer);
+
+	void setParameters(const PoseExtrapolationParameters &p);
+	bool isReady() const;
+	Transform extrapolateMapToRangeSensor(const Time &queryTime) const;
+
+private:
+	Transform extrapolate(const TransformBufferSnapshot &buffer, const Time &queryTime) const;
+
+	const TransformInterpolationBuffer &odomToRangeSensorBuffer_;
+	const TransformInterpolationBuffer &mapToRangeSensorBuffer_;
+	PoseExtrapolationParameters params_;
+};
+
+} // namespace o3d_slam
@@ -0,0 +1,50 @@
+/*
+ * RangeDataFusion.hpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#pragma once
+
+#include <deque>
+#include <mutex>
+#include <vector>
+#include "open3d_slam/Parameters.hpp"
+#include "open3d_slam/typedefs.hpp"
+#include "open3d_slam/time.hpp"
+#include "open3d_slam/Transform.hpp"
+#include "open3d_slam/TransformInterpolationBuffer.hpp"
+
+namespace o3d_slam {
+
+// Fuses clouds from several lidars into one cloud in the range sensor frame. The first lidar is the reference,
+// every reference cloud is matched with the closest cloud of each other lidar. Each cloud is brought to the
+// reference timestamp (and optionally deskewed in its own lidar frame) with a constant velocity model from the
+// odometry buffer.
+class RangeDataFusion {
+
+	struct TimestampedPointCloud {
+		Time time_;
+		PointCloud cloud_;
+	};
+
+public:
+	RangeDataFusion(const TransformInterpolationBuffer &odometryBuffer);
+	~RangeDataFusion() = default;
+
+	void setParameters(const RangeDataFusionParameters &p);
+	size_t getNumLidars() const;
+	void addRangeData(size_t lidarIdx, const PointCloud &cloud, const Time &timestamp);
+	bool popFusedRangeData(PointCloud *cloud, Time *timestamp);
+
+private:
+	int findMatchingCloudIdx(size_t lidarIdx, const Time &referenceTime, bool *isWaitForMatch) const;
+	void fuse(const std::vector<const TimestampedPointCloud*> &clouds, const Time &referenceTime, PointCloud *fused) const;
+
+	const TransformInterpolationBuffer &odometryBuffer_;
+	RangeDataFusionParameters params_;
+	std::vector<std::deque<TimestampedPointCloud>> buffers_;
+	mutable std::mutex buffersMutex_;
+};
+
+} // namespace o3d_slam
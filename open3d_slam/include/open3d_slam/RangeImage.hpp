@@ -0,0 +1,72 @@
+/*
+ * RangeImage.hpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#pragma once
+
+#include <vector>
+#include <Eigen/Dense>
+#include "open3d_slam/Parameters.hpp"
+#include "open3d_slam/typedefs.hpp"
+
+namespace o3d_slam {
+
+// Organized view of a spinning lidar scan, rows are rings and columns are azimuth bins.
+// Neighbours are looked up by index, no kd-tree is needed.
+class RangeImage {
+
+public:
+	enum class Label : int {
+		Invalid = 0,
+		Unlabeled,
+		Ground,
+		Edge,
+		Planar
+	};
+
+	void setParameters(const RangeImageParameters &p);
+	// row major organized cloud, e.g. ouster, each row is one ring
+	void setFromOrganizedCloud(const PointCloud &cloud, int height, int width);
+	// unorganized cloud with the ring of every point, e.g. velodyne, the column is computed from the azimuth
+	// the closest point is kept if several fall into the same cell
+	void setFromRings(const PointCloud &cloud, const std::vector<int> &rings);
+	// cloud without ring information, the ring is computed from the elevation (deg) of each point
+	void setFromElevation(const PointCloud &cloud, int numRings, double minElevation, double maxElevation);
+
+	int getNumRings() const;
+	int getNumColumns() const;
+	bool isValid(int ring, int column) const;
+	const Eigen::Vector3d& getPoint(int ring, int column) const;
+
+	// normals point towards the sensor, cells with too few close neighbours don't get one
+	void estimateNormals();
+	bool computeNormal(int ring, int column, Eigen::Vector3d *normal) const;
+	// ground from the slope between neighbouring rings, edge and planar from the curvature along the ring
+	void computeLabels();
+	Label getLabel(int ring, int column) const;
+	double getCurvature(int ring, int column) const;
+
+	// valid cells on every ring_step-th ring and column_step-th column, with normals if they were estimated
+	PointCloud toPointCloud() const;
+
+private:
+	void reset(int numRings, int numColumns, bool hasColors);
+	void setCell(int ring, int column, const PointCloud &cloud, size_t idx);
+	int toIdx(int ring, int column) const;
+	int wrapColumn(int column) const;
+	void computeCurvature(int ring, int column);
+	void labelGround();
+
+	RangeImageParameters params_;
+	int numRings_ = 0;
+	int numColumns_ = 0;
+	bool isNormalsEstimated_ = false;
+	std::vector<Eigen::Vector3d> points_, normals_, colors_;
+	std::vector<uint8_t> isValid_, isNormalValid_;
+	std::vector<double> curvature_;
+	std::vector<Label> labels_;
+};
+
+} // namespace o3d_slam
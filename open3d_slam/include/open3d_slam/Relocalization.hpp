@@ -0,0 +1,52 @@
+/*
+ * Relocalization.hpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <open3d/geometry/PointCloud.h>
+#include <open3d/pipelines/registration/Feature.h>
+#include "open3d_slam/Parameters.hpp"
+#include "open3d_slam/Transform.hpp"
+
+namespace o3d_slam {
+
+class CloudRegistration;
+
+// Recovers the map->range sensor pose without an initial guess. The prior map is split into
+// places once, each place gets FPFH features. A scan is matched against all places in parallel
+// (RANSAC on features followed by ICP refinement) and the best refined match is returned.
+class Relocalizer {
+
+public:
+	using Feature = open3d::pipelines::registration::Feature;
+	struct Place {
+		Eigen::Vector3d center_;
+		PointCloud cloud_;
+		std::shared_ptr<Feature> feature_;
+	};
+
+	Relocalizer();
+	~Relocalizer() = default;
+
+	void setParameters(const MapperParameters &p);
+	void buildPlaces(const PointCloud &map);
+	size_t getNumPlaces() const;
+	const std::vector<Place>& getPlaces() const;
+	// places built earlier for the same map and parameters, e.g. loaded from the initial map cache
+	void setPlaces(std::vector<Place> places);
+	bool relocalize(const PointCloud &scan, Transform *mapToRangeSensor) const;
+
+private:
+	std::shared_ptr<Feature> computeFeatures(PointCloud *sparseCloud) const;
+
+	MapperParameters params_;
+	std::vector<Place> places_;
+	std::shared_ptr<CloudRegistration> cloudRegistration_;
+};
+
+} // namespace o3d_slam
@@ -0,0 +1,37 @@
+/*
+ * ResolutionController.hpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#pragma once
+
+#include "open3d_slam/Parameters.hpp"
+
+namespace o3d_slam {
+
+struct ScanResolution {
+	double voxelSize_ = 0.0;
+	double downSamplingRatio_ = 1.0;
+	int maxNumIter_ = 1;
+};
+
+// Moves the scan resolution between the configured (finest) values and the coarsest bounds
+// such that the average latency of a pipeline stage stays below the target.
+class ResolutionController {
+public:
+	void setParameters(const AdaptiveResolutionParameters &p, const ScanResolution &finest);
+	// returns true if the resolution changed
+	bool update(double latencyMsec, size_t queueSize);
+	const ScanResolution &getResolution() const;
+	double getLevel() const;
+
+private:
+	AdaptiveResolutionParameters params_;
+	ScanResolution finest_, current_;
+	double level_ = 0.0; // 0 is the finest, 1 the coarsest resolution
+	double avgLatencyMsec_ = 0.0;
+	bool isFirstMeasurement_ = true;
+};
+
+} // namespace o3d_slam
@@ -9,6 +9,7 @@
 #include "open3d_slam/typedefs.hpp"
 #include "open3d_slam/Transform.hpp"
 #include "open3d_slam/Parameters.hpp"
+#include "open3d_slam/ResolutionController.hpp"
 
 #include "open3d/pipelines/registration/Registration.h"
 
@@ -37,6 +38,7 @@ public:
 			const Transform &mapToRangeSensor, const Transform &initialGuess) const = 0;
 	virtual bool isMergeScanValid(const PointCloud &in) const =0;
 	virtual void prepareInitialMap(PointCloud *map) const =0;
+	virtual void setScanResolution(const ScanResolution &resolution) =0;
 };
 
 class ScanToMapIcp : public ScanToMapRegistration {
@@ -49,6 +51,7 @@ public:
 	RegistrationResult scanToMapRegistration(const PointCloud &scan, const Submap &activeSubmap, const Transform &mapToRangeSensor,const Transform &initialGuess) const final;
 	bool isMergeScanValid(const PointCloud &in) const final;
 	void prepareInitialMap(PointCloud *map) const final;
+	void setScanResolution(const ScanResolution &resolution) final;
 private:
 	PointCloudPtr preprocess(const PointCloud &in) const;
 	void update(const MapperParameters &p);
@@ -58,7 +61,29 @@ private:
 	std::shared_ptr<CroppingVolume> mapBuilderCropper_;
 };
 
+// Point to distribution NDT against the per voxel distributions kept by the active submap,
+// neither the map nor the scan need normals or a kd-tree.
+class ScanToMapNdt : public ScanToMapRegistration {
+
+public:
+	ScanToMapNdt();
+	virtual ~ScanToMapNdt() = default;
+	void setParameters(const MapperParameters &p);
+	ProcessedScans processForScanMatchingAndMerging(const PointCloud &in, const Transform &mapToRangeSensor) const final;
+	RegistrationResult scanToMapRegistration(const PointCloud &scan, const Submap &activeSubmap, const Transform &mapToRangeSensor,const Transform &initialGuess) const final;
+	bool isMergeScanValid(const PointCloud &in) const final;
+	void prepareInitialMap(PointCloud *map) const final;
+	void setScanResolution(const ScanResolution &resolution) final;
+private:
+	void update(const MapperParameters &p);
+
+	MapperParameters params_;
+	std::shared_ptr<CroppingVolume> scanMatcherCropper_;
+	std::shared_ptr<CroppingVolume> mapBuilderCropper_;
+};
+
 std::unique_ptr<ScanToMapIcp> createScanToMapIcp(const MapperParameters &p);
+std::unique_ptr<ScanToMapNdt> createScanToMapNdt(const MapperParameters &p);
 std::unique_ptr<ScanToMapRegistration> scanToMapRegistrationFactory(const MapperParameters &p);
 CloudRegistrationParameters toCloudRegistrationType(const ScanToMapRegistrationParameters &p);
 
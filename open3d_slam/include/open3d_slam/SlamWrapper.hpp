@@ -7,6 +7,9 @@
 
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <thread>
 #include <future>
 #include <Eigen/Dense>
@@ -18,6 +21,8 @@
 #include "open3d_slam/CircularBuffer.hpp"
 #include "open3d_slam/ThreadSafeBuffer.hpp"
 #include "open3d_slam/Constraint.hpp"
+#include "open3d_slam/ThreadPool.hpp"
+#include "open3d_slam/ResolutionController.hpp"
 
 
 namespace o3d_slam {
@@ -27,6 +32,7 @@ class Mapper;
 class SubmapCollection;
 class OptimizationProblem;
 class MotionCompensation;
+class PoseExtrapolator;
 
 class SlamWrapper {
 	struct TimestampedPointCloud {
@@ -54,13 +60,23 @@ public:
 	virtual void finishProcessing();
 
 	const MapperParameters &getMapperParameters() const;
+	const ConstantVelocityMotionCompensationParameters &getMotionCompensationParameters() const;
+	const TransformInterpolationBuffer &getOdometryToRangeSensorBuffer() const;
 	MapperParameters *getMapperParametersPtr();
+	const ThreadingParameters &getThreadingParameters() const;
 	size_t getOdometryBufferSize() const;
 	size_t getMappingBufferSize() const;
 	size_t getOdometryBufferSizeLimit() const;
 	size_t getMappingBufferSizeLimit() const;
+	void setInputBufferSizeLimit(size_t sizeLimit);
+	bool isInputBufferSpaceAvailable() const;
+	// blocks until a scan can be added without dropping one or until timeout, returns whether there is space
+	bool waitForInputBufferSpace(const std::chrono::milliseconds &timeout);
 	std::string getParameterFilePath() const;
 	std::pair<PointCloud,Time> getLatestRegisteredCloudTimestampPair() const;
+	bool isPoseExtrapolationAvailable() const;
+	// map->range sensor at queryTime, predicted from the latest refined pose and the odometry
+	Transform getExtrapolatedMapToRangeSensor(const Time &queryTime) const;
 
 	void setDirectoryPath(const std::string &path);
 	void setMapSavingDirectoryPath(const std::string &path);
@@ -71,6 +87,10 @@ public:
 	bool saveMap(const std::string &directory);
 	bool saveDenseSubmaps(const std::string &directory);
 	bool saveSubmaps(const std::string &directory, const bool& isDenseMap=false);
+	bool saveSession(const std::string &directory);
+	// meshes the submaps that changed since they were last meshed first
+	bool saveMeshes(const std::string &directory);
+	bool loadSession(const std::string &folderPath);
 private:
 	void checkIfOptimizedGraphAvailable();
 	void odometryWorker();
@@ -80,6 +100,8 @@ private:
 	void attemptLoopClosuresIfReady();
 	void updateSubmapsAndTrajectory();
 	void denseMapWorker();
+	void meshWorker();
+	void pushToMeshingQueue(size_t submapId);
 
 
 protected:
@@ -87,26 +109,35 @@ protected:
 	CircularBuffer<RegisteredPointCloud> registeredCloudBuffer_;
 	CircularBuffer<TimestampedPointCloud> odometryBuffer_, mappingBuffer_;
 	ThreadSafeBuffer<TimestampedSubmapId> loopClosureCandidates_;
+	ThreadSafeBuffer<size_t> meshingQueue_;
 	MapperParameters mapperParams_;
 	OdometryParameters odometryParams_;
 	VisualizationParameters visualizationParameters_;
 	PointCloud rawCloudPrev_;
 	Constraints lastLoopClosureConstraints_;
 	std::shared_ptr<MotionCompensation> motionCompensationOdom_,motionCompensationMap_;
+	std::shared_ptr<PoseExtrapolator> poseExtrapolator_;
 	std::shared_ptr<LidarOdometry> odometry_;
 	std::shared_ptr<Mapper> mapper_;
 	std::shared_ptr<SubmapCollection> submaps_;
 	std::shared_ptr<OptimizationProblem> optimizationProblem_;
+	std::shared_ptr<ThreadPool> threadPool_;
+	ThreadingParameters threadingParameters_;
+	ResolutionController odometryResolutionController_, mappingResolutionController_;
 	std::string folderPath_, mapSavingFolderPath_, paramPath_;
-	std::thread odometryWorker_, mappingWorker_, loopClosureWorker_, denseMapWorker_;
+	std::thread odometryWorker_, mappingWorker_, loopClosureWorker_, denseMapWorker_, meshWorker_;
 	std::future<void> computeFeaturesResult_;
 	Timer mappingStatisticsTimer_,odometryStatisticsTimer_, visualizationUpdateTimer_, denseMapVisualizationUpdateTimer_, denseMapStatiscticsTimer_;
 	bool isOptimizedGraphAvailable_ = false;
 	bool isRunWorkers_ = true;
 	Timer mapperOnlyTimer_;
 	SavingParameters savingParameters_;
-	Time latestScanToMapRefinementTimestamp_;
-	Time latestScanToScanRegistrationTimestamp_;
+	std::mutex inputBufferSpaceMutex_;
+	std::condition_variable inputBufferSpaceCv_;
+	std::mutex meshingQueueMutex_;
+	std::condition_variable meshingQueueCv_;
+	std::atomic<Time> latestScanToMapRefinementTimestamp_{Time()};
+	std::atomic<Time> latestScanToScanRegistrationTimestamp_{Time()};
 	ConstantVelocityMotionCompensationParameters motionCompensationParameters_;
 	int numLatesLoopClosureConstraints_ = -1;
 };
@@ -16,9 +16,14 @@
 #include "open3d_slam/Transform.hpp"
 #include <open3d/pipelines/registration/Feature.h>
 #include "open3d_slam/Voxel.hpp"
+#include "open3d_slam/OccupancyMap.hpp"
+#include "open3d_slam/CompactPointCloud.hpp"
+#include "open3d_slam/SurfaceMesh.hpp"
 
 namespace o3d_slam {
 
+class ThreadPool;
+
 struct TimestampedSubmapId {
 	size_t submapId_;
 	Time time_;
@@ -45,19 +50,35 @@ public:
 	const Transform& getMapToSubmapOrigin() const;
 	Eigen::Vector3d getMapToSubmapCenter() const;
 	void setMapToSubmapOrigin(const Transform &T);
-	const PointCloud& getMapPointCloud() const;
+	void setMapPointCloud(const PointCloud &cloud);
+	// without the removed points
 	PointCloud getMapPointCloudCopy() const;
+	// points of the map within the cropper, without removed points
+	PointCloudPtr cropMapPointCloud(const CroppingVolume &cropper) const;
 	const VoxelizedPointCloud& getDenseMap() const;
 	VoxelizedPointCloud getDenseMapCopy() const;
 	bool isEmpty() const;
+	size_t getNumMapPoints() const;
+	// stores the map and the dense map compactly until they are accessed again, see mapping.compact_storage
+	// the dense map lags behind, it is compacted again once the scan at finishTime was inserted into it
+	void compactMaps(const Time &finishTime);
 	const Feature& getFeatures() const;
 	const PointCloud& getSparseMapPointCloud() const;
 	void computeSubmapCenter();
-	void computeFeatures();
+	// runs the voxel map computation on the thread pool if one is given
+	void computeFeatures(ThreadPool *threadPool = nullptr);
 	size_t getId() const;
 	size_t getParentId() const;
 	void transform(const Transform &T);
 	const VoxelMap& getVoxelMap() const;
+	// only maintained for the Ndt scan to map registration, rebuilt here if the map points were moved or removed
+	NdtVoxelMap getNdtMapCopy() const;
+	// meshes the dense map if it is built and the map otherwise, only if they changed since the last call
+	void computeMesh();
+	bool isMeshDirty() const;
+	// empty until computeMesh was called, the mesh is never modified in place
+	std::shared_ptr<const TriangleMesh> getMesh() const;
+	// last carving result, only kept if space_carving.is_keep_carved_points_for_debugging is set
 	mutable PointCloud toRemove_;
 	mutable PointCloud scanRef_;
 
@@ -67,12 +88,24 @@ private:
 	void carve(const PointCloud &scan, const Eigen::Vector3d &sensorPosition,
 			const SpaceCarvingParameters &param, VoxelizedPointCloud *cloud);
 	void update(const MapperParameters &mapperParams);
-	void carve(const PointCloud &rawScan, const Transform &mapToRangeSensor, const CroppingVolume &cropper,
-			const SpaceCarvingParameters &params, PointCloud *map);
-	void voxelizeInsideCroppingVolume(const CroppingVolume &cropper, const MapBuilderParameters &param,
-			PointCloud *map) const;
+	bool isUseNdtMap() const;
+	std::vector<size_t> carve(const PointCloud &rawScan, const Transform &mapToRangeSensor,
+			const CroppingVolume &cropper, const SpaceCarvingParameters &params, const PointCloud &map);
+	// replaces carving if occupancy is enabled, runs on every scan
+	std::vector<size_t> updateOccupancy(const PointCloud &scan, const Transform &mapToRangeSensor);
+	// removed points are only tombstoned, they are erased from the map cloud once enough of them accumulate
+	void removeMapPoints(const std::vector<size_t> &idxs);
+	// not to be confused with compactMaps, this erases the tombstoned points and renumbers the rest
+	void eraseRemovedMapPoints();
+	void clearRemovedMapPoints();
+	// decode the compact storage back, call with the respective mutex locked
+	void expandMapPointCloud() const;
+	void expandDenseMap() const;
+	void compactDenseMap();
+	void setMeshDirty();
 
-	PointCloud sparseMapCloud_, mapCloud_;
+	PointCloud sparseMapCloud_;
+	mutable PointCloud mapCloud_;
 	Transform mapToSubmap_ = Transform::Identity();
 	Transform mapToRangeSensor_ = Transform::Identity();
 	Eigen::Vector3d submapCenter_ = Eigen::Vector3d::Zero();
@@ -88,10 +121,27 @@ private:
 	Timer carvingStatisticsTimer_;
 	int scanCounter_ = 0;
 	VoxelMap voxelMap_;
-	VoxelizedPointCloud denseMap_;
+	PointCloudVoxelIndex mapVoxelIndex_;
+	bool isMapVoxelIndexValid_ = false;
+	mutable NdtVoxelMap ndtMap_;
+	mutable bool isNdtMapValid_ = false;
+	OccupancyVoxelMap occupancyMap_;
+	bool isOccupancyMapPointsValid_ = false; // the voxels know the idxs of the map points inside them
+	std::vector<bool> isMapPointRemoved_;
+	size_t nRemovedMapPoints_ = 0;
+	mutable VoxelizedPointCloud denseMap_;
+	mutable CompactPointCloud compactMapCloud_, compactDenseMap_;
+	mutable bool isMapCloudCompact_ = false;
+	mutable bool isDenseMapCompact_ = false;
+	bool isFinished_ = false; // guarded by denseMapMutex_, set while the submap is not the active one
+	Time finishTime_;
 	ColorRangeCropper colorCropper_;
 	mutable std::mutex denseMapMutex_;
 	mutable std::mutex mapPointCloudMutex_;
+	std::shared_ptr<const TriangleMesh> mesh_;
+	bool isMeshDirty_ = false;
+	size_t nMeshTransforms_ = 0; // a mesh computed while the submap was transformed is discarded
+	mutable std::mutex meshMutex_;
 };
 
 } // namespace o3d_slam
@@ -20,6 +20,7 @@
 #include "open3d_slam/OptimizationProblem.hpp"
 #include "open3d_slam/ThreadSafeBuffer.hpp"
 #include "open3d_slam/CircularBuffer.hpp"
+#include "open3d_slam/ThreadPool.hpp"
 
 
 namespace o3d_slam {
@@ -62,12 +63,20 @@ public:
 
 
 	bool dumpToFile(const std::string &folderPath, const std::string &filename, const bool& isDenseMap) const;
+	// folderPath has to end with a '/'
+	bool saveSession(const std::string &folderPath) const;
+	// replaces the current submaps with a saved session, the next inserted scan starts a new trajectory
+	bool loadSession(const std::string &folderPath, const Constraints &odometryConstraints,
+			const Constraints &loopClosureConstraints);
+	bool isStartingNewTrajectory() const;
+	bool isSameTrajectory(size_t submapIdx1, size_t submapIdx2) const;
 	void transform(const OptimizedTransforms &transformIncrements);
 	void updateAdjacencyMatrix(const Constraints &loopClosureConstraints);
 	const Constraints &getOdometryConstraints() const;
 
 	const MapperParameters &getParameters() const;
 	void setFolderPath(const std::string &folderPath);
+	void setThreadPool(std::shared_ptr<ThreadPool> threadPool);
 
 	void forceNewSubmapCreation();
 
@@ -77,6 +86,8 @@ private:
 	void addScanToBuffer(const PointCloud &scan, const Transform &mapToRangeSensor, const Time &timestamp);
 	void updateActiveSubmap(const Transform &mapToRangeSensor, const PointCloud &scan);
 	void createNewSubmap(const Transform &mapToSubmap);
+	void startNewTrajectory(const Transform &mapToRangeSensor);
+	size_t getTrajectoryIdx(size_t submapIdx) const;
 	size_t findClosestSubmap(const Transform &mapToRangesensor) const;
 	std::vector<size_t> getAllSubmapIdxs() const;
 
@@ -98,6 +109,9 @@ private:
 	CircularBuffer<ScanTimeTransform> overlapScansBuffer_;
 	std::string savingDataFolderPath_;
 	bool isForceNewSubmapCreation_ = false;
+	bool isStartingNewTrajectory_ = false;
+	std::vector<size_t> trajectoryStartIdxs_ { 0 }; // sorted, idx of the first submap of each trajectory
+	std::shared_ptr<ThreadPool> threadPool_;
 };
 
 } // namespace o3d_slam
@@ -0,0 +1,24 @@
+/*
+ * SurfaceMesh.hpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#pragma once
+
+#include <memory>
+#include <open3d/geometry/TriangleMesh.h>
+#include "open3d_slam/typedefs.hpp"
+
+namespace o3d_slam {
+
+using TriangleMesh = open3d::geometry::TriangleMesh;
+
+// Surface of a cloud with normals. The points are integrated into a sparse truncated signed distance field
+// sampled at the corners of voxels, where each point updates the corners within truncationDistance with
+// its distance along the normal. The surface is extracted with surface nets: one vertex per voxel the
+// surface passes through and two triangles per voxel edge it crosses.
+std::shared_ptr<TriangleMesh> computeSurfaceMesh(const PointCloud &cloud, double voxelSize,
+		double truncationDistance);
+
+} // namespace o3d_slam
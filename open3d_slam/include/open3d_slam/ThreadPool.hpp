@@ -0,0 +1,86 @@
+/*
+ * ThreadPool.hpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "open3d_slam/Parameters.hpp"
+
+namespace o3d_slam {
+
+// os priority order of the slam threads, lower value gets the lower nice value
+enum class ThreadPriority : int {
+	Mapping = 0,
+	Odometry,
+	DenseMap,
+	Features,
+	LoopClosure,
+	Meshing
+};
+
+// Applies the cpu affinity, the OpenMP thread count and the os priority (nice value) to the calling thread.
+void configureCurrentThread(const ThreadingParameters &p, ThreadPriority priority);
+
+// Fixed number of threads consuming tasks in FIFO order.
+class ThreadPool {
+
+public:
+	explicit ThreadPool(size_t numThreads, const std::function<void()> &onThreadStart = nullptr);
+	~ThreadPool();
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	template<typename F>
+	std::future<typename std::result_of<F()>::type> enqueue(F &&f) {
+		using ReturnType = typename std::result_of<F()>::type;
+		auto task = std::make_shared<std::packaged_task<ReturnType()>>(std::forward<F>(f));
+		std::future<ReturnType> result = task->get_future();
+		{
+			std::lock_guard<std::mutex> lck(tasksMutex_);
+			tasks_.emplace_back([task]() {
+				(*task)();
+			});
+		}
+		tasksCv_.notify_one();
+		return result;
+	}
+
+	// Runs pending tasks on the calling thread until the future is ready.
+	// Use it instead of future.get() inside a task, otherwise nested tasks can deadlock the pool.
+	template<typename T>
+	T waitFor(std::future<T> &future) {
+		while (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+			if (!runPendingTask()) {
+				future.wait_for(std::chrono::milliseconds(1));
+			}
+		}
+		return future.get();
+	}
+
+	bool runPendingTask();
+	size_t getNumThreads() const;
+
+private:
+	void workerLoop();
+	bool popTask(std::function<void()> *task);
+
+	std::vector<std::thread> workers_;
+	std::deque<std::function<void()>> tasks_;
+	std::mutex tasksMutex_;
+	std::condition_variable tasksCv_;
+	bool isStopped_ = false;
+};
+
+} // namespace o3d_slam
@@ -6,19 +6,57 @@
  */
 
 #pragma once
-#include <deque>
+#include <atomic>
 #include <limits>
+#include <memory>
 #include <mutex>
+#include <vector>
 
 #include "open3d_slam/time.hpp"
 #include "open3d_slam/Transform.hpp"
 
 namespace o3d_slam {
 
+// Immutable, versioned view of the contents of a TransformInterpolationBuffer.
+// Transforms are kept time-ordered in contiguous memory and looked up with a binary search.
+// The view is a window into a block shared with the buffer, the buffer only ever writes past its end.
+class TransformBufferSnapshot {
+	friend class TransformInterpolationBuffer;
+public:
+	using Storage = std::vector<TimestampedTransform>;
+
+	bool empty() const;
+	size_t size() const;
+	uint64_t version() const;
+	bool has(const Time &time) const;
+	Transform lookup(const Time &time) const;
+	Transform lookupClamped(const Time &time) const;
+	Time earliest_time() const;
+	Time latest_time() const;
+	const TimestampedTransform& latest_measurement(int offsetFromLastElement = 0) const;
+
+private:
+	const TimestampedTransform& at(size_t idx) const;
+	size_t lowerBound(const Time &time) const;
+	Transform lookupImpl(const Time &time) const;
+
+	std::shared_ptr<const Storage> storage_;
+	size_t begin_ = 0;
+	size_t end_ = 0;
+	uint64_t version_ = 0;
+};
+
 // A time-ordered buffer of transforms that supports interpolated lookups.
 // Unless explicitly set, the buffer size is unlimited.
+// Readers work on an immutable snapshot (RCU style), hence they never block
+// the writer and never observe a half-applied modification. Writers are
+// serialized among themselves and publish a new snapshot on every change.
+// Pushes append to a block twice the size of the window, which is moved to a
+// fresh block once full, so a push is amortized O(1).
 class TransformInterpolationBuffer {
 public:
+	using SnapshotPtr = std::shared_ptr<const TransformBufferSnapshot>;
+
 	TransformInterpolationBuffer(size_t bufferSize);
 	TransformInterpolationBuffer();
 	virtual ~TransformInterpolationBuffer() = default;
@@ -34,6 +72,13 @@ public:
 	// Clears the transform buffer.
 	void clear();
 
+	// Consistent view of the buffer, use it when doing several queries that
+	// have to agree with each other.
+	SnapshotPtr snapshot() const;
+
+	// Incremented every time the buffer is modified.
+	uint64_t version() const;
+
 	// Returns true if an interpolated transform can be computed at 'time'.
 	bool has(const Time &time) const;
 
@@ -41,6 +86,9 @@ public:
 	// 'time' is available.
 	Transform lookup(const Time &time) const;
 
+	// Same as lookup, but clamps 'time' to the time range currently in the buffer.
+	Transform lookupClamped(const Time &time) const;
+
 	// Returns the timestamp of the earliest transform in the buffer or 0 if the
 	// buffer is empty. Earliest time is the one that is the closest to Jan 1,1,00
 	Time earliest_time() const;
@@ -58,20 +106,23 @@ public:
 	// Returns the current size of the transform buffer.
 	size_t size() const;
 
-	const TimestampedTransform& latest_measurement(int offsetFromLastElement = 0) const;
-	TimestampedTransform& latest_measurement(int offsetFromLastElement = 0);
+	// Returned by value since the snapshot it comes from can be replaced by a writer.
+	TimestampedTransform latest_measurement(int offsetFromLastElement = 0) const;
 
 	void printTimesCurrentlyInBuffer() const;
 
 	void applyToAllElementsInTimeInterval(const Transform &t, const Time &begin, const Time &end );
 
 private:
-	void removeOldMeasurementsIfNeeded();
+	using Storage = TransformBufferSnapshot::Storage;
+	void publish(std::shared_ptr<TransformBufferSnapshot> snapshot);
+	void moveToNewStorage(const TransformBufferSnapshot &current, size_t numKept, size_t capacity);
 	static constexpr size_t kUnlimitedBufferSize = std::numeric_limits<size_t>::max();
 
-	std::deque<TimestampedTransform> transforms_;
-	size_t bufferSizeLimit_ = kUnlimitedBufferSize;
-	mutable std::mutex modifierMutex_;
+	SnapshotPtr snapshot_;
+	std::shared_ptr<Storage> storage_; // written only by the writer, past the end of the published window
+	std::atomic<size_t> bufferSizeLimit_{kUnlimitedBufferSize};
+	mutable std::mutex writerMutex_;
 };
 
 Transform getTransform(const Time &time,
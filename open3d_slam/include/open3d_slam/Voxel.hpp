@@ -52,9 +52,9 @@ public:
 
 private:
 	// aggregate point has to be called before aggregate normal and aggregate color!!!!
-	void aggregatePoint(const Eigen::Vector3d &p);
-	void aggregateNormal(const Eigen::Vector3d &n);
-	void aggregateColor(const Eigen::Vector3d &c);
+	void aggregatePoint(const Eigen::Vector3d &p, int weight = 1);
+	void aggregateNormal(const Eigen::Vector3d &n, int weight = 1);
+	void aggregateColor(const Eigen::Vector3d &c, int weight = 1);
 };
 
 class VoxelizedPointCloud : public VoxelHashMap<AggregatedVoxel> {
@@ -64,7 +64,11 @@ public:
 	VoxelizedPointCloud();
 	VoxelizedPointCloud(const Eigen::Vector3d &voxelSize);
 	void insert(const PointCloud &cloud);
+	// each point counts as weights[i] aggregated points, used to restore the output of toPointCloud
+	void insert(const PointCloud &cloud, const std::vector<int> &weights);
 	PointCloud toPointCloud() const;
+	// also returns the number of points aggregated in the voxel of each output point
+	PointCloud toPointCloud(std::vector<int> *numAggregatedPoints) const;
 	bool hasColors() const;
 	bool hasNormals() const;
 	void transform(const Transform &T);
@@ -74,6 +78,65 @@ public:
 	//std::mutex mutex_;
 };
 
+struct VoxelWithPointIdx {
+	size_t idx_ = 0;
+	int numAggregatedPoints_ = 0;
+};
+
+// Voxel index of a point cloud stored elsewhere, holding one averaged point per voxel.
+// Inserting a cloud only touches the voxels hit by that cloud.
+class PointCloudVoxelIndex : public VoxelHashMap<VoxelWithPointIdx> {
+	using BASE = VoxelHashMap<VoxelWithPointIdx>;
+public:
+	EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+	PointCloudVoxelIndex();
+	PointCloudVoxelIndex(const Eigen::Vector3d &voxelSize);
+	// points falling into an occupied voxel update the running average of its point in map, others are appended to map,
+	// the indices of the points of map that were moved are stored in movedIdxs together with their positions before the insertion
+	void insert(const PointCloud &cloud, PointCloud *map, std::vector<size_t> *movedIdxs = nullptr,
+			std::vector<Eigen::Vector3d> *previousPositions = nullptr);
+	// call after the points of map were moved or removed, points that share a voxel are kept
+	void rebuild(const PointCloud &map, const std::vector<bool> &isPointRemoved = {});
+	// the voxels of the removed points are free again, later hits append new points
+	void remove(const PointCloud &map, const std::vector<size_t> &idxs);
+};
+
+struct NdtVoxel {
+	EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+	int numPoints_ = 0;
+	Eigen::Vector3d sum_ = Eigen::Vector3d::Zero();
+	Eigen::Matrix3d sumOfOuterProducts_ = Eigen::Matrix3d::Zero();
+	Eigen::Vector3d mean_ = Eigen::Vector3d::Zero();
+	Eigen::Matrix3d information_ = Eigen::Matrix3d::Zero(); // regularized inverse covariance
+	bool isValid_ = false; // has enough points for the distribution
+	bool isDirty_ = false;
+};
+
+// Normal distribution of the points in each voxel. Accumulated sums are kept per voxel,
+// hence inserting points only recomputes the distributions of the voxels they fall into.
+class NdtVoxelMap : public VoxelHashMap<NdtVoxel> {
+	using BASE = VoxelHashMap<NdtVoxel>;
+public:
+	EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+	NdtVoxelMap();
+	NdtVoxelMap(const Eigen::Vector3d &voxelSize, int minNumPointsPerVoxel);
+	// accumulates the points of cloud starting at startIdx
+	void insert(const PointCloud &cloud, size_t startIdx = 0);
+	void rebuild(const PointCloud &cloud, const std::vector<bool> &isPointRemoved = {});
+	// subtracts the points of cloud at idxs from the sums of their voxels
+	void remove(const PointCloud &cloud, const std::vector<size_t> &idxs);
+	// replaces the contributions of the points of cloud at idxs, that were accumulated at previousPositions
+	void move(const PointCloud &cloud, const std::vector<size_t> &idxs,
+			const std::vector<Eigen::Vector3d> &previousPositions);
+	// valid distribution among the voxel containing p and its face neighbors with the mean closest to p, nullptr if none
+	const NdtVoxel *getClosestDistribution(const Eigen::Vector3d &p) const;
+
+private:
+	void updateDistribution(NdtVoxel *voxel) const;
+	void updateDistributions(const std::vector<Eigen::Vector3i> &keys);
+	int minNumPointsPerVoxel_ = 5;
+};
+
 std::shared_ptr<PointCloud> removeDuplicatePointsWithinSameVoxels(const open3d::geometry::PointCloud &cloud, const Eigen::Vector3d &voxelSize);
 
 } // namespace o3d_slam
@@ -47,7 +47,8 @@ public:
 	void setPose(const Eigen::Isometry3d &pose);
 	bool isWithinVolume(const Eigen::Vector3d &p) const;
 
-	Indices getIndicesWithinVolume(const PointCloud &cloud) const;
+	// one virtual call per cloud, see CroppingVolumeT
+	virtual Indices getIndicesWithinVolume(const PointCloud &cloud) const;
 	std::shared_ptr<PointCloud> crop(const PointCloud &cloud) const;
 	void crop(PointCloud *cloud) const;
 
@@ -58,31 +59,68 @@ protected:
 	bool isInvertVolume_ = false;
 };
 
-class MinMaxRadiusCroppingVolume : public CroppingVolume{
+// Volume test of Derived (isInside) is inlined into the loop over the points
+// and the invert branch is taken once per cloud.
+template<typename Derived>
+class CroppingVolumeT : public CroppingVolume {
+public:
+	Indices getIndicesWithinVolume(const PointCloud &cloud) const final {
+		return isInvertVolume_ ? getIndices<true>(cloud) : getIndices<false>(cloud);
+	}
+
+protected:
+	bool isWithinVolumeImpl(const Eigen::Vector3d &p) const final {
+		return static_cast<const Derived&>(*this).isInside(p);
+	}
+
+private:
+	template<bool isInvert>
+	Indices getIndices(const PointCloud &cloud) const {
+		const Derived &volume = static_cast<const Derived&>(*this);
+		Indices idxs;
+		idxs.reserve(cloud.points_.size());
+		for (size_t i = 0; i < cloud.points_.size(); ++i) {
+			if (volume.isInside(cloud.points_[i]) != isInvert) {
+				idxs.push_back(i);
+			}
+		}
+		return idxs;
+	}
+};
+
+class MinMaxRadiusCroppingVolume : public CroppingVolumeT<MinMaxRadiusCroppingVolume>{
+	friend class CroppingVolumeT<MinMaxRadiusCroppingVolume>;
 public:
 	MinMaxRadiusCroppingVolume() = default;
 	~MinMaxRadiusCroppingVolume() override= default;
 	MinMaxRadiusCroppingVolume(double radiusMin, double radiusMax);
 	void setParameters(double radiusMin, double radiusMax);
 private:
-  bool isWithinVolumeImpl(const Eigen::Vector3d &p) const final;
+	bool isInside(const Eigen::Vector3d &p) const {
+		const double d2 = (p - pose_.translation()).squaredNorm();
+		return d2 <= radiusMax_ * radiusMax_ && d2 >= radiusMin_ * radiusMin_;
+	}
 	double radiusMin_=0.0;
 	double radiusMax_=1e4;
 };
 
-class MaxRadiusCroppingVolume : public CroppingVolume{
+class MaxRadiusCroppingVolume : public CroppingVolumeT<MaxRadiusCroppingVolume>{
+	friend class CroppingVolumeT<MaxRadiusCroppingVolume>;
 public:
 	MaxRadiusCroppingVolume() = default;
 	~MaxRadiusCroppingVolume() override= default;
 	MaxRadiusCroppingVolume(double radius);
 	void setParameters(double radius);
 private:
-  bool isWithinVolumeImpl(const Eigen::Vector3d &p) const final;
+	bool isInside(const Eigen::Vector3d &p) const {
+		return (p - pose_.translation()).squaredNorm() <= radius_ * radius_;
+	}
 	double radius_=1e6;
 
 };
 
-class MinRadiusCroppingVolume : public CroppingVolume{
+class MinRadiusCroppingVolume : public CroppingVolumeT<MinRadiusCroppingVolume>{
+	friend class CroppingVolumeT<MinRadiusCroppingVolume>;
 public:
 	MinRadiusCroppingVolume() = default;
 	MinRadiusCroppingVolume(double radius);
@@ -91,12 +129,15 @@ public:
 	void setParameters(double radius);
 
 private:
-  bool isWithinVolumeImpl(const Eigen::Vector3d &p) const final;
+	bool isInside(const Eigen::Vector3d &p) const {
+		return (p - pose_.translation()).squaredNorm() >= radius_ * radius_;
+	}
 	double radius_=0.0;
 
 };
 
-class CylinderCroppingVolume : public CroppingVolume{
+class CylinderCroppingVolume : public CroppingVolumeT<CylinderCroppingVolume>{
+	friend class CroppingVolumeT<CylinderCroppingVolume>;
 public:
 	CylinderCroppingVolume();
 	CylinderCroppingVolume(double radius, double minZ, double maxZ);
@@ -105,7 +146,9 @@ public:
 
 
 private:
-  bool isWithinVolumeImpl(const Eigen::Vector3d &p) const final;
+	bool isInside(const Eigen::Vector3d &p) const {
+		return p.z() >= minZ_ && p.z() <= maxZ_ && (p - pose_.translation()).head<2>().squaredNorm() <= radius_ * radius_;
+	}
 
 
 	double radius_=1e6;
@@ -19,6 +19,8 @@ class VoxelizedPointCloud;
 
 std::shared_ptr<open3d::geometry::PointCloud> transform(const Eigen::Matrix4d &T,
 		const open3d::geometry::PointCloud &cloud);
+// rigid transform, only the rotation and translation of T are used, identity is a no-op
+void transformInPlace(const Eigen::Matrix4d &T, open3d::geometry::PointCloud *cloud);
 
 std::shared_ptr<open3d::geometry::PointCloud> voxelizeWithinCroppingVolume(double voxel_size,
 		const CroppingVolume &croppingVolume, const open3d::geometry::PointCloud &cloud);
@@ -31,7 +33,9 @@ std::pair<std::vector<double>, std::vector<size_t>> computePointCloudDistance(
 		const open3d::geometry::PointCloud &reference, const open3d::geometry::PointCloud &cloud,
 		const std::vector<size_t> &idsInReference);
 
+// both remove in place and keep the order of the remaining points
 void removeByIds(const std::vector<size_t> &ids, open3d::geometry::PointCloud *cloud);
+void removeMarkedPoints(const std::vector<bool> &isRemove, open3d::geometry::PointCloud *cloud);
 std::vector<size_t> getIdxsOfCarvedPoints(const open3d::geometry::PointCloud &scan,
 		const open3d::geometry::PointCloud &cloud, const Eigen::Vector3d &sensorPosition,
 		const SpaceCarvingParameters &param);
@@ -6,58 +6,73 @@
  */
 
 #include "open3d_slam/AdjacencyMatrix.hpp"
-#include <stack>
+#include <algorithm>
 #include <queue>
-#include <map>
+#include <limits>
 #include <iostream>
 
 namespace o3d_slam {
 
-void AdjacencyMatrix::addEdge(SubmapId id1, SubmapId id2) {
-	adjacency_[id1].insert(id2);
-	adjacency_[id2].insert(id1);
-	isLoopClosureSubmap_[id1] = false;
-	isLoopClosureSubmap_[id2] = false;
+namespace {
+const int kUnreachable = std::numeric_limits<int>::max();
+} // namespace
+
+void AdjacencyMatrix::addNode(SubmapId id) {
+	const size_t size = std::max<size_t>(adjacency_.size(), id + 1);
+	adjacency_.resize(size);
+	distanceToLoopClosureSubmap_.resize(size, kUnreachable);
 }
 
-int AdjacencyMatrix::getDistanceToNearestLoopClosureSubmap(SubmapId id) const {
-	if (isLoopClosureSubmap_.empty()){
-		return std::numeric_limits<int>::max();
+void AdjacencyMatrix::addEdge(SubmapId id1, SubmapId id2) {
+	addNode(std::max(id1, id2));
+	auto insertSorted = [](SubmapId id, std::vector<SubmapId> *neighbours) {
+		const auto it = std::lower_bound(neighbours->begin(), neighbours->end(), id);
+		if (it == neighbours->end() || *it != id) {
+			neighbours->insert(it, id);
+		}
+	};
+	insertSorted(id2, &adjacency_[id1]);
+	insertSorted(id1, &adjacency_[id2]);
+	const int d1 = distanceToLoopClosureSubmap_[id1];
+	const int d2 = distanceToLoopClosureSubmap_[id2];
+	if (d1 < d2) {
+		propagateDistance(id2, d1 + 1);
+	} else if (d2 < d1) {
+		propagateDistance(id1, d2 + 1);
 	}
+}
 
+void AdjacencyMatrix::propagateDistance(SubmapId id, int distance) {
+	if (distance >= distanceToLoopClosureSubmap_[id]) {
+		return;
+	}
+	distanceToLoopClosureSubmap_[id] = distance;
 	std::queue<SubmapId> toProcess;
-	std::set<SubmapId> visited;
-	std::map<SubmapId,SubmapId> parents;
-	auto isVisited = [&visited](SubmapId id) {
-		return visited.find(id) != visited.end();
-	};
-	SubmapId v = id;
-	visited.insert(id);
 	toProcess.push(id);
 	while (!toProcess.empty()) {
-		v = toProcess.front();
+		const SubmapId v = toProcess.front();
 		toProcess.pop();
-		if (isLoopClosureSubmap_.at(v)) {
-			break;
-		}
-		for (const auto adj : adjacency_.at(v)) {
-			if (!isVisited(adj)) {
-				visited.insert(adj);
+		const int distanceAdjacent = distanceToLoopClosureSubmap_[v] + 1;
+		for (const auto adj : adjacency_[v]) {
+			if (distanceAdjacent < distanceToLoopClosureSubmap_[adj]) {
+				distanceToLoopClosureSubmap_[adj] = distanceAdjacent;
 				toProcess.push(adj);
-				parents.insert({adj,v});
 			}
 		}
 	} // end while
-	int distance = 0;
-	while (v!=id){
-		v = parents.at(v);
-		distance++;
+}
+
+int AdjacencyMatrix::getDistanceToNearestLoopClosureSubmap(SubmapId id) const {
+	if (id < 0 || id >= static_cast<SubmapId>(distanceToLoopClosureSubmap_.size())
+			|| distanceToLoopClosureSubmap_[id] == kUnreachable) {
+		return kUnreachable;
 	}
-	return std::max(0,distance-1);
+	return std::max(0, distanceToLoopClosureSubmap_[id] - 1);
 }
 
 void AdjacencyMatrix::markAsLoopClosureSubmap(SubmapId id) {
-	isLoopClosureSubmap_.at(id) = true;
+	addNode(id);
+	propagateDistance(id, 0);
 }
 
 bool AdjacencyMatrix::isAdjacent(SubmapId id1, SubmapId id2) const {
@@ -66,17 +81,20 @@ bool AdjacencyMatrix::isAdjacent(SubmapId id1, SubmapId id2) const {
 		return true;
 	}
 
-	const auto search = adjacency_.find(id1);
-	if (search == adjacency_.end()) {
+	if (id1 < 0 || id1 >= static_cast<SubmapId>(adjacency_.size())) {
 		return false;
 	}
-	return search->second.find(id2) != search->second.end();
+	const auto &neighbours = adjacency_[id1];
+	return std::binary_search(neighbours.begin(), neighbours.end(), id2);
 }
 
 void AdjacencyMatrix::print() const {
-	for (const auto node : adjacency_) {
-		std::cout << "node " << node.first << " has neighbours: ";
-		for (const auto neighbour : node.second) {
+	for (size_t id = 0; id < adjacency_.size(); ++id) {
+		if (adjacency_[id].empty()) {
+			continue;
+		}
+		std::cout << "node " << id << " has neighbours: ";
+		for (const auto neighbour : adjacency_[id]) {
 			std::cout << neighbour << ", ";
 		}
 		std::cout << "\n";
@@ -85,6 +103,7 @@ void AdjacencyMatrix::print() const {
 
 void AdjacencyMatrix::clear() {
 	adjacency_.clear();
+	distanceToLoopClosureSubmap_.clear();
 }
 
 } //namespace o3d_slam
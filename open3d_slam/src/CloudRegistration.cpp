@@ -5,11 +5,26 @@
  *      Author: jelavice
  */
 #include "open3d_slam/CloudRegistration.hpp"
+#include "open3d_slam/LoamRegistration.hpp"
 #include "open3d_slam/helpers.hpp"
 #include "open3d_slam/assert.hpp"
 
 namespace o3d_slam {
 using namespace open3d::pipelines::registration;
+
+namespace {
+// same as open3d GICP does on every call when the cloud has only normals: R * diag(epsilon,1,1) * R^T,
+// with R rotating the x axis onto the normal
+void computeCovariancesFromNormals(double epsilon, PointCloud *cloud) {
+	cloud->covariances_.resize(cloud->points_.size());
+#pragma omp parallel for schedule(static)
+	for (int i = 0; i < static_cast<int>(cloud->points_.size()); ++i) {
+		const Eigen::Vector3d &n = cloud->normals_[i];
+		cloud->covariances_[i] = Eigen::Matrix3d::Identity() - (1.0 - epsilon) * n * n.transpose();
+	}
+}
+} // namespace
+
 ////////////////////////////////
 /////// generalized
 ////////////////////////////////
@@ -20,13 +35,21 @@ RegistrationIcpGeneralized::RegistrationResult RegistrationIcpGeneralized::regis
 		init.matrix(),tranformationEstimationGICP_ , icpConvergenceCriteria_);
 }
 void RegistrationIcpGeneralized::estimateNormalsOrCovariancesIfNeeded(PointCloud *cloud) const {
-	assert_gt(maxRadiusNormalEstimation_,0.0,"maxRadiusNormalEstimation_");
-	assert_gt(knnNormalEstimation_,0,"knnNormalEstimation_");
-	open3d::geometry::KDTreeSearchParamHybrid param(maxRadiusNormalEstimation_, knnNormalEstimation_);
-	cloud->EstimateNormals(param);
-	cloud->NormalizeNormals();
-	cloud->OrientNormalsTowardsCameraLocation();
-//	cloud->EstimateCovariances(param);
+	// covariances are computed once per point, crop, transform and the map voxelization carry them along
+	if (cloud->HasCovariances()) {
+		return;
+	}
+	if (cloud->HasNormals()) {
+		cloud->NormalizeNormals(); // e.g. from the range image, voxelization averages them
+	} else {
+		assert_gt(maxRadiusNormalEstimation_,0.0,"maxRadiusNormalEstimation_");
+		assert_gt(knnNormalEstimation_,0,"knnNormalEstimation_");
+		open3d::geometry::KDTreeSearchParamHybrid param(maxRadiusNormalEstimation_, knnNormalEstimation_);
+		cloud->EstimateNormals(param);
+		cloud->NormalizeNormals();
+		cloud->OrientNormalsTowardsCameraLocation();
+	}
+	computeCovariancesFromNormals(tranformationEstimationGICP_.epsilon_, cloud);
 }
 
 std::unique_ptr<RegistrationIcpGeneralized> createGeneralizedIcp(const CloudRegistrationParameters &p) {
@@ -35,6 +58,8 @@ std::unique_ptr<RegistrationIcpGeneralized> createGeneralizedIcp(const CloudRegi
 	ret->knnNormalEstimation_ = p.icp_.knn_;
 	ret->maxRadiusNormalEstimation_ = p.icp_.maxDistanceKnn_;
 	ret->icpConvergenceCriteria_.max_iteration_ = p.icp_.maxNumIter_;
+	ret->icpConvergenceCriteria_.relative_fitness_ = p.icp_.relativeFitness_;
+	ret->icpConvergenceCriteria_.relative_rmse_ = p.icp_.relativeRmse_;
 	return std::move(ret);
 }
 
@@ -48,6 +73,10 @@ RegistrationIcpPointToPlane::RegistrationResult RegistrationIcpPointToPlane::reg
 		init.matrix(),pointToPlane_ , icpConvergenceCriteria_);
 }
 void RegistrationIcpPointToPlane::estimateNormalsOrCovariancesIfNeeded(PointCloud *cloud) const {
+	if (cloud->HasNormals()) {
+		cloud->NormalizeNormals(); // e.g. from the range image, voxelization averages them
+		return;
+	}
 	assert_gt(maxRadiusNormalEstimation_,0.0,"maxRadiusNormalEstimation_");
 	assert_gt(knnNormalEstimation_,0,"knnNormalEstimation_");
 	open3d::geometry::KDTreeSearchParamHybrid param(maxRadiusNormalEstimation_, knnNormalEstimation_);
@@ -62,6 +91,8 @@ std::unique_ptr<RegistrationIcpPointToPlane> createPointToPlaneIcp(const CloudRe
 	ret->knnNormalEstimation_ = p.icp_.knn_;
 	ret->maxRadiusNormalEstimation_ = p.icp_.maxDistanceKnn_;
 	ret->icpConvergenceCriteria_.max_iteration_ = p.icp_.maxNumIter_;
+	ret->icpConvergenceCriteria_.relative_fitness_ = p.icp_.relativeFitness_;
+	ret->icpConvergenceCriteria_.relative_rmse_ = p.icp_.relativeRmse_;
 	return std::move(ret);
 }
 ////////////////////////////////
@@ -78,6 +109,8 @@ std::unique_ptr<RegistrationIcpPointToPoint> createPointToPointIcp(const CloudRe
 	auto ret  = std::make_unique<RegistrationIcpPointToPoint>();
 	ret->maxCorrespondenceDistance_ = p.icp_.maxCorrespondenceDistance_;
 	ret->icpConvergenceCriteria_.max_iteration_ = p.icp_.maxNumIter_;
+	ret->icpConvergenceCriteria_.relative_fitness_ = p.icp_.relativeFitness_;
+	ret->icpConvergenceCriteria_.relative_rmse_ = p.icp_.relativeRmse_;
 	return std::move(ret);
 }
 ////////////////////////////////
@@ -95,6 +128,9 @@ std::unique_ptr<CloudRegistration> cloudRegistrationFactory(const CloudRegistrat
 	case 	CloudRegistrationType::GeneralizedIcp:{
 		return createGeneralizedIcp(p);
 	}
+	case 	CloudRegistrationType::LoamFeatures:{
+		return createLoam(p);
+	}
 
 	default:
 		throw std::runtime_error("cloud: unknown type of cloud registration");
@@ -0,0 +1,185 @@
+/*
+ * CompactPointCloud.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "open3d_slam/CompactPointCloud.hpp"
+#include "open3d_slam/assert.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace o3d_slam {
+
+namespace {
+const double kNormalScale = std::numeric_limits<int16>::max();
+const double kColorScale = std::numeric_limits<uint8>::max();
+
+double signNotZero(double v) {
+	return v >= 0.0 ? 1.0 : -1.0;
+}
+
+std::array<int16, 2> encodeNormal(const Eigen::Vector3d &normal) {
+	const Eigen::Vector3d n = normal / (normal.lpNorm<1>() + 1e-12);
+	double x = n.x(), y = n.y();
+	if (n.z() < 0.0) {
+		x = (1.0 - std::abs(n.y())) * signNotZero(n.x());
+		y = (1.0 - std::abs(n.x())) * signNotZero(n.y());
+	}
+	return {static_cast<int16>(std::round(x * kNormalScale)), static_cast<int16>(std::round(y * kNormalScale))};
+}
+
+Eigen::Vector3d decodeNormal(const std::array<int16, 2> &e) {
+	const double x = e[0] / kNormalScale;
+	const double y = e[1] / kNormalScale;
+	Eigen::Vector3d n(x, y, 1.0 - std::abs(x) - std::abs(y));
+	if (n.z() < 0.0) {
+		n.x() = (1.0 - std::abs(y)) * signNotZero(x);
+		n.y() = (1.0 - std::abs(x)) * signNotZero(y);
+	}
+	return n.normalized();
+}
+
+std::array<float, 6> encodeCovariance(const Eigen::Matrix3d &c) {
+	return {static_cast<float>(c(0, 0)), static_cast<float>(c(0, 1)), static_cast<float>(c(0, 2)),
+			static_cast<float>(c(1, 1)), static_cast<float>(c(1, 2)), static_cast<float>(c(2, 2))};
+}
+
+Eigen::Matrix3d decodeCovariance(const std::array<float, 6> &e) {
+	Eigen::Matrix3d c;
+	c << e[0], e[1], e[2], e[1], e[3], e[4], e[2], e[4], e[5];
+	return c;
+}
+
+template<typename Scalar>
+std::array<Scalar, 3> quantize(const Eigen::Vector3d &p) {
+	return {static_cast<Scalar>(std::round(p.x())), static_cast<Scalar>(std::round(p.y())),
+			static_cast<Scalar>(std::round(p.z()))};
+}
+
+template<typename Scalar>
+void decodePoints(const std::vector<std::array<Scalar, 3>> &quantized, const Transform &origin, double resolution,
+		std::vector<Eigen::Vector3d> *points) {
+	points->resize(quantized.size());
+	for (size_t i = 0; i < quantized.size(); ++i) {
+		const auto &q = quantized[i];
+		(*points)[i] = origin * (resolution * Eigen::Vector3d(q[0], q[1], q[2]));
+	}
+}
+} // namespace
+
+void CompactPointCloud::encode(const PointCloud &cloud, const Transform &origin, double resolution,
+		const std::vector<int> &weights) {
+	assert_gt(resolution, 0.0, "CompactPointCloud resolution");
+	if (!weights.empty()) {
+		assert_eq(weights.size(), cloud.points_.size(), "CompactPointCloud needs one weight per point: ");
+	}
+	clear();
+	origin_ = origin;
+	resolution_ = resolution;
+	const size_t n = cloud.points_.size();
+	const Transform originToMap = origin.inverse();
+	std::vector<Eigen::Vector3d> scaled(n);
+	double maxAbsCoordinate = 0.0;
+	for (size_t i = 0; i < n; ++i) {
+		scaled[i] = (originToMap * cloud.points_[i]) / resolution;
+		maxAbsCoordinate = std::max(maxAbsCoordinate, scaled[i].lpNorm<Eigen::Infinity>());
+	}
+	if (maxAbsCoordinate < std::numeric_limits<int16>::max()) {
+		points16_.reserve(n);
+		for (const auto &p : scaled) {
+			points16_.push_back(quantize<int16>(p));
+		}
+	} else {
+		points32_.reserve(n);
+		for (const auto &p : scaled) {
+			points32_.push_back(quantize<int32>(p));
+		}
+	}
+	if (cloud.HasNormals()) {
+		normals_.reserve(n);
+		for (const auto &normal : cloud.normals_) {
+			normals_.push_back(encodeNormal(originToMap.linear() * normal));
+		}
+	}
+	if (cloud.HasColors()) {
+		colors_.reserve(n);
+		for (const auto &c : cloud.colors_) {
+			const Eigen::Vector3d rgb = (c.cwiseMax(0.0).cwiseMin(1.0) * kColorScale).array().round();
+			colors_.push_back({static_cast<uint8>(rgb.x()), static_cast<uint8>(rgb.y()), static_cast<uint8>(rgb.z())});
+		}
+	}
+	if (cloud.HasCovariances()) {
+		const Eigen::Matrix3d R = originToMap.linear();
+		covariances_.reserve(n);
+		for (const auto &c : cloud.covariances_) {
+			covariances_.push_back(encodeCovariance(R * c * R.transpose()));
+		}
+	}
+	weights_.reserve(weights.size());
+	for (const int w : weights) {
+		weights_.push_back(static_cast<uint16>(std::min<int>(std::max(w, 0), std::numeric_limits<uint16>::max())));
+	}
+}
+
+void CompactPointCloud::decode(PointCloud *cloud, std::vector<int> *weights) const {
+	cloud->Clear();
+	if (weights != nullptr) {
+		weights->assign(weights_.begin(), weights_.end());
+	}
+	if (!points16_.empty()) {
+		decodePoints(points16_, origin_, resolution_, &cloud->points_);
+	} else {
+		decodePoints(points32_, origin_, resolution_, &cloud->points_);
+	}
+	cloud->normals_.reserve(normals_.size());
+	for (const auto &e : normals_) {
+		cloud->normals_.push_back(origin_.linear() * decodeNormal(e));
+	}
+	cloud->colors_.reserve(colors_.size());
+	for (const auto &c : colors_) {
+		cloud->colors_.emplace_back(c[0] / kColorScale, c[1] / kColorScale, c[2] / kColorScale);
+	}
+	const Eigen::Matrix3d R = origin_.linear();
+	cloud->covariances_.reserve(covariances_.size());
+	for (const auto &e : covariances_) {
+		cloud->covariances_.push_back(R * decodeCovariance(e) * R.transpose());
+	}
+}
+
+void CompactPointCloud::transform(const Transform &T) {
+	origin_ = T * origin_;
+}
+
+size_t CompactPointCloud::size() const {
+	return points16_.size() + points32_.size();
+}
+
+bool CompactPointCloud::empty() const {
+	return size() == 0;
+}
+
+void CompactPointCloud::clear() {
+	points16_.clear();
+	points16_.shrink_to_fit();
+	points32_.clear();
+	points32_.shrink_to_fit();
+	normals_.clear();
+	normals_.shrink_to_fit();
+	colors_.clear();
+	colors_.shrink_to_fit();
+	covariances_.clear();
+	covariances_.shrink_to_fit();
+	weights_.clear();
+	weights_.shrink_to_fit();
+}
+
+size_t CompactPointCloud::getNumBytes() const {
+	return points16_.size() * sizeof(points16_[0]) + points32_.size() * sizeof(points32_[0])
+			+ normals_.size() * sizeof(normals_[0]) + colors_.size() * sizeof(colors_[0])
+			+ covariances_.size() * sizeof(covariances_[0]) + weights_.size() * sizeof(weights_[0]);
+}
+
+} // namespace o3d_slam
@@ -0,0 +1,49 @@
+/*
+ * GaussNewton.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "open3d_slam/GaussNewton.hpp"
+
+#include <cmath>
+
+namespace o3d_slam {
+
+Eigen::Matrix<double, 3, 6> pointJacobian(const Eigen::Vector3d &p) {
+	Eigen::Matrix<double, 3, 6> J;
+	J.leftCols<3>() << 0.0, p.z(), -p.y(), -p.z(), 0.0, p.x(), p.y(), -p.x(), 0.0; // -skew(p)
+	J.rightCols<3>().setIdentity();
+	return J;
+}
+
+open3d::pipelines::registration::RegistrationResult optimizeRigidTransform(const Transform &init,
+		size_t numSourcePoints, int maxNumIter, int minNumCorrespondences, double convergenceThreshold,
+		const LinearizeFunction &linearize) {
+	open3d::pipelines::registration::RegistrationResult result(init.matrix());
+	Transform T = init;
+	for (int iter = 0; iter < maxNumIter; ++iter) {
+		GaussNewtonSystem system;
+		linearize(T, &system);
+		if (system.numCorrespondences_ < minNumCorrespondences) {
+			break;
+		}
+		result.fitness_ = static_cast<double>(system.numCorrespondences_) / numSourcePoints;
+		result.inlier_rmse_ = std::sqrt(system.sumSquaredResiduals_ / system.numCorrespondences_);
+		const Eigen::Matrix<double, 6, 1> delta = -system.H_.ldlt().solve(system.g_);
+		Transform increment = Transform::Identity();
+		const double angle = delta.head<3>().norm();
+		if (angle > 0.0) {
+			increment.linear() = Eigen::AngleAxisd(angle, delta.head<3>() / angle).toRotationMatrix();
+		}
+		increment.translation() = delta.tail<3>();
+		T = increment * T;
+		result.transformation_ = T.matrix();
+		if (delta.norm() < convergenceThreshold) {
+			break;
+		}
+	}
+	return result;
+}
+
+} // namespace o3d_slam
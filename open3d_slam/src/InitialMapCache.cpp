@@ -0,0 +1,339 @@
+/*
+ * InitialMapCache.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "open3d_slam/InitialMapCache.hpp"
+#include "open3d_slam/output.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace o3d_slam {
+
+namespace {
+const char kMagic[8] = { 'O', '3', 'D', 'S', 'M', 'A', 'P', 'C' };
+const char kPlacesMagic[8] = { 'O', '3', 'D', 'S', 'P', 'L', 'C', 'C' };
+const uint32 kFormatVersion = 1;
+enum Fields : uint32 {
+	kNormals = 1 << 0, kColors = 1 << 1, kCovariances = 1 << 2
+};
+
+struct CacheHeader {
+	char magic_[8];
+	uint32 version_;
+	uint32 fields_;
+	uint64 key_;
+	uint64 numPoints_;
+};
+
+struct PlaceHeader {
+	double center_[3];
+	uint64 numPoints_;
+	uint64 numFeatures_;
+	uint32 fields_;
+	uint32 featureDimension_;
+};
+
+// 64 bit multiply-rotate hash, consumes 8 bytes at a time
+class Hasher {
+public:
+	void add(const void *data, size_t numBytes) {
+		const unsigned char *bytes = static_cast<const unsigned char*>(data);
+		size_t i = 0;
+		for (; i + sizeof(uint64) <= numBytes; i += sizeof(uint64)) {
+			uint64 word;
+			std::memcpy(&word, bytes + i, sizeof(uint64));
+			mix(word);
+		}
+		uint64 tail = 0;
+		std::memcpy(&tail, bytes + i, numBytes - i);
+		mix(tail ^ numBytes);
+	}
+	template<typename T>
+	void add(const std::vector<T> &v) {
+		if (!v.empty()) {
+			add(v.data(), v.size() * sizeof(T));
+		}
+		mix(v.size());
+	}
+	template<typename T>
+	void addValue(const T &value) {
+		add(&value, sizeof(T));
+	}
+	uint64 digest() const {
+		uint64 h = state_;
+		h ^= h >> 33;
+		h *= 0xff51afd7ed558ccdULL;
+		h ^= h >> 33;
+		return h;
+	}
+private:
+	void mix(uint64 word) {
+		state_ ^= word * 0x9e3779b97f4a7c15ULL;
+		state_ = ((state_ << 31) | (state_ >> 33)) * 0xc2b2ae3d27d4eb4fULL;
+	}
+	uint64 state_ = 0x84222325cbf29ce4ULL;
+};
+
+template<typename T>
+void writeVector(const std::vector<T> &v, std::ofstream *out) {
+	out->write(reinterpret_cast<const char*>(v.data()), v.size() * sizeof(T));
+}
+
+template<typename T>
+bool readVector(const char *end, size_t n, const char **cursor, std::vector<T> *v) {
+	const size_t numBytes = n * sizeof(T);
+	if (static_cast<size_t>(end - *cursor) < numBytes) {
+		return false;
+	}
+	v->resize(n);
+	std::memcpy(static_cast<void*>(v->data()), *cursor, numBytes);
+	*cursor += numBytes;
+	return true;
+}
+
+template<typename T>
+bool readValue(const char *end, const char **cursor, T *value) {
+	if (static_cast<size_t>(end - *cursor) < sizeof(T)) {
+		return false;
+	}
+	std::memcpy(value, *cursor, sizeof(T));
+	*cursor += sizeof(T);
+	return true;
+}
+
+uint32 getFields(const PointCloud &cloud) {
+	return (cloud.HasNormals() ? kNormals : 0) | (cloud.HasColors() ? kColors : 0)
+			| (cloud.HasCovariances() ? kCovariances : 0);
+}
+
+void writeCloud(const PointCloud &cloud, uint32 fields, std::ofstream *out) {
+	writeVector(cloud.points_, out);
+	if (fields & kNormals) {
+		writeVector(cloud.normals_, out);
+	}
+	if (fields & kColors) {
+		writeVector(cloud.colors_, out);
+	}
+	if (fields & kCovariances) {
+		writeVector(cloud.covariances_, out);
+	}
+}
+
+bool readCloud(const char *end, size_t n, uint32 fields, const char **cursor, PointCloud *cloud) {
+	bool isOk = readVector(end, n, cursor, &cloud->points_);
+	if (isOk && (fields & kNormals)) {
+		isOk = readVector(end, n, cursor, &cloud->normals_);
+	}
+	if (isOk && (fields & kColors)) {
+		isOk = readVector(end, n, cursor, &cloud->colors_);
+	}
+	if (isOk && (fields & kCovariances)) {
+		isOk = readVector(end, n, cursor, &cloud->covariances_);
+	}
+	return isOk;
+}
+
+// writes to a temporary first so that a crash never leaves a truncated cache behind
+bool writeFileAtomically(const std::string &filename, const std::function<void(std::ofstream*)> &write) {
+	const std::string tmpFilename = filename + ".tmp";
+	{
+		std::ofstream out(tmpFilename, std::ios::binary | std::ios::trunc);
+		if (!out.is_open()) {
+			std::cerr << "InitialMapCache: could not open " << tmpFilename << " for writing \n";
+			return false;
+		}
+		write(&out);
+		if (!out.good()) {
+			std::cerr << "InitialMapCache: failed writing " << tmpFilename << "\n";
+			return false;
+		}
+	}
+	return std::rename(tmpFilename.c_str(), filename.c_str()) == 0;
+}
+
+// read only memory mapping of a whole file, unmapped on destruction
+class MappedFile {
+public:
+	explicit MappedFile(const std::string &filename) {
+		const int fd = ::open(filename.c_str(), O_RDONLY);
+		if (fd < 0) {
+			return;
+		}
+		struct stat st;
+		if (::fstat(fd, &st) != 0 || st.st_size <= 0) {
+			::close(fd);
+			return;
+		}
+		void *mapped = ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		::close(fd);
+		if (mapped == MAP_FAILED) {
+			return;
+		}
+		::madvise(mapped, st.st_size, MADV_SEQUENTIAL);
+		begin_ = static_cast<const char*>(mapped);
+		size_ = st.st_size;
+	}
+	~MappedFile() {
+		if (begin_ != nullptr) {
+			::munmap(const_cast<char*>(begin_), size_);
+		}
+	}
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+	const char* begin() const {
+		return begin_;
+	}
+	const char* end() const {
+		return begin_ + size_;
+	}
+	size_t size() const {
+		return size_;
+	}
+private:
+	const char *begin_ = nullptr;
+	size_t size_ = 0;
+};
+
+} // namespace
+
+uint64 computeInitialMapCacheKey(const PointCloud &rawMap, const MapperParameters &p) {
+	Hasher hasher;
+	hasher.addValue(kFormatVersion);
+	hasher.add(rawMap.points_);
+	hasher.add(rawMap.normals_);
+	hasher.add(rawMap.colors_);
+	hasher.addValue(p.mapBuilder_.mapVoxelSize_);
+	hasher.addValue(static_cast<int>(p.scanMatcher_.scanToMapRegType_));
+	hasher.addValue(p.scanMatcher_.icp_.knn_);
+	hasher.addValue(p.scanMatcher_.icp_.maxDistanceKnn_);
+	return hasher.digest();
+}
+
+std::string getInitialMapCacheFilename(const std::string &directory, uint64 key) {
+	return directory + string_format("initial_map_%016llx.bin", static_cast<unsigned long long>(key));
+}
+
+bool saveInitialMapCache(const std::string &filename, uint64 key, const PointCloud &preparedMap) {
+	CacheHeader header;
+	std::memcpy(header.magic_, kMagic, sizeof(kMagic));
+	header.version_ = kFormatVersion;
+	header.fields_ = getFields(preparedMap);
+	header.key_ = key;
+	header.numPoints_ = preparedMap.points_.size();
+	return writeFileAtomically(filename, [&](std::ofstream *out) {
+		out->write(reinterpret_cast<const char*>(&header), sizeof(header));
+		writeCloud(preparedMap, header.fields_, out);
+	});
+}
+
+bool loadInitialMapCache(const std::string &filename, uint64 key, PointCloud *preparedMap) {
+	const MappedFile file(filename);
+	CacheHeader header;
+	const char *cursor = file.begin();
+	if (file.begin() == nullptr || !readValue(file.end(), &cursor, &header)) {
+		return false;
+	}
+	bool isOk = std::memcmp(header.magic_, kMagic, sizeof(kMagic)) == 0 && header.version_ == kFormatVersion
+			&& header.key_ == key;
+	PointCloud cloud;
+	isOk = isOk && readCloud(file.end(), header.numPoints_, header.fields_, &cursor, &cloud);
+	isOk = isOk && cursor == file.end();
+	if (isOk) {
+		*preparedMap = std::move(cloud);
+	}
+	return isOk;
+}
+
+uint64 computeRelocalizationPlacesCacheKey(uint64 initialMapKey, const MapperParameters &p) {
+	Hasher hasher;
+	hasher.addValue(kFormatVersion);
+	hasher.addValue(initialMapKey);
+	hasher.addValue(p.relocalization_.placeSize_);
+	hasher.addValue(p.relocalization_.placePaddingRatio_);
+	hasher.addValue(p.scanProcessing_.cropper_.croppingMaxRadius_);
+	hasher.addValue(p.placeRecognition_.featureVoxelSize_);
+	hasher.addValue(p.placeRecognition_.normalEstimationRadius_);
+	hasher.addValue(p.placeRecognition_.normalKnn_);
+	hasher.addValue(p.placeRecognition_.featureRadius_);
+	hasher.addValue(p.placeRecognition_.featureKnn_);
+	return hasher.digest();
+}
+
+std::string getRelocalizationPlacesCacheFilename(const std::string &directory, uint64 key) {
+	return directory + string_format("relocalization_places_%016llx.bin", static_cast<unsigned long long>(key));
+}
+
+bool saveRelocalizationPlacesCache(const std::string &filename, uint64 key,
+		const std::vector<Relocalizer::Place> &places) {
+	CacheHeader header;
+	std::memcpy(header.magic_, kPlacesMagic, sizeof(kPlacesMagic));
+	header.version_ = kFormatVersion;
+	header.fields_ = 0;
+	header.key_ = key;
+	header.numPoints_ = places.size(); // number of places
+	return writeFileAtomically(filename, [&](std::ofstream *out) {
+		out->write(reinterpret_cast<const char*>(&header), sizeof(header));
+		for (const auto &place : places) {
+			PlaceHeader placeHeader;
+			std::memcpy(placeHeader.center_, place.center_.data(), sizeof(placeHeader.center_));
+			placeHeader.numPoints_ = place.cloud_.points_.size();
+			placeHeader.fields_ = getFields(place.cloud_);
+			placeHeader.featureDimension_ = place.feature_->data_.rows();
+			placeHeader.numFeatures_ = place.feature_->data_.cols();
+			out->write(reinterpret_cast<const char*>(&placeHeader), sizeof(placeHeader));
+			writeCloud(place.cloud_, placeHeader.fields_, out);
+			out->write(reinterpret_cast<const char*>(place.feature_->data_.data()),
+					place.feature_->data_.size() * sizeof(double));
+		}
+	});
+}
+
+bool loadRelocalizationPlacesCache(const std::string &filename, uint64 key,
+		std::vector<Relocalizer::Place> *places) {
+	const MappedFile file(filename);
+	CacheHeader header;
+	const char *cursor = file.begin();
+	if (file.begin() == nullptr || !readValue(file.end(), &cursor, &header)) {
+		return false;
+	}
+	bool isOk = std::memcmp(header.magic_, kPlacesMagic, sizeof(kPlacesMagic)) == 0
+			&& header.version_ == kFormatVersion && header.key_ == key;
+	std::vector<Relocalizer::Place> loaded;
+	for (uint64 i = 0; isOk && i < header.numPoints_; ++i) {
+		PlaceHeader placeHeader;
+		isOk = readValue(file.end(), &cursor, &placeHeader);
+		if (!isOk) {
+			break;
+		}
+		Relocalizer::Place place;
+		place.center_ = Eigen::Map<const Eigen::Vector3d>(placeHeader.center_);
+		isOk = readCloud(file.end(), placeHeader.numPoints_, placeHeader.fields_, &cursor, &place.cloud_);
+		const size_t numFeatureBytes = placeHeader.featureDimension_ * placeHeader.numFeatures_ * sizeof(double);
+		isOk = isOk && static_cast<size_t>(file.end() - cursor) >= numFeatureBytes;
+		if (!isOk) {
+			break;
+		}
+		place.feature_ = std::make_shared<Relocalizer::Feature>();
+		place.feature_->data_.resize(placeHeader.featureDimension_, placeHeader.numFeatures_);
+		std::memcpy(place.feature_->data_.data(), cursor, numFeatureBytes);
+		cursor += numFeatureBytes;
+		loaded.push_back(std::move(place));
+	}
+	isOk = isOk && cursor == file.end();
+	if (isOk) {
+		*places = std::move(loaded);
+	}
+	return isOk;
+}
+
+} // namespace o3d_slam
@@ -0,0 +1,218 @@
+/*
+ * LoamRegistration.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "open3d_slam/LoamRegistration.hpp"
+#include "open3d_slam/RangeImage.hpp"
+#include "open3d_slam/assert.hpp"
+#include "open3d_slam/GaussNewton.hpp"
+#include "open3d_slam/helpers.hpp"
+
+#include <open3d/geometry/KDTreeFlann.h>
+#include <algorithm>
+#include <cmath>
+
+namespace o3d_slam {
+
+namespace {
+const int kNumNeighbours = 5;
+const int kNeighbourSuppressionHalfWindow = 5; // columns around a picked feature that can't be picked anymore
+const double kMinLineEigenvalueRatio = 3.0;
+const double kMinNormalsCosine = 0.8; // planar correspondences need similar normals
+const double kConvergenceThreshold = 1e-6;
+const int kMinNumCorrespondences = 10;
+const double kHuberDelta = 0.1; // m, silhouettes of curved objects and features at corners don't match exactly
+
+struct Candidate {
+	int column_;
+	double curvature_;
+};
+
+double huberWeight(double residual) {
+	return residual <= kHuberDelta ? 1.0 : kHuberDelta / residual;
+}
+
+bool findNeighbours(const open3d::geometry::KDTreeFlann &tree, const PointCloud &cloud, const Eigen::Vector3d &p,
+		double maxDistance, Eigen::Vector3d *mean, Eigen::Matrix3d *covariance, std::vector<int> *idxs) {
+	std::vector<double> distances;
+	if (tree.SearchKNN(p, kNumNeighbours, *idxs, distances) < kNumNeighbours
+			|| distances.back() > maxDistance * maxDistance) {
+		return false;
+	}
+	mean->setZero();
+	for (const int idx : *idxs) {
+		*mean += cloud.points_[idx];
+	}
+	*mean /= kNumNeighbours;
+	covariance->setZero();
+	for (const int idx : *idxs) {
+		const Eigen::Vector3d d = cloud.points_[idx] - *mean;
+		covariance->noalias() += d * d.transpose();
+	}
+	*covariance /= kNumNeighbours;
+	return true;
+}
+
+void pickFeatures(const std::vector<Candidate> &candidates, int maxNum, int numColumns, std::vector<uint8_t> *isPicked,
+		std::vector<int> *pickedColumns) {
+	int numPicked = 0;
+	for (const auto &candidate : candidates) {
+		if (numPicked >= maxNum) {
+			break;
+		}
+		if ((*isPicked)[candidate.column_]) {
+			continue;
+		}
+		pickedColumns->push_back(candidate.column_);
+		++numPicked;
+		for (int dc = -kNeighbourSuppressionHalfWindow; dc <= kNeighbourSuppressionHalfWindow; ++dc) {
+			(*isPicked)[(candidate.column_ + dc + numColumns) % numColumns] = 1;
+		}
+	}
+}
+
+} // namespace
+
+bool isLoamEdgeFeature(const PointCloud &features, size_t idx) {
+	return features.normals_[idx].isZero();
+}
+
+PointCloudPtr extractLoamFeatures(const PointCloud &scan, const LoamParameters &p) {
+	assert_gt(p.numSectors_, 0, "loam num sectors: ");
+	RangeImageParameters imageParams;
+	imageParams.numColumns_ = p.numColumns_;
+	imageParams.edgeCurvatureThreshold_ = p.edgeCurvatureThreshold_;
+	imageParams.planarCurvatureThreshold_ = p.planarCurvatureThreshold_;
+	RangeImage image;
+	image.setParameters(imageParams);
+	// rings are only horizontal in the frame of the lidar
+	const bool isScanInLidarFrame = p.rangeSensorToLidar_.isApprox(Eigen::Isometry3d::Identity());
+	if (isScanInLidarFrame) {
+		image.setFromElevation(scan, p.numRings_, p.minElevation_, p.maxElevation_);
+	} else {
+		const auto scanInLidarFrame = transform(p.rangeSensorToLidar_.inverse().matrix(), scan);
+		image.setFromElevation(*scanInLidarFrame, p.numRings_, p.minElevation_, p.maxElevation_);
+	}
+	image.computeLabels();
+
+	auto features = std::make_shared<PointCloud>();
+	const int numColumns = image.getNumColumns();
+	std::vector<uint8_t> isPicked;
+	std::vector<Candidate> edges, planars;
+	std::vector<int> edgeColumns, planarColumns;
+	for (int r = 0; r < image.getNumRings(); ++r) {
+		isPicked.assign(numColumns, 0);
+		edgeColumns.clear();
+		planarColumns.clear();
+		for (int s = 0; s < p.numSectors_; ++s) {
+			edges.clear();
+			planars.clear();
+			for (int c = s * numColumns / p.numSectors_; c < (s + 1) * numColumns / p.numSectors_; ++c) {
+				const RangeImage::Label label = image.getLabel(r, c);
+				if (label == RangeImage::Label::Edge) {
+					edges.push_back(Candidate { c, image.getCurvature(r, c) });
+				} else if (label == RangeImage::Label::Planar || label == RangeImage::Label::Ground) {
+					planars.push_back(Candidate { c, image.getCurvature(r, c) });
+				}
+			}
+			std::sort(edges.begin(), edges.end(), [](const Candidate &a, const Candidate &b) {
+				return a.curvature_ > b.curvature_;
+			});
+			std::sort(planars.begin(), planars.end(), [](const Candidate &a, const Candidate &b) {
+				return a.curvature_ < b.curvature_;
+			});
+			pickFeatures(edges, p.maxNumEdgesPerSector_, numColumns, &isPicked, &edgeColumns);
+			pickFeatures(planars, p.maxNumPlanarsPerSector_, numColumns, &isPicked, &planarColumns);
+		}
+		for (const int c : edgeColumns) {
+			features->points_.push_back(image.getPoint(r, c));
+			features->normals_.push_back(Eigen::Vector3d::Zero());
+		}
+		Eigen::Vector3d normal;
+		for (const int c : planarColumns) {
+			if (image.computeNormal(r, c, &normal)) {
+				features->points_.push_back(image.getPoint(r, c));
+				features->normals_.push_back(normal);
+			}
+		}
+	}
+	if (!isScanInLidarFrame) {
+		transformInPlace(p.rangeSensorToLidar_.matrix(), features.get());
+	}
+	return features;
+}
+
+RegistrationLoam::RegistrationResult RegistrationLoam::registerClouds(const PointCloud &source,
+		const PointCloud &target, const Transform &init) const {
+	assert_true(source.HasNormals() && target.HasNormals(), "Loam registration needs clouds with loam features");
+	PointCloud targetEdges, targetPlanars;
+	for (size_t i = 0; i < target.points_.size(); ++i) {
+		if (isLoamEdgeFeature(target, i)) {
+			targetEdges.points_.push_back(target.points_[i]);
+		} else {
+			targetPlanars.points_.push_back(target.points_[i]);
+			targetPlanars.normals_.push_back(target.normals_[i]);
+		}
+	}
+	const open3d::geometry::KDTreeFlann edgeTree(targetEdges), planarTree(targetPlanars);
+
+	std::vector<int> idxs;
+	std::vector<double> distances;
+	Eigen::Vector3d mean;
+	Eigen::Matrix3d covariance;
+	Eigen::SelfAdjointEigenSolver<Eigen::Matrix3d> solver;
+	auto linearize = [&](const Transform &T, GaussNewtonSystem *system) {
+		for (size_t i = 0; i < source.points_.size(); ++i) {
+			const Eigen::Vector3d p = T * source.points_[i];
+			if (isLoamEdgeFeature(source, i)) {
+				if (targetEdges.IsEmpty()
+						|| !findNeighbours(edgeTree, targetEdges, p, maxCorrespondenceDistance_, &mean, &covariance, &idxs)) {
+					continue;
+				}
+				solver.computeDirect(covariance);
+				const Eigen::Vector3d eigenvalues = solver.eigenvalues();
+				if (eigenvalues(2) < kMinLineEigenvalueRatio * eigenvalues(1)) {
+					continue; // neighbours don't form a line
+				}
+				const Eigen::Vector3d direction = solver.eigenvectors().col(2);
+				const Eigen::Matrix3d projection = Eigen::Matrix3d::Identity() - direction * direction.transpose();
+				const Eigen::Vector3d e = projection * (p - mean);
+				const Eigen::Matrix<double, 3, 6> J = projection * pointJacobian(p);
+				const double w = huberWeight(e.norm());
+				system->H_.noalias() += w * J.transpose() * J;
+				system->g_.noalias() += w * J.transpose() * e;
+				system->sumSquaredResiduals_ += e.squaredNorm();
+			} else {
+				// planar features are sparse, the plane comes from the normal of the closest one
+				if (targetPlanars.IsEmpty() || planarTree.SearchKNN(p, 1, idxs, distances) < 1
+						|| distances.front() > maxCorrespondenceDistance_ * maxCorrespondenceDistance_) {
+					continue;
+				}
+				const Eigen::Vector3d &n = targetPlanars.normals_[idxs.front()];
+				if (n.dot(T.linear() * source.normals_[i]) < kMinNormalsCosine) {
+					continue;
+				}
+				const double e = n.dot(p - targetPlanars.points_[idxs.front()]);
+				const Eigen::Matrix<double, 1, 6> J = n.transpose() * pointJacobian(p);
+				const double w = huberWeight(std::fabs(e));
+				system->H_.noalias() += w * J.transpose() * J;
+				system->g_.noalias() += w * J.transpose() * e;
+				system->sumSquaredResiduals_ += e * e;
+			}
+			++system->numCorrespondences_;
+		}
+	};
+	return optimizeRigidTransform(init, source.points_.size(), maxNumIter_, kMinNumCorrespondences,
+			kConvergenceThreshold, linearize);
+}
+
+std::unique_ptr<RegistrationLoam> createLoam(const CloudRegistrationParameters &p) {
+	auto ret = std::make_unique<RegistrationLoam>();
+	ret->maxCorrespondenceDistance_ = p.icp_.maxCorrespondenceDistance_;
+	ret->maxNumIter_ = p.icp_.maxNumIter_;
+	return std::move(ret);
+}
+
+} // namespace o3d_slam
@@ -0,0 +1,206 @@
+/*
+ * LocalizationMap.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "open3d_slam/LocalizationMap.hpp"
+#include "open3d_slam/helpers.hpp"
+#include "open3d_slam/assert.hpp"
+#include "open3d_slam/time.hpp"
+
+#include <open3d/pipelines/registration/GeneralizedICP.h>
+
+#ifdef open3d_slam_OPENMP_FOUND
+#include <omp.h>
+#endif
+
+namespace o3d_slam {
+
+namespace {
+namespace registration = open3d::pipelines::registration;
+} // namespace
+
+void LocalizationMap::setParameters(const MapperParameters &p) {
+	assert_gt(p.localizationMap_.tileSize_, 0.0, "localization map tile size: ");
+	std::lock_guard<std::mutex> lck(mapMutex_);
+	params_ = p;
+	tileSize_ = Eigen::Vector3d::Constant(p.localizationMap_.tileSize_);
+	switch (p.scanMatcher_.scanToMapRegType_) {
+	case ScanToMapRegistrationType::PointToPlaneIcp: {
+		estimation_ = std::make_unique<registration::TransformationEstimationPointToPlane>();
+		break;
+	}
+	case ScanToMapRegistrationType::Ndt: // tiles keep points only, no distributions
+	case ScanToMapRegistrationType::PointToPointIcp: {
+		estimation_ = std::make_unique<registration::TransformationEstimationPointToPoint>();
+		break;
+	}
+	case ScanToMapRegistrationType::GeneralizedIcp: {
+		estimation_ = std::make_unique<registration::TransformationEstimationForGeneralizedICP>();
+		break;
+	}
+	default:
+		throw std::runtime_error("LocalizationMap: unknown type of registration scan to map");
+	}
+}
+
+bool LocalizationMap::isGeneralizedIcp() const {
+	return params_.scanMatcher_.scanToMapRegType_ == ScanToMapRegistrationType::GeneralizedIcp;
+}
+
+void LocalizationMap::build(const PointCloud &map) {
+	Timer t("localization_map_build");
+	std::lock_guard<std::mutex> lck(mapMutex_);
+	map_ = map; // comes already voxelized, see SlamWrapper::setInitialMap
+	isBuilt_ = true;
+	// once on the whole map, the tiles copy them, hence points in the padding get the same covariance in every tile
+	if (isGeneralizedIcp() && !map_.HasCovariances()) {
+		map_.EstimateCovariances(
+				open3d::geometry::KDTreeSearchParamHybrid(params_.scanMatcher_.icp_.maxDistanceKnn_,
+						params_.scanMatcher_.icp_.knn_));
+	}
+
+	// assign each point to its tile and to the neighboring tiles whose padding it falls into
+	const Eigen::Vector3d padding = Eigen::Vector3d::Constant(params_.scanMatcher_.icp_.maxCorrespondenceDistance_);
+	std::unordered_map<Eigen::Vector3i, std::vector<size_t>, EigenVec3iHash> tileIdxs;
+	for (size_t i = 0; i < map_.points_.size(); ++i) {
+		const Eigen::Vector3d &p = map_.points_[i];
+		const Eigen::Vector3i lower = getVoxelIdx(p - padding, tileSize_);
+		const Eigen::Vector3i upper = getVoxelIdx(p + padding, tileSize_);
+		for (int x = lower.x(); x <= upper.x(); ++x) {
+			for (int y = lower.y(); y <= upper.y(); ++y) {
+				for (int z = lower.z(); z <= upper.z(); ++z) {
+					tileIdxs[Eigen::Vector3i(x, y, z)].push_back(i);
+				}
+			}
+		}
+	}
+
+	std::vector<Eigen::Vector3i> keys;
+	keys.reserve(tileIdxs.size());
+	tiles_.clear();
+	for (const auto &kv : tileIdxs) {
+		keys.push_back(kv.first);
+		tiles_[kv.first];
+	}
+
+#pragma omp parallel for schedule(dynamic)
+	for (int i = 0; i < static_cast<int>(keys.size()); ++i) {
+		Tile &tile = tiles_.at(keys[i]);
+		tile.cloud_ = *map_.SelectByIndex(tileIdxs.at(keys[i]));
+		tile.kdTree_ = std::make_shared<open3d::geometry::KDTreeFlann>(tile.cloud_);
+	}
+	std::cout << "Localization map: " << map_.points_.size() << " points in " << tiles_.size() << " tiles \n";
+}
+
+bool LocalizationMap::isBuilt() const {
+	std::lock_guard<std::mutex> lck(mapMutex_);
+	return isBuilt_;
+}
+
+bool LocalizationMap::isEmpty() const {
+	std::lock_guard<std::mutex> lck(mapMutex_);
+	return tiles_.empty();
+}
+
+size_t LocalizationMap::getNumTiles() const {
+	std::lock_guard<std::mutex> lck(mapMutex_);
+	return tiles_.size();
+}
+
+PointCloud LocalizationMap::getMapPointCloudCopy() const {
+	std::lock_guard<std::mutex> lck(mapMutex_);
+	return map_;
+}
+
+const LocalizationMap::Tile* LocalizationMap::findTile(const Eigen::Vector3d &p) const {
+	const auto it = tiles_.find(getVoxelIdx(p, tileSize_));
+	return it == tiles_.end() ? nullptr : &(it->second);
+}
+
+LocalizationMap::RegistrationResult LocalizationMap::registerScan(const PointCloud &scan,
+		const Transform &initialGuess) const {
+	std::lock_guard<std::mutex> lck(mapMutex_);
+	assert_nonNullptr(estimation_.get(), "LocalizationMap: parameters not set");
+	const double maxCorrespondenceDistance = params_.scanMatcher_.icp_.maxCorrespondenceDistance_;
+	const registration::ICPConvergenceCriteria criteria(1e-6, 1e-6, params_.scanMatcher_.icp_.maxNumIter_);
+	const bool isGicp = isGeneralizedIcp();
+	PointCloud source = scan;
+	if (isGicp && !source.HasCovariances()) {
+		source.EstimateCovariances(open3d::geometry::KDTreeSearchParamHybrid(params_.scanMatcher_.icp_.maxDistanceKnn_,
+						params_.scanMatcher_.icp_.knn_));
+	}
+
+	const int nPoints = source.points_.size();
+	std::vector<const Tile*> matchedTile(nPoints, nullptr);
+	std::vector<int> matchedIdx(nPoints, -1);
+	std::vector<double> matchedDistSq(nPoints, 0.0);
+	std::vector<Eigen::Vector3d> transformedPoints(nPoints);
+
+	Transform mapToRangeSensor = initialGuess;
+	RegistrationResult result(mapToRangeSensor.matrix());
+	PointCloud sourceMatched, targetMatched;
+	registration::CorrespondenceSet correspondences;
+	for (int iter = 0; iter <= criteria.max_iteration_; ++iter) {
+#pragma omp parallel
+		{
+			std::vector<int> idx(1);
+			std::vector<double> distSq(1);
+#pragma omp for schedule(static)
+			for (int i = 0; i < nPoints; ++i) {
+				const Eigen::Vector3d p = mapToRangeSensor * source.points_[i];
+				transformedPoints[i] = p;
+				const Tile *tile = findTile(p);
+				matchedTile[i] = nullptr;
+				if (tile != nullptr && tile->kdTree_->SearchHybrid(p, maxCorrespondenceDistance, 1, idx, distSq) > 0) {
+					matchedTile[i] = tile;
+					matchedIdx[i] = idx[0];
+					matchedDistSq[i] = distSq[0];
+				}
+			}
+		}
+
+		sourceMatched.Clear();
+		targetMatched.Clear();
+		correspondences.clear();
+		double errorSq = 0.0;
+		for (int i = 0; i < nPoints; ++i) {
+			if (matchedTile[i] == nullptr) {
+				continue;
+			}
+			const PointCloud &target = matchedTile[i]->cloud_;
+			const int k = correspondences.size();
+			correspondences.emplace_back(k, k);
+			errorSq += matchedDistSq[i];
+			sourceMatched.points_.push_back(transformedPoints[i]);
+			targetMatched.points_.push_back(target.points_[matchedIdx[i]]);
+			if (target.HasNormals()) {
+				targetMatched.normals_.push_back(target.normals_[matchedIdx[i]]);
+			}
+			if (isGicp) {
+				const Eigen::Matrix3d R = mapToRangeSensor.rotation();
+				sourceMatched.covariances_.push_back(R * source.covariances_[i] * R.transpose());
+				targetMatched.covariances_.push_back(target.covariances_[matchedIdx[i]]);
+			}
+		}
+
+		const double prevFitness = result.fitness_;
+		const double prevRmse = result.inlier_rmse_;
+		result.transformation_ = mapToRangeSensor.matrix();
+		result.fitness_ = nPoints > 0 ? static_cast<double>(correspondences.size()) / nPoints : 0.0;
+		result.inlier_rmse_ = correspondences.empty() ? 0.0 : std::sqrt(errorSq / correspondences.size());
+		if (iter == criteria.max_iteration_ || correspondences.empty()) {
+			break;
+		}
+		if (iter > 0 && std::abs(prevFitness - result.fitness_) < criteria.relative_fitness_
+				&& std::abs(prevRmse - result.inlier_rmse_) < criteria.relative_rmse_) {
+			break;
+		}
+		const Eigen::Matrix4d update = estimation_->ComputeTransformation(sourceMatched, targetMatched, correspondences);
+		mapToRangeSensor = Transform(update) * mapToRangeSensor;
+	}
+	return result;
+}
+
+} // namespace o3d_slam
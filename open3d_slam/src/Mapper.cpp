@@ -14,6 +14,8 @@
 #include "open3d_slam/assert.hpp"
 #include "open3d_slam/output.hpp"
 #include "open3d_slam/ScanToMapRegistration.hpp"
+#include "open3d_slam/LocalizationMap.hpp"
+#include "open3d_slam/Relocalization.hpp"
 
 #include "open3d/utility/Eigen.h"
 #include "open3d/utility/Helper.h"
@@ -54,6 +56,46 @@ bool Mapper::hasProcessedMeasurements() const {
 void Mapper::update(const MapperParameters &p) {
 	scan2MapReg_ = scanToMapRegistrationFactory(p);
 	submaps_->setParameters(p);
+	if (p.isUseInitialMap_ && !p.isMergeScansIntoMap_ && p.localizationMap_.isUseTiledMap_) {
+		if (localizationMap_ == nullptr) {
+			localizationMap_ = std::make_shared<LocalizationMap>();
+		}
+		localizationMap_->setParameters(p);
+	} else {
+		localizationMap_.reset();
+	}
+	const bool isMapLoaded = p.isUseInitialMap_ || !p.loadSessionFolderPath_.empty();
+	if (isMapLoaded && (p.relocalization_.isRelocalizeOnStartup_ || p.relocalization_.isRelocalizeWhenLost_)) {
+		if (relocalizer_ == nullptr) {
+			relocalizer_ = std::make_shared<Relocalizer>();
+		}
+		relocalizer_->setParameters(p);
+	} else {
+		relocalizer_.reset();
+		isRelocalizationNeeded_ = false;
+	}
+}
+
+bool Mapper::isUseLocalizationMap() const {
+	return localizationMap_ != nullptr;
+}
+
+bool Mapper::isRelocalizationNeeded() const {
+	return isRelocalizationNeeded_;
+}
+
+void Mapper::buildRelocalizationPlacesIfNeeded(const PointCloud &initialMap) {
+	if (relocalizer_ == nullptr) {
+		return;
+	}
+	if (relocalizer_->getNumPlaces() == 0) {
+		relocalizer_->buildPlaces(initialMap);
+	}
+	isRelocalizationNeeded_ = params_.relocalization_.isRelocalizeOnStartup_;
+}
+
+std::shared_ptr<Relocalizer> Mapper::getRelocalizer() const {
+	return relocalizer_;
 }
 
 Transform Mapper::getMapToOdom(const Time &timestamp) const {
@@ -85,6 +127,17 @@ SubmapCollection* Mapper::getSubmapsPtr() {
 void Mapper::setMapToRangeSensor(const Transform &t) {
 	mapToRangeSensor_ = t;
 }
+void Mapper::setScanResolution(const ScanResolution &resolution) {
+	params_.scanProcessing_.voxelSize_ = resolution.voxelSize_;
+	params_.scanProcessing_.downSamplingRatio_ = resolution.downSamplingRatio_;
+	if (params_.scanMatcher_.scanToMapRegType_ == ScanToMapRegistrationType::Ndt) {
+		params_.scanMatcher_.ndt_.maxNumIter_ = resolution.maxNumIter_;
+	} else {
+		params_.scanMatcher_.icp_.maxNumIter_ = resolution.maxNumIter_;
+	}
+	scan2MapReg_->setScanResolution(resolution);
+}
+
 void Mapper::setMapToRangeSensorInitial(const Transform &t){
 	mapToRangeSensorPrev_ = t;
 	mapToRangeSensor_ = t;
@@ -101,12 +154,40 @@ const ScanToMapRegistration &Mapper::getScanToMapRegistration() const{
 
 bool Mapper::addRangeMeasurement(const Mapper::PointCloud &rawScan, const Time &timestamp) {
 	submaps_->setMapToRangeSensor(mapToRangeSensor_);
+	isLastScanKeyframe_ = false;
+
+	if (isUseLocalizationMap() && !localizationMap_->isBuilt()) {
+		assert_true(scan2MapReg_->isMergeScanValid(rawScan),"Init map invalid!!!!");
+		localizationMap_->build(rawScan);
+		assert_true(!localizationMap_->isEmpty(), "Mapper: the initial map is empty");
+		buildRelocalizationPlacesIfNeeded(rawScan);
+		return true;
+	}
+
+	// the first scan after loading a session starts a new trajectory at the relocalized or the initial pose
+	if (!isUseLocalizationMap() && submaps_->isStartingNewTrajectory()) {
+		if (isRelocalizationNeeded_ && !isRelocalizationAttemptDue(timestamp)) {
+			return false;
+		}
+		const ProcessedScans processed = scan2MapReg_->processForScanMatchingAndMerging(rawScan, mapToRangeSensor_);
+		if (isRelocalizationNeeded_ && !relocalize(*processed.merge_, timestamp)) {
+			return false;
+		}
+		isNewInitialValueSet_ = false;
+		submaps_->insertScan(rawScan, *processed.merge_, mapToRangeSensor_, timestamp);
+		mapToRangeSensorPrev_ = mapToRangeSensor_;
+		mapToRangeSensorLastScanInsertion_ = mapToRangeSensor_;
+		mapToRangeSensorBuffer_.push(timestamp, mapToRangeSensor_);
+		lastMeasurementTimestamp_ = timestamp;
+		return true;
+	}
 
 	//insert first scan
-	if (submaps_->getActiveSubmap().isEmpty()) {
+	if (!isUseLocalizationMap() && submaps_->getActiveSubmap().isEmpty()) {
 		if (params_.isUseInitialMap_){
 			assert_true(scan2MapReg_->isMergeScanValid(rawScan),"Init map invalid!!!!");
 			submaps_->insertScan(rawScan, rawScan, Transform::Identity(), timestamp);
+			buildRelocalizationPlacesIfNeeded(rawScan);
 		} else {
 			const ProcessedScans processed = scan2MapReg_->processForScanMatchingAndMerging(rawScan, mapToRangeSensor_);
 			submaps_->insertScan(rawScan, *processed.merge_, Transform::Identity(), timestamp);
@@ -136,10 +217,36 @@ bool Mapper::addRangeMeasurement(const Mapper::PointCloud &rawScan, const Time &
 		const Transform odometryMotion = odomToRangeSensorPrev.inverse()*odomToRangeSensor;
 		mapToRangeSensorEstimate = mapToRangeSensorPrev_*odometryMotion ;
 	}
+	++keyframeStatistics_.numScans_;
+	if (isOdomOkay && !isNewInitialValueSet_ && !isIgnoreOdometryPrediction_ && !isRelocalizationNeeded_
+			&& !isKeyframe(mapToRangeSensorEstimate, timestamp)) {
+		// chain the odometry, neither refined nor merged into the map
+		mapToRangeSensor_ = mapToRangeSensorEstimate;
+		mapToRangeSensorBuffer_.push(timestamp, mapToRangeSensor_);
+		submaps_->setMapToRangeSensor(mapToRangeSensor_);
+		lastMeasurementTimestamp_ = timestamp;
+		mapToRangeSensorPrev_ = mapToRangeSensor_;
+		return true;
+	}
+	if (isRelocalizationNeeded_ && !isRelocalizationAttemptDue(timestamp)) {
+		return false;
+	}
 	isIgnoreOdometryPrediction_ = false;
+	isLastScanKeyframe_ = true;
 	const ProcessedScans processed = scan2MapReg_->processForScanMatchingAndMerging(rawScan, mapToRangeSensor_);
-	const RegistrationResult result = scan2MapReg_->scanToMapRegistration(*processed.match_, submaps_->getActiveSubmap(),
-			mapToRangeSensor_, mapToRangeSensorEstimate);
+	if (isRelocalizationNeeded_) {
+		if (!relocalize(*processed.merge_, timestamp)) {
+			return false;
+		}
+		mapToRangeSensorEstimate = mapToRangeSensor_;
+		isNewInitialValueSet_ = false;
+		numFailedRefinements_ = 0;
+	}
+	const RegistrationResult result =
+			isUseLocalizationMap() ?
+					localizationMap_->registerScan(*processed.match_, mapToRangeSensorEstimate) :
+					scan2MapReg_->scanToMapRegistration(*processed.match_, submaps_->getActiveSubmap(), mapToRangeSensor_,
+							mapToRangeSensorEstimate);
 	preProcessedScan_ = *processed.match_;
 	if (isNewInitialValueSet_){
 		mapToRangeSensorPrev_ = mapToRangeSensor_;
@@ -153,11 +260,25 @@ bool Mapper::addRangeMeasurement(const Mapper::PointCloud &rawScan, const Time &
 			std::cout << "Skipping the refinement step, fitness: " << result.fitness_ << std::endl;
 			std::cout << "preeIcp: " << asString(mapToRangeSensorEstimate) << "\n";
 			std::cout << "postIcp: " << asString(Transform(result.transformation_)) << "\n\n";
+			lastRefinementFitness_ = result.fitness_;
+			isForceKeyframe_ = true;
+			++numFailedRefinements_;
+			if (relocalizer_ != nullptr && params_.relocalization_.isRelocalizeWhenLost_
+					&& numFailedRefinements_ >= params_.relocalization_.numFailedRefinementsToBeLost_) {
+				std::cout << "Tracking lost after " << numFailedRefinements_ << " failed refinements, relocalizing \n";
+				isRelocalizationNeeded_ = true;
+			}
 			return false;
 	}
 
 	// update transforms
+	numFailedRefinements_ = 0;
+	isForceKeyframe_ = false;
 	mapToRangeSensor_.matrix() = result.transformation_;
+	mapToRangeSensorLastKeyframe_ = mapToRangeSensor_;
+	lastKeyframeTimestamp_ = timestamp;
+	lastRefinementFitness_ = result.fitness_;
+	++keyframeStatistics_.numKeyframes_;
 	mapToRangeSensorBuffer_.push(timestamp, mapToRangeSensor_);
 	submaps_->setMapToRangeSensor(mapToRangeSensor_);
 
@@ -181,15 +302,57 @@ bool Mapper::addRangeMeasurement(const Mapper::PointCloud &rawScan, const Time &
 	return true;
 }
 
+bool Mapper::isRelocalizationAttemptDue(const Time &timestamp) const {
+	return !isLastRelocalizationFailed_
+			|| toSeconds(timestamp - lastRelocalizationAttemptTimestamp_)
+					>= params_.relocalization_.minTimeBetweenAttempts_;
+}
+
+bool Mapper::relocalize(const PointCloud &scan, const Time &timestamp) {
+	lastRelocalizationAttemptTimestamp_ = timestamp;
+	Transform relocalizedPose;
+	isLastRelocalizationFailed_ = !relocalizer_->relocalize(scan, &relocalizedPose);
+	if (isLastRelocalizationFailed_) {
+		return false;
+	}
+	mapToRangeSensor_ = relocalizedPose;
+	isRelocalizationNeeded_ = false;
+	return true;
+}
+
+bool Mapper::isKeyframe(const Transform &mapToRangeSensorEstimate, const Time &timestamp) const {
+	const KeyframeParameters &p = params_.keyframes_;
+	if (!p.isEnabled_ || isForceKeyframe_ || lastRefinementFitness_ < p.minFitness_) {
+		return true;
+	}
+	const Transform motion = mapToRangeSensorLastKeyframe_.inverse() * mapToRangeSensorEstimate;
+	return motion.translation().norm() >= p.minDistance_
+			|| Eigen::AngleAxisd(motion.rotation()).angle() >= p.minRotation_
+			|| toSeconds(timestamp - lastKeyframeTimestamp_) >= p.maxTimeBetweenKeyframes_;
+}
+
+bool Mapper::isLastScanKeyframe() const {
+	return isLastScanKeyframe_;
+}
+
+KeyframeStatistics Mapper::getAndResetKeyframeStatistics() {
+	const KeyframeStatistics retVal = keyframeStatistics_;
+	keyframeStatistics_ = KeyframeStatistics();
+	return retVal;
+}
+
 Mapper::PointCloud Mapper::getAssembledMapPointCloud() const {
+	if (isUseLocalizationMap()) {
+		return localizationMap_->getMapPointCloudCopy();
+	}
 	PointCloud cloud;
 	const int nPoints = submaps_->getTotalNumPoints();
-	const Submap &activeSubmap = getActiveSubmap();
+	const PointCloud activeSubmapCloud = getActiveSubmap().getMapPointCloudCopy();
 	cloud.points_.reserve(nPoints);
-	if (activeSubmap.getMapPointCloud().HasColors()) {
+	if (activeSubmapCloud.HasColors()) {
 		cloud.colors_.reserve(nPoints);
 	}
-	if (activeSubmap.getMapPointCloud().HasNormals()) {
+	if (activeSubmapCloud.HasNormals()) {
 		cloud.normals_.reserve(nPoints);
 	}
 
@@ -209,11 +372,13 @@ Mapper::PointCloud Mapper::getAssembledMapPointCloud() const {
 }
 
 void Mapper::checkTransformChainingAndPrintResult(bool isCheckTransformChainingAndPrintResult) const {
-	if (isCheckTransformChainingAndPrintResult && odomToRangeSensorBuffer_.size() > 70 && mapToRangeSensorBuffer_.size() > 70) {
-		const auto odom1 = odomToRangeSensorBuffer_.latest_measurement(60).transform_;
-		const auto odom2 = odomToRangeSensorBuffer_.latest_measurement(20).transform_;
-		const auto start = mapToRangeSensorBuffer_.latest_measurement(60).transform_;
-		const auto gt = mapToRangeSensorBuffer_.latest_measurement(20).transform_;
+	const auto odomToRangeSensor = odomToRangeSensorBuffer_.snapshot();
+	const auto mapToRangeSensor = mapToRangeSensorBuffer_.snapshot();
+	if (isCheckTransformChainingAndPrintResult && odomToRangeSensor->size() > 70 && mapToRangeSensor->size() > 70) {
+		const auto odom1 = odomToRangeSensor->latest_measurement(60).transform_;
+		const auto odom2 = odomToRangeSensor->latest_measurement(20).transform_;
+		const auto start = mapToRangeSensor->latest_measurement(60).transform_;
+		const auto gt = mapToRangeSensor->latest_measurement(20).transform_;
 		const Transform mapMotion = start.inverse() * gt;
 		const Transform odomMotion = odom1.inverse() * odom2;
 		std::cout << "start      :  " << asString(start) << "\n";
@@ -21,6 +21,34 @@
 
 namespace o3d_slam {
 
+double computeScanPhase(double x, double y, bool isSpinningClockwise) {
+	const double angle = std::atan2(y, x);
+	const double angleWrapped = angle < 0.0 ? (angle + 2.0 * M_PI) : angle;
+	if (angleWrapped == 0.0) {
+		return 0.0;
+	}
+	const double phase = isSpinningClockwise ? 1.0 - angleWrapped / (2.0 * M_PI) : angleWrapped / (2.0 * M_PI);
+	assert_le(phase, 1.0, "phase should be   <= 1.0");
+	assert_ge(phase, 0.0, "phase should be   >= 0.0");
+	return phase;
+}
+
+void estimateConstantVelocity(const TransformBufferSnapshot &buffer, int numPoses, Eigen::Vector3d *linearVelocity,
+		Eigen::Vector3d *angularVelocityRpy) {
+	if (buffer.size() <= numPoses) {
+		linearVelocity->setZero();
+		angularVelocityRpy->setZero();
+		return;
+	}
+	const auto &finish = buffer.latest_measurement();
+	const auto &start = buffer.latest_measurement(numPoses);
+	const Transform dT = start.transform_.inverse() * finish.transform_;
+	const double dt = toSeconds(finish.time_ - start.time_);
+	assert_gt(dt, 0.0, "dt should be > 0!!!!");
+	*linearVelocity = dT.translation() / (dt + 1e-6);
+	*angularVelocityRpy = toRPY(Eigen::Quaterniond(dT.rotation()).normalized()) / (dt + 1e-6);
+}
+
 std::shared_ptr<PointCloud> MotionCompensation::undistortInputPointCloud(
 		const PointCloud &input, const Time &timestamp) {
 	std::shared_ptr<PointCloud> ret = std::make_shared<PointCloud>();
@@ -38,27 +66,15 @@ void ConstantVelocityMotionCompensation::estimateLinearAndAngularVelocity(
 		Eigen::Vector3d *angularVelocity) const {
 
 	const int offset = params_.numPosesVelocityEstimation_;
-	if (buffer_.size() <= offset) {
+	const auto buffer = buffer_.snapshot();
+	if (buffer->size() <= offset) {
 		linearVelocity->setZero();
 		angularVelocity->setZero();
 		return;
 	}
 
-	if (buffer_.latest_time() < timestamp) {
-
-		const auto finish = buffer_.latest_measurement();
-		const auto start = buffer_.latest_measurement(offset);
-
-		const Transform dT = start.transform_.inverse() * finish.transform_;
-		const double dt = toSeconds(finish.time_ - start.time_);
-		assert_gt(dt, 0.0, "dt should be > 0!!!!");
-//			std::cout << "dt " << dt << std::endl;
-		const Eigen::Vector3d linearVelocitySensor = dT.translation()
-				/ (dt + 1e-6);
-		const Eigen::Vector3d angularVelocitySensor = toRPY(
-				Eigen::Quaterniond(dT.rotation()).normalized()) / (dt + 1e-6);
-		*linearVelocity = linearVelocitySensor;
-		*angularVelocity = angularVelocitySensor;
+	if (buffer->latest_time() < timestamp) {
+		estimateConstantVelocity(*buffer, offset, linearVelocity, angularVelocity);
 	} else {
 		// todo handle this case!!!!!
 		std::cout << "Warning buffer has this already!!!! \n";
@@ -134,24 +150,7 @@ std::shared_ptr<PointCloud> ConstantVelocityMotionCompensation::undistortInputPo
 
 double ConstantVelocityMotionCompensation::computePhase(double x, double y) {
 	//this is now robosense specific
-	const double angle = std::atan2(y, x);
-	const double angleWrapped = angle < 0.0 ? (angle + 2.0 * M_PI) : angle;
-	if (angleWrapped == 0.0) {
-		return 0.0;
-	}
-	double phase = -5.0;
-
-	if (params_.isSpinningClockwise_){
-		phase = 1.0 - angleWrapped / (2.0 * M_PI);
-	} else {
-		phase = angleWrapped / (2.0 * M_PI);
-	}
-
-	assert_le(phase, 1.0, "phase should be   <= 1.0");
-	assert_ge(phase, 0.0, "phase should be   >= 0.0");
-//		std::cout << "point: " << p.x() << ", " << p.y() << " has phase: " <<  phase << std::endl;
-	return phase;
-
+	return computeScanPhase(x, y, params_.isSpinningClockwise_);
 }
 
 } // namespace o3d_slam
@@ -0,0 +1,151 @@
+/*
+ * OccupancyMap.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "open3d_slam/OccupancyMap.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <open3d/geometry/PointCloud.h>
+
+#ifdef open3d_slam_OPENMP_FOUND
+#include <omp.h>
+#endif
+
+namespace o3d_slam {
+
+namespace {
+float clamp(double value, double lower, double upper) {
+	return static_cast<float>(std::max(lower, std::min(upper, value)));
+}
+} // namespace
+
+OccupancyVoxelMap::OccupancyVoxelMap() :
+		BASE() {
+}
+
+OccupancyVoxelMap::OccupancyVoxelMap(const Eigen::Vector3d &voxelSize, const SpaceCarvingParameters &params) :
+		BASE(voxelSize), params_(params) {
+}
+
+void OccupancyVoxelMap::traverse(const Eigen::Vector3d &sensorPosition, const Eigen::Vector3d &p,
+		std::vector<Eigen::Vector3i> *missedKeys) const {
+	const double length = (p - sensorPosition).norm();
+	const double maxLength = std::min(length - params_.truncationDistance_, params_.maxRaytracingLength_);
+	if (maxLength <= 0.0) {
+		return;
+	}
+	const Eigen::Vector3d direction = (p - sensorPosition) / length;
+	const Eigen::Vector3i start = getKey(sensorPosition);
+	const Eigen::Vector3i delta = getKey(sensorPosition + maxLength * direction) - start;
+	// steps one face at a time between the voxel centers, the next crossing along axis i is at
+	// (2 * k_i + 1) / (2 * n_i) of the way after k_i steps, compared without division
+	Eigen::Vector3i step, n;
+	for (int i = 0; i < 3; ++i) {
+		step(i) = delta(i) > 0 ? 1 : (delta(i) < 0 ? -1 : 0);
+		n(i) = std::abs(delta(i));
+	}
+	int64 numerator[3] = { 1, 1, 1 };
+	Eigen::Vector3i key = start;
+	const int nSteps = n.sum();
+	for (int s = 0;; ++s) {
+		const auto search = voxels_.find(key);
+		if (search != voxels_.end() && search->second.lastUpdate_ != nScans_) {
+			const Eigen::Vector3f &normal = search->second.normal_;
+			if (normal.isZero() || std::abs(direction.cast<float>().dot(normal)) > params_.minDotProductWithNormal_) {
+				missedKeys->push_back(key);
+			}
+		}
+		if (s == nSteps) {
+			break;
+		}
+		int axis = -1;
+		for (int i = 0; i < 3; ++i) {
+			if (n(i) > 0 && (axis < 0 || numerator[i] * n(axis) < numerator[axis] * n(i))) {
+				axis = i;
+			}
+		}
+		key(axis) += step(axis);
+		numerator[axis] += 2;
+	}
+}
+
+void OccupancyVoxelMap::addPoint(const Eigen::Vector3d &p, size_t idx) {
+	const auto insertResult = voxels_.insert( { getKey(p), OccupancyVoxel() });
+	OccupancyVoxel &voxel = insertResult.first->second;
+	if (insertResult.second) {
+		const auto &o = params_.occupancy_;
+		voxel.logOdds_ = clamp(o.hitLogOdds_, o.minLogOdds_, o.maxLogOdds_);
+	}
+	voxel.pointIdxs_.push_back(idx);
+}
+
+void OccupancyVoxelMap::addPoints(const PointCloud &map, size_t startIdx) {
+	for (size_t i = startIdx; i < map.points_.size(); ++i) {
+		addPoint(map.points_[i], i);
+	}
+}
+
+void OccupancyVoxelMap::rebuildPoints(const PointCloud &map, const std::vector<bool> &isPointRemoved) {
+	for (auto &voxel : voxels_) {
+		voxel.second.pointIdxs_.clear();
+	}
+	for (size_t i = 0; i < map.points_.size(); ++i) {
+		if (i < isPointRemoved.size() && isPointRemoved[i]) {
+			continue;
+		}
+		addPoint(map.points_[i], i);
+	}
+}
+
+std::vector<size_t> OccupancyVoxelMap::insertScan(const PointCloud &scan, const Eigen::Vector3d &sensorPosition) {
+	const auto &p = params_.occupancy_;
+	++nScans_;
+	for (size_t i = 0; i < scan.points_.size(); ++i) {
+		auto &voxel = voxels_[getKey(scan.points_[i])];
+		if (voxel.lastUpdate_ == nScans_) {
+			continue;
+		}
+		voxel.lastUpdate_ = nScans_;
+		voxel.logOdds_ = clamp(voxel.logOdds_ + p.hitLogOdds_, p.minLogOdds_, p.maxLogOdds_);
+		if (scan.HasNormals()) {
+			voxel.normal_ = scan.normals_[i].normalized().cast<float>();
+		}
+	}
+
+	// traversal only reads the map, updates are applied afterwards once per voxel
+	std::vector<std::vector<Eigen::Vector3i>> missedKeys(1);
+#ifdef open3d_slam_OPENMP_FOUND
+	missedKeys.resize(omp_get_max_threads());
+#endif
+	const int nPoints = scan.points_.size();
+#pragma omp parallel for schedule(dynamic, 64)
+	for (int i = 0; i < nPoints; ++i) {
+		int threadId = 0;
+#ifdef open3d_slam_OPENMP_FOUND
+		threadId = omp_get_thread_num();
+#endif
+		traverse(sensorPosition, scan.points_[i], &missedKeys[threadId]);
+	}
+
+	std::vector<size_t> freedPointIdxs;
+	for (const auto &keys : missedKeys) {
+		for (const auto &key : keys) {
+			auto *voxel = getVoxelPtr(key);
+			if (voxel == nullptr || voxel->lastUpdate_ == nScans_) { // freed or already updated by another ray
+				continue;
+			}
+			voxel->lastUpdate_ = nScans_;
+			voxel->logOdds_ = clamp(voxel->logOdds_ + p.missLogOdds_, p.minLogOdds_, p.maxLogOdds_);
+			if (voxel->logOdds_ < p.removalLogOdds_) {
+				freedPointIdxs.insert(freedPointIdxs.end(), voxel->pointIdxs_.begin(), voxel->pointIdxs_.end());
+				removeKey(key);
+			}
+		}
+	}
+	return freedPointIdxs;
+}
+
+} // namespace o3d_slam
@@ -12,11 +12,37 @@
 #include "open3d_slam/time.hpp"
 #include "open3d_slam/output.hpp"
 #include "open3d_slam/CloudRegistration.hpp"
+#include "open3d_slam/LoamRegistration.hpp"
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 
 namespace o3d_slam {
 
+AdaptiveCorrespondenceDistance::AdaptiveCorrespondenceDistance(double initialDistance, double minDistance,
+		double maxRange, double minMotion) :
+		initialDistance_(initialDistance), minDistance_(minDistance), maxRange_(maxRange), minMotion_(minMotion) {
+}
+
+double AdaptiveCorrespondenceDistance::getDistance() const {
+	if (numSamples_ == 0) {
+		return initialDistance_;
+	}
+	return std::max(3.0 * std::sqrt(sumSquaredDeviations_ / numSamples_), minDistance_);
+}
+
+void AdaptiveCorrespondenceDistance::update(const Transform &predictionToRegistration) {
+	// largest displacement the deviation causes on a point within max range
+	const double angle = Eigen::AngleAxisd(predictionToRegistration.rotation()).angle();
+	const double deviation = 2.0 * maxRange_ * std::sin(0.5 * angle) + predictionToRegistration.translation().norm();
+	if (deviation < minMotion_) {
+		return;
+	}
+	sumSquaredDeviations_ += deviation * deviation;
+	++numSamples_;
+}
+
 LidarOdometry::LidarOdometry() {
 	cropper_ = std::make_shared<CroppingVolume>();
 	cloudRegistration_ = cloudRegistrationFactory(params_.scanMatcher_);
@@ -24,6 +50,9 @@ LidarOdometry::LidarOdometry() {
 
 PointCloudPtr LidarOdometry::preprocess(const PointCloud &in) const{
 	auto croppedCloud = cropper_->crop(in);
+	if (params_.scanMatcher_.regType_ == CloudRegistrationType::LoamFeatures) {
+		return extractLoamFeatures(*croppedCloud, params_.scanMatcher_.loam_); // needs the ring structure, no voxelization
+	}
 	o3d_slam::voxelize(params_.scanProcessing_.voxelSize_, croppedCloud.get());
 	cloudRegistration_->estimateNormalsOrCovariancesIfNeeded(croppedCloud.get());
 	return croppedCloud->RandomDownSample(params_.scanProcessing_.downSamplingRatio_);
@@ -45,16 +74,23 @@ bool LidarOdometry::addRangeScan(const open3d::geometry::PointCloud &cloud, cons
 
 	const o3d_slam::Timer timer;
 	auto preProcessed = preprocess(cloud);
-	const auto result = cloudRegistration_->registerClouds(cloudPrev_,*preProcessed, Transform::Identity());
+	// constant velocity, the early exit stops sooner the closer the initial guess is
+	const Transform initialGuess = lastRegistration_;
+	if (adaptiveCorrespondenceDistance_ != nullptr) {
+		cloudRegistration_->setMaxCorrespondenceDistance(adaptiveCorrespondenceDistance_->getDistance());
+	}
+	const auto result = cloudRegistration_->registerClouds(cloudPrev_,*preProcessed, initialGuess);
 
-	//todo magic
-	const bool isOdomOkay = result.fitness_ > 0.1;
+	const bool isOdomOkay = result.fitness_ > params_.minFitness_;
 	if (!isOdomOkay) {
 		  std::cout << "Odometry failed!!!!! \n";
 			std::cout << "Size of the odom buffer: " << odomToRangeSensorBuffer_.size() << std::endl;
 			std::cout << "Scan matching time elapsed: " << timer.elapsedMsec() << " msec \n";
 			std::cout << "Fitness: " << result.fitness_ << "\n";
 			std::cout << "RMSE: " << result.inlier_rmse_ << "\n";
+			if (adaptiveCorrespondenceDistance_ != nullptr) {
+				std::cout << "Correspondence distance: " << adaptiveCorrespondenceDistance_->getDistance() << "\n";
+			}
 			std::cout << "Transform: \n" << asString(Transform(result.transformation_)) << "\n";
 			std::cout << "target size: " << cloud.points_.size() << std::endl;
 			std::cout << "reference size: " << cloudPrev_.points_.size() << std::endl;
@@ -62,9 +98,15 @@ bool LidarOdometry::addRangeScan(const open3d::geometry::PointCloud &cloud, cons
 		if (!preProcessed->IsEmpty()){
 			cloudPrev_ = std::move(*preProcessed);
 		}
+		lastRegistration_ = Transform::Identity();
 		return isOdomOkay;
 	}
 
+	lastRegistration_ = Transform(result.transformation_);
+	if (adaptiveCorrespondenceDistance_ != nullptr) {
+		adaptiveCorrespondenceDistance_->update(initialGuess.inverse() * lastRegistration_);
+	}
+
 	if (isInitialTransformSet_){
 		odomToRangeSensorCumulative_.matrix() = initialTransform_;
 		isInitialTransformSet_ = false;
@@ -97,9 +139,23 @@ void LidarOdometry::setParameters(const OdometryParameters &p) {
 	params_ = p;
 	cropper_ = croppingVolumeFactory(params_.scanProcessing_.cropper_);
 	cloudRegistration_ = cloudRegistrationFactory(params_.scanMatcher_);
+	adaptiveCorrespondenceDistance_.reset();
+	if (params_.adaptiveCorrespondenceDistance_.isEnabled_) {
+		adaptiveCorrespondenceDistance_ = std::make_shared<AdaptiveCorrespondenceDistance>(
+				params_.scanMatcher_.icp_.maxCorrespondenceDistance_, params_.scanProcessing_.voxelSize_,
+				params_.scanProcessing_.cropper_.croppingMaxRadius_, params_.adaptiveCorrespondenceDistance_.minMotion_);
+	}
+	lastRegistration_ = Transform::Identity();
 }
 
 
+void LidarOdometry::setScanResolution(const ScanResolution &resolution) {
+	params_.scanProcessing_.voxelSize_ = resolution.voxelSize_;
+	params_.scanProcessing_.downSamplingRatio_ = resolution.downSamplingRatio_;
+	params_.scanMatcher_.icp_.maxNumIter_ = resolution.maxNumIter_;
+	cloudRegistration_->setMaxNumIterations(resolution.maxNumIter_);
+}
+
 void LidarOdometry::setInitialTransform(const Eigen::Matrix4d &initialTransform) {
 	//todo decide what to do
 	// if I uncomment stuff below the odom jumps but starts from the pose you specified
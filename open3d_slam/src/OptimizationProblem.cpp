@@ -150,8 +150,35 @@ void OptimizationProblem::dumpToFile(const std::string &filename) const {
 }
 
 void OptimizationProblem::loadFromFile(const std::string &filename) {
-	open3d::io::ReadPoseGraph(filename, poseGraph_);
+	std::lock_guard<std::mutex> lck(optimizationMutex_);
+	std::lock_guard<std::mutex> lck2(constraintMutex_);
+	if (!open3d::io::ReadPoseGraph(filename, poseGraph_)) {
+		throw std::runtime_error("OptimizationProblem: could not read the pose graph from: " + filename);
+	}
+	odometryConstraints_.clear();
+	loopClosureConstraints_.clear();
+	for (const auto &edge : poseGraph_.edges_) {
+		Constraint c;
+		c.sourceSubmapIdx_ = edge.source_node_id_;
+		c.targetSubmapIdx_ = edge.target_node_id_;
+		c.sourceToTarget_ = Transform(edge.transformation_);
+		c.informationMatrix_ = edge.information_;
+		c.isInformationMatrixValid_ = true;
+		c.isOdometryConstraint_ = !edge.uncertain_;
+		if (c.isOdometryConstraint_) {
+			odometryConstraints_.push_back(c);
+		} else {
+			loopClosureConstraints_.push_back(c);
+		}
+	}
+	// the saved submaps already have the optimized poses applied, hence the loaded graph starts from identity
+	registration::PoseGraphNode prototypeNode;
+	prototypeNode.pose_ = Eigen::Matrix4d::Identity();
+	poseGraph_.nodes_.assign(odometryConstraints_.size() + 1, prototypeNode);
 	poseGraphOptimized_ = poseGraph_;
+	poseGraphNonOptimized_ = poseGraph_;
+	numOdometryEdgesPrev_ = odometryConstraints_.size();
+	numLoopClosuresPrev_ = loopClosureConstraints_.size();
 }
 
 void OptimizationProblem::clearOdometryConstraints() {
@@ -213,6 +240,10 @@ const Constraints& OptimizationProblem::getLoopClosureConstraints() const {
 	return loopClosureConstraints_;
 }
 
+const Constraints& OptimizationProblem::getOdometryConstraints() const {
+	return odometryConstraints_;
+}
+
 void OptimizationProblem::updateLoopClosureConstraint(size_t idx, const Constraint &c) {
 	loopClosureConstraints_.at(idx) = c;
 }
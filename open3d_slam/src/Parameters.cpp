@@ -6,6 +6,7 @@
  */
 
 #include "open3d_slam/Parameters.hpp"
+#include "open3d_slam/math.hpp"
 
 namespace o3d_slam {
 
@@ -19,6 +20,16 @@ void loadIfKeyDefined(const YAML::Node &node, const std::string &key, Ret *value
 	}
 }
 
+// x, y, z in meters and roll, pitch, yaw in degrees
+void loadExtrinsics(const YAML::Node &e, Eigen::Isometry3d *T) {
+	const Eigen::Vector3d xyz(e["x"].as<double>(), e["y"].as<double>(), e["z"].as<double>());
+	const Eigen::Vector3d rpy = params_internal::kDegToRad
+			* Eigen::Vector3d(e["roll"].as<double>(), e["pitch"].as<double>(), e["yaw"].as<double>());
+	T->setIdentity();
+	T->translation() = xyz;
+	T->linear() = fromRPY(rpy).normalized().toRotationMatrix();
+}
+
 } //namespace
 
 
@@ -41,6 +52,100 @@ void loadParameters(const YAML::Node& node, ConstantVelocityMotionCompensationPa
 	p->numPosesVelocityEstimation_ = node["num_poses_vel_estimation"].as<int>();
 }
 
+void loadParameters(const std::string &filename, PoseExtrapolationParameters *p){
+	YAML::Node basenode = YAML::LoadFile(filename);
+	if (basenode.IsNull()) {
+		throw std::runtime_error("PoseExtrapolationParameters::loadParameters loading failed");
+	}
+	if (!basenode["pose_extrapolation"].IsDefined()){
+		std::cout << "pose_extrapolation not defined \n";
+		return;
+	}
+	loadParameters(basenode["pose_extrapolation"], p);
+}
+
+void loadParameters(const std::string &filename, RangeDataFusionParameters *p){
+	YAML::Node basenode = YAML::LoadFile(filename);
+	if (basenode.IsNull()) {
+		throw std::runtime_error("RangeDataFusionParameters::loadParameters loading failed");
+	}
+	if (!basenode["range_data_fusion"].IsDefined()){
+		return;
+	}
+	loadParameters(basenode["range_data_fusion"], p);
+}
+
+void loadParameters(const YAML::Node& node, RangeDataFusionParameters* p) {
+	loadIfKeyDefined<double>(node, "max_time_difference", &p->maxTimeDifference_);
+	loadIfKeyDefined<bool>(node, "is_undistort_lidars", &p->isUndistortLidars_);
+	loadIfKeyDefined<int>(node, "num_poses_vel_estimation", &p->numPosesVelocityEstimation_);
+	p->lidars_.clear();
+	for (const auto &lidarNode : node["lidars"]) {
+		LidarFusionParameters lidar;
+		loadParameters(lidarNode, &lidar);
+		p->lidars_.push_back(lidar);
+	}
+}
+
+void loadParameters(const std::string &filename, RangeImageParameters *p){
+	YAML::Node basenode = YAML::LoadFile(filename);
+	if (basenode.IsNull()) {
+		throw std::runtime_error("RangeImageParameters::loadParameters loading failed");
+	}
+	if (!basenode["range_image"].IsDefined()){
+		return;
+	}
+	loadParameters(basenode["range_image"], p);
+}
+
+void loadParameters(const YAML::Node& node, RangeImageParameters* p) {
+	loadIfKeyDefined<bool>(node, "is_use_range_image", &p->isUseRangeImage_);
+	loadIfKeyDefined<int>(node, "num_columns", &p->numColumns_);
+	loadIfKeyDefined<int>(node, "num_rings", &p->numRings_);
+	loadIfKeyDefined<double>(node, "min_elevation", &p->minElevation_);
+	loadIfKeyDefined<double>(node, "max_elevation", &p->maxElevation_);
+	loadIfKeyDefined<int>(node, "ring_step", &p->ringStep_);
+	loadIfKeyDefined<int>(node, "column_step", &p->columnStep_);
+	loadIfKeyDefined<bool>(node, "is_estimate_normals", &p->isEstimateNormals_);
+	loadIfKeyDefined<int>(node, "normal_estimation_half_window", &p->normalEstimationHalfWindow_);
+	loadIfKeyDefined<double>(node, "max_neighbour_distance", &p->maxNeighbourDistance_);
+	loadIfKeyDefined<double>(node, "max_ground_angle", &p->maxGroundAngle_);
+	loadIfKeyDefined<double>(node, "edge_curvature_threshold", &p->edgeCurvatureThreshold_);
+	loadIfKeyDefined<double>(node, "planar_curvature_threshold", &p->planarCurvatureThreshold_);
+}
+
+void loadParameters(const std::string &filename, ThreadingParameters *p){
+	YAML::Node basenode = YAML::LoadFile(filename);
+	if (basenode.IsNull()) {
+		throw std::runtime_error("ThreadingParameters::loadParameters loading failed");
+	}
+	if (!basenode["threading"].IsDefined()){
+		return;
+	}
+	loadParameters(basenode["threading"], p);
+}
+
+void loadParameters(const YAML::Node& node, ThreadingParameters* p) {
+	loadIfKeyDefined<int>(node, "num_threads", &p->numThreads_);
+	loadIfKeyDefined<int>(node, "num_omp_threads", &p->numOmpThreads_);
+	loadIfKeyDefined<std::vector<int>>(node, "cpu_affinity", &p->cpuAffinity_);
+	loadIfKeyDefined<bool>(node, "is_set_thread_priorities", &p->isSetThreadPriorities_);
+}
+
+void loadParameters(const YAML::Node& node, LidarFusionParameters* p) {
+	p->topic_ = node["topic"].as<std::string>();
+	loadIfKeyDefined<bool>(node, "is_spinning_clockwise", &p->isSpinningClockwise_);
+	loadIfKeyDefined<double>(node, "scan_duration", &p->scanDuration_);
+	if (node["extrinsics"].IsDefined()) {
+		loadExtrinsics(node["extrinsics"], &p->rangeSensorToLidar_);
+	}
+}
+
+void loadParameters(const YAML::Node& node, PoseExtrapolationParameters* p) {
+	loadIfKeyDefined<int>(node, "num_poses_vel_estimation", &p->numPosesVelocityEstimation_);
+	loadIfKeyDefined<double>(node, "max_extrapolation_time", &p->maxExtrapolationTime_);
+}
+
 void loadParameters(const std::string &filename, SavingParameters *p){
 	YAML::Node basenode = YAML::LoadFile(filename);
 	if (basenode.IsNull()) {
@@ -60,6 +165,8 @@ void loadParameters(const YAML::Node &node, SavingParameters *p) {
 	if (node["save_dense_submaps"].IsDefined()){
 		p->isSaveDenseSubmaps_ = node["save_dense_submaps"].as<bool>();
 	}
+	loadIfKeyDefined<bool>(node, "save_session", &p->isSaveSession_);
+	loadIfKeyDefined<bool>(node, "save_meshes", &p->isSaveMeshes_);
 }
 
 void loadParameters(const YAML::Node &node, PlaceRecognitionConsistencyCheckParameters *p){
@@ -124,13 +231,32 @@ void loadParameters(const YAML::Node &n, IcpParameters *p) {
 	p->maxCorrespondenceDistance_ = n["max_correspondence_dist"].as<double>();
 	p->maxNumIter_ = n["max_n_iter"].as<int>();
 	loadIfKeyDefined<double>(n, "max_distance_knn", &p->maxDistanceKnn_);
+	loadIfKeyDefined<double>(n, "relative_fitness", &p->relativeFitness_);
+	loadIfKeyDefined<double>(n, "relative_rmse", &p->relativeRmse_);
 }
 
 void loadParameters(const YAML::Node &node, CloudRegistrationParameters *p){
 	const std::string regTypeName = node["cloud_registration_type"].as<std::string>();
 	p->regType_ = CloudRegistrationStringToEnumMap.at(regTypeName);
 	loadParameters(node["icp_parameters"], &p->icp_);
+	if (node["loam_parameters"].IsDefined()) {
+		loadParameters(node["loam_parameters"], &p->loam_);
+	}
+}
 
+void loadParameters(const YAML::Node &node, LoamParameters *p){
+	loadIfKeyDefined<int>(node, "num_rings", &p->numRings_);
+	loadIfKeyDefined<double>(node, "min_elevation", &p->minElevation_);
+	loadIfKeyDefined<double>(node, "max_elevation", &p->maxElevation_);
+	loadIfKeyDefined<int>(node, "num_columns", &p->numColumns_);
+	loadIfKeyDefined<int>(node, "num_sectors", &p->numSectors_);
+	loadIfKeyDefined<int>(node, "max_num_edges_per_sector", &p->maxNumEdgesPerSector_);
+	loadIfKeyDefined<int>(node, "max_num_planars_per_sector", &p->maxNumPlanarsPerSector_);
+	loadIfKeyDefined<double>(node, "edge_curvature_threshold", &p->edgeCurvatureThreshold_);
+	loadIfKeyDefined<double>(node, "planar_curvature_threshold", &p->planarCurvatureThreshold_);
+	if (node["lidar_extrinsics"].IsDefined()) {
+		loadExtrinsics(node["lidar_extrinsics"], &p->rangeSensorToLidar_);
+	}
 }
 
 void loadParameters(const std::string &filename, OdometryParameters *p){
@@ -148,6 +274,27 @@ void loadParameters(const YAML::Node &node, OdometryParameters *p){
 	loadParameters(node["scan_matching"], &(p->scanMatcher_) );
 	loadParameters(node["scan_processing"], &(p->scanProcessing_) );
 	loadIfKeyDefined<bool>(node,"is_publish_odometry_msgs", &p->isPublishOdometryMsgs_);
+	loadIfKeyDefined<double>(node,"min_fitness", &p->minFitness_);
+	if (node["adaptive_correspondence_distance"].IsDefined()) {
+		loadParameters(node["adaptive_correspondence_distance"], &p->adaptiveCorrespondenceDistance_);
+	}
+	if (node["adaptive_resolution"].IsDefined()) {
+		loadParameters(node["adaptive_resolution"], &p->adaptiveResolution_);
+	}
+}
+
+void loadParameters(const YAML::Node &node, AdaptiveResolutionParameters *p){
+	loadIfKeyDefined<bool>(node, "is_enabled", &p->isEnabled_);
+	loadIfKeyDefined<double>(node, "target_latency_msec", &p->targetLatencyMsec_);
+	loadIfKeyDefined<size_t>(node, "max_queue_size", &p->maxQueueSize_);
+	loadIfKeyDefined<double>(node, "max_voxel_size", &p->maxVoxelSize_);
+	loadIfKeyDefined<double>(node, "min_downsampling_ratio", &p->minDownSamplingRatio_);
+	loadIfKeyDefined<int>(node, "min_n_iter", &p->minNumIter_);
+}
+
+void loadParameters(const YAML::Node &node, AdaptiveCorrespondenceDistanceParameters *p){
+	loadIfKeyDefined<bool>(node, "is_enabled", &p->isEnabled_);
+	loadIfKeyDefined<double>(node, "min_motion", &p->minMotion_);
 }
 
 void loadParameters(const YAML::Node &node, ScanProcessingParameters *p){
@@ -199,6 +346,8 @@ void loadParameters(const YAML::Node &node, MapperParameters *p) {
 	p->isRefineOdometryConstraintsBetweenSubmaps_ = node["is_refine_odometry_constraints_between_submaps"].as<bool>();
 	p->isUseInitialMap_ = node["is_use_map_initialization"].as<bool>();
 	p->isMergeScansIntoMap_ = node["is_merge_scans_into_map"].as<bool>();
+	loadIfKeyDefined<bool>(node, "is_cache_initial_map", &p->isCacheInitialMap_);
+	loadIfKeyDefined<std::string>(node, "load_session_folder_path", &p->loadSessionFolderPath_);
 	loadParameters(node["scan_to_map_refinement"],&(p->scanMatcher_));
 	loadParameters(node["scan_to_map_refinement"]["scan_processing"], &(p->scanProcessing_));
 
@@ -213,6 +362,61 @@ void loadParameters(const YAML::Node &node, MapperParameters *p) {
 		std::cout << "Using submap size as loop closure serach radius! \n";
 		p->placeRecognition_.loopClosureSearchRadius_ = p->submaps_.radius_; // default value
 	}
+	if (node["localization_map"].IsDefined()) {
+		loadParameters(node["localization_map"], &(p->localizationMap_));
+	}
+	if (node["relocalization"].IsDefined()) {
+		loadParameters(node["relocalization"], &(p->relocalization_));
+	}
+	if (node["keyframes"].IsDefined()) {
+		loadParameters(node["keyframes"], &(p->keyframes_));
+	}
+	if (node["adaptive_resolution"].IsDefined()) {
+		loadParameters(node["adaptive_resolution"], &(p->adaptiveResolution_));
+	}
+	if (node["compact_storage"].IsDefined()) {
+		loadParameters(node["compact_storage"], &(p->compactStorage_));
+	}
+	if (node["meshing"].IsDefined()) {
+		loadParameters(node["meshing"], &(p->meshing_));
+	}
+}
+
+void loadParameters(const YAML::Node &node, MeshingParameters *p){
+	loadIfKeyDefined<bool>(node, "is_enabled", &p->isEnabled_);
+	loadIfKeyDefined<double>(node, "voxel_size", &p->voxelSize_);
+	loadIfKeyDefined<double>(node, "truncation_distance_ratio", &p->truncationDistanceRatio_);
+	loadIfKeyDefined<int>(node, "knn_normal_estimation", &p->knnNormalEstimation_);
+}
+
+void loadParameters(const YAML::Node &node, CompactStorageParameters *p){
+	loadIfKeyDefined<bool>(node, "is_enabled", &p->isEnabled_);
+	loadIfKeyDefined<double>(node, "resolution_ratio", &p->resolutionRatio_);
+}
+
+void loadParameters(const YAML::Node &node, KeyframeParameters *p){
+	loadIfKeyDefined<bool>(node, "is_enabled", &p->isEnabled_);
+	loadIfKeyDefined<double>(node, "min_distance", &p->minDistance_);
+	if (node["min_rotation"].IsDefined()) {
+		p->minRotation_ = node["min_rotation"].as<double>() * params_internal::kDegToRad;
+	}
+	loadIfKeyDefined<double>(node, "max_time_between_keyframes", &p->maxTimeBetweenKeyframes_);
+	loadIfKeyDefined<double>(node, "min_fitness", &p->minFitness_);
+}
+
+void loadParameters(const YAML::Node &node, LocalizationMapParameters *p){
+	loadIfKeyDefined<bool>(node, "is_use_tiled_map", &p->isUseTiledMap_);
+	loadIfKeyDefined<double>(node, "tile_size", &p->tileSize_);
+}
+
+void loadParameters(const YAML::Node &node, RelocalizationParameters *p){
+	loadIfKeyDefined<bool>(node, "is_relocalize_on_startup", &p->isRelocalizeOnStartup_);
+	loadIfKeyDefined<bool>(node, "is_relocalize_when_lost", &p->isRelocalizeWhenLost_);
+	loadIfKeyDefined<size_t>(node, "num_failed_refinements_to_be_lost", &p->numFailedRefinementsToBeLost_);
+	loadIfKeyDefined<double>(node, "place_size", &p->placeSize_);
+	loadIfKeyDefined<double>(node, "place_padding_ratio", &p->placePaddingRatio_);
+	loadIfKeyDefined<double>(node, "min_refinement_fitness", &p->minRefinementFitness_);
+	loadIfKeyDefined<double>(node, "min_time_between_attempts", &p->minTimeBetweenAttempts_);
 }
 
 void loadParameters(const YAML::Node &node, ScanToMapRegistrationParameters *p){
@@ -220,6 +424,15 @@ void loadParameters(const YAML::Node &node, ScanToMapRegistrationParameters *p){
 	p->scanToMapRegType_ = ScanToMapRegistrationStringToEnumMap.at(regTypeName);
 	p->minRefinementFitness_ = node["min_refinement_fitness"].as<double>();
 	loadParameters(node["icp_parameters"], &p->icp_);
+	if (node["ndt_parameters"].IsDefined()) {
+		loadParameters(node["ndt_parameters"], &p->ndt_);
+	}
+}
+
+void loadParameters(const YAML::Node &node, NdtParameters *p){
+	loadIfKeyDefined<double>(node, "voxel_size", &p->voxelSize_);
+	loadIfKeyDefined<int>(node, "min_num_points_per_voxel", &p->minNumPointsPerVoxel_);
+	loadIfKeyDefined<int>(node, "max_n_iter", &p->maxNumIter_);
 }
 
 void loadParameters(const YAML::Node &node, SpaceCarvingParameters *p){
@@ -233,6 +446,19 @@ void loadParameters(const YAML::Node &node, SpaceCarvingParameters *p){
 	p->truncationDistance_ = node["truncation_distance"].as<double>();
 	p->carveSpaceEveryNscans_ = node["carve_space_every_n_scans"].as<int>();
 	p->minDotProductWithNormal_ = node["min_dot_product_with_normal"].as<double>();
+	if (node["occupancy"].IsDefined()) {
+		loadParameters(node["occupancy"], &p->occupancy_);
+	}
+	loadIfKeyDefined<bool>(node, "is_keep_carved_points_for_debugging", &p->isKeepCarvedPointsForDebugging_);
+}
+
+void loadParameters(const YAML::Node &node, OccupancyParameters *p){
+	loadIfKeyDefined<bool>(node, "is_enabled", &p->isEnabled_);
+	loadIfKeyDefined<double>(node, "hit_log_odds", &p->hitLogOdds_);
+	loadIfKeyDefined<double>(node, "miss_log_odds", &p->missLogOdds_);
+	loadIfKeyDefined<double>(node, "min_log_odds", &p->minLogOdds_);
+	loadIfKeyDefined<double>(node, "max_log_odds", &p->maxLogOdds_);
+	loadIfKeyDefined<double>(node, "removal_log_odds", &p->removalLogOdds_);
 }
 
 } // namespace o3d_slam
@@ -249,7 +249,9 @@ std::vector<size_t> PlaceRecognition::getLoopClosureCandidatesIdxs(const Transfo
 			continue;
 		}
 
-		const bool isAdjacent = std::abs<int>(i - lastFinishedSubmapIdx) == 1
+		// consecutive idxs are only close in time within the same trajectory
+		const bool isSameTrajectory = submapCollection.isSameTrajectory(i, lastFinishedSubmapIdx);
+		const bool isAdjacent = (isSameTrajectory && std::abs<int>(i - lastFinishedSubmapIdx) == 1)
 				|| adjMatrix.isAdjacent(i, lastFinishedSubmapIdx);
 		if (isAdjacent){
 //			std::cout << "Skipping the loop closure of " << matchingSubmapsString
@@ -268,7 +270,7 @@ std::vector<size_t> PlaceRecognition::getLoopClosureCandidatesIdxs(const Transfo
 		}
 
 		const int consecutiveThreshold = (int) std::ceil(maxDistance / params_.submaps_.radius_);
-		const bool isConsecutive = std::abs<int>(i - lastFinishedSubmapIdx) <= consecutiveThreshold;
+		const bool isConsecutive = isSameTrajectory && std::abs<int>(i - lastFinishedSubmapIdx) <= consecutiveThreshold;
 		if (isConsecutive) {
 			continue;
 		}
@@ -0,0 +1,69 @@
+/*
+ * PoseExtrapolator.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "open3d_slam/PoseExtrapolator.hpp"
+#include "open3d_slam/assert.hpp"
+
+#include <algorithm>
+
+namespace o3d_slam {
+
+PoseExtrapolator::PoseExtrapolator(const TransformInterpolationBuffer &odomToRangeSensorBuffer,
+		const TransformInterpolationBuffer &mapToRangeSensorBuffer) :
+		odomToRangeSensorBuffer_(odomToRangeSensorBuffer), mapToRangeSensorBuffer_(mapToRangeSensorBuffer) {
+}
+
+void PoseExtrapolator::setParameters(const PoseExtrapolationParameters &p) {
+	assert_gt(p.numPosesVelocityEstimation_, 0, "pose extrapolation num poses for velocity estimation: ");
+	assert_ge(p.maxExtrapolationTime_, 0.0, "pose extrapolation max extrapolation time: ");
+	params_ = p;
+}
+
+bool PoseExtrapolator::isReady() const {
+	return !mapToRangeSensorBuffer_.empty();
+}
+
+Transform PoseExtrapolator::extrapolateMapToRangeSensor(const Time &queryTime) const {
+	const auto mapToRangeSensor = mapToRangeSensorBuffer_.snapshot();
+	if (mapToRangeSensor->empty()) {
+		throw std::runtime_error("PoseExtrapolator:: no scan to map poses available yet");
+	}
+	const TimestampedTransform &latestRefined = mapToRangeSensor->latest_measurement();
+	if (queryTime <= latestRefined.time_) {
+		return mapToRangeSensor->lookupClamped(queryTime);
+	}
+	const auto odomToRangeSensor = odomToRangeSensorBuffer_.snapshot();
+	if (odomToRangeSensor->empty()) {
+		return extrapolate(*mapToRangeSensor, queryTime);
+	}
+	const Transform odomMotion = odomToRangeSensor->lookupClamped(latestRefined.time_).inverse()
+			* extrapolate(*odomToRangeSensor, queryTime);
+	return latestRefined.transform_ * odomMotion;
+}
+
+Transform PoseExtrapolator::extrapolate(const TransformBufferSnapshot &buffer, const Time &queryTime) const {
+	const TimestampedTransform &finish = buffer.latest_measurement();
+	if (queryTime <= finish.time_ || buffer.size() < 2) {
+		return buffer.lookupClamped(queryTime);
+	}
+	const int offset = std::min<int>(params_.numPosesVelocityEstimation_, buffer.size() - 1);
+	const TimestampedTransform &start = buffer.latest_measurement(offset);
+	const double dt = toSeconds(finish.time_ - start.time_);
+	if (dt <= 0.0) {
+		return finish.transform_;
+	}
+	const double horizon = std::min(toSeconds(queryTime - finish.time_), params_.maxExtrapolationTime_);
+	const double scale = horizon / dt;
+
+	// constant body frame twist over the velocity estimation window
+	const Transform dT = start.transform_.inverse() * finish.transform_;
+	const Eigen::AngleAxisd dR(dT.rotation());
+	Transform increment(Eigen::AngleAxisd(dR.angle() * scale, dR.axis()));
+	increment.translation() = dT.translation() * scale;
+	return finish.transform_ * increment;
+}
+
+} // namespace o3d_slam
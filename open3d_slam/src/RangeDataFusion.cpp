@@ -0,0 +1,193 @@
+/*
+ * RangeDataFusion.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "open3d_slam/RangeDataFusion.hpp"
+#include "open3d_slam/MotionCompensation.hpp"
+#include "open3d_slam/assert.hpp"
+#include "open3d_slam/math.hpp"
+
+#include <cmath>
+#include <iostream>
+
+#ifdef open3d_slam_OPENMP_FOUND
+#include <omp.h>
+#endif
+
+namespace o3d_slam {
+
+namespace {
+const size_t kMaxBufferedCloudsPerLidar = 10;
+const size_t kMaxPendingReferenceClouds = 2; // don't wait for a lidar that stopped publishing
+
+Transform constantVelocityMotion(const Eigen::Vector3d &linearVelocity, const Eigen::Vector3d &angularVelocityRpy,
+		double dt) {
+	return makeTransform(dt * linearVelocity, fromRPY(dt * angularVelocityRpy).normalized());
+}
+
+void transformPoints(const Transform &T, const std::vector<Eigen::Vector3d> &in, Eigen::Vector3d *out) {
+	const Eigen::Map<const Eigen::Matrix3Xd> src(in.front().data(), 3, in.size());
+	Eigen::Map<Eigen::Matrix3Xd> dst(out->data(), 3, in.size());
+	dst.noalias() = T.linear() * src;
+	dst.colwise() += T.translation();
+}
+
+void rotateVectors(const Eigen::Matrix3d &R, const std::vector<Eigen::Vector3d> &in, Eigen::Vector3d *out) {
+	const Eigen::Map<const Eigen::Matrix3Xd> src(in.front().data(), 3, in.size());
+	Eigen::Map<Eigen::Matrix3Xd> dst(out->data(), 3, in.size());
+	dst.noalias() = R * src;
+}
+
+} // namespace
+
+RangeDataFusion::RangeDataFusion(const TransformInterpolationBuffer &odometryBuffer) :
+		odometryBuffer_(odometryBuffer) {
+}
+
+void RangeDataFusion::setParameters(const RangeDataFusionParameters &p) {
+	assert_ge<double>(p.maxTimeDifference_, 0.0, "range data fusion max time difference: ");
+	std::lock_guard<std::mutex> lck(buffersMutex_);
+	params_ = p;
+	buffers_.clear();
+	buffers_.resize(params_.lidars_.size());
+}
+
+size_t RangeDataFusion::getNumLidars() const {
+	return params_.lidars_.size();
+}
+
+void RangeDataFusion::addRangeData(size_t lidarIdx, const PointCloud &cloud, const Time &timestamp) {
+	assert_lt(lidarIdx, buffers_.size(), "range data fusion lidar idx: ");
+	std::lock_guard<std::mutex> lck(buffersMutex_);
+	auto &buffer = buffers_.at(lidarIdx);
+	if (!buffer.empty() && timestamp < buffer.back().time_) {
+		std::cerr << "RangeDataFusion: lidar " << lidarIdx << " measurements out of order, dropping \n";
+		return;
+	}
+	buffer.push_back(TimestampedPointCloud { timestamp, cloud });
+	if (buffer.size() > kMaxBufferedCloudsPerLidar) {
+		buffer.pop_front();
+	}
+}
+
+int RangeDataFusion::findMatchingCloudIdx(size_t lidarIdx, const Time &referenceTime, bool *isWaitForMatch) const {
+	const auto &buffer = buffers_.at(lidarIdx);
+	int bestIdx = -1;
+	double bestTimeDifference = params_.maxTimeDifference_;
+	for (size_t i = 0; i < buffer.size(); ++i) {
+		const double timeDifference = std::fabs(toSeconds(buffer.at(i).time_ - referenceTime));
+		if (timeDifference <= bestTimeDifference) {
+			bestTimeDifference = timeDifference;
+			bestIdx = i;
+		}
+	}
+	// clouds arrive in order, once one is past the reference no closer cloud can arrive
+	*isWaitForMatch = buffer.empty() || buffer.back().time_ < referenceTime;
+	return bestIdx;
+}
+
+bool RangeDataFusion::popFusedRangeData(PointCloud *cloud, Time *timestamp) {
+	std::lock_guard<std::mutex> lck(buffersMutex_);
+	if (buffers_.empty() || buffers_.front().empty()) {
+		return false;
+	}
+	const TimestampedPointCloud &reference = buffers_.front().front();
+	const bool isForceFusion = buffers_.front().size() > kMaxPendingReferenceClouds;
+	std::vector<int> matchIdxs(buffers_.size(), -1);
+	matchIdxs.front() = 0;
+	for (size_t j = 1; j < buffers_.size(); ++j) {
+		bool isWaitForMatch = false;
+		matchIdxs.at(j) = findMatchingCloudIdx(j, reference.time_, &isWaitForMatch);
+		if (isWaitForMatch && !isForceFusion) {
+			return false;
+		}
+	}
+
+	std::vector<const TimestampedPointCloud*> clouds(buffers_.size(), nullptr);
+	for (size_t j = 0; j < buffers_.size(); ++j) {
+		if (matchIdxs.at(j) >= 0) {
+			clouds.at(j) = &buffers_.at(j).at(matchIdxs.at(j));
+		} else {
+			std::cout << "RangeDataFusion: no cloud from lidar " << j << " within "
+					<< params_.maxTimeDifference_ << " sec of the reference \n";
+		}
+	}
+	*timestamp = reference.time_;
+	fuse(clouds, reference.time_, cloud);
+
+	buffers_.front().pop_front();
+	for (size_t j = 1; j < buffers_.size(); ++j) {
+		auto &buffer = buffers_.at(j);
+		if (matchIdxs.at(j) >= 0) {
+			buffer.erase(buffer.begin(), buffer.begin() + matchIdxs.at(j) + 1);
+			continue;
+		}
+		while (!buffer.empty() && toSeconds(*timestamp - buffer.front().time_) > params_.maxTimeDifference_) {
+			buffer.pop_front();
+		}
+	}
+	return true;
+}
+
+void RangeDataFusion::fuse(const std::vector<const TimestampedPointCloud*> &clouds, const Time &referenceTime,
+		PointCloud *fused) const {
+	Eigen::Vector3d linearVelocity(0.0, 0.0, 0.0), angularVelocityRpy(0.0, 0.0, 0.0);
+	estimateConstantVelocity(*odometryBuffer_.snapshot(), params_.numPosesVelocityEstimation_, &linearVelocity,
+			&angularVelocityRpy);
+
+	size_t numPoints = 0;
+	bool isAllHaveColors = true;
+	bool isAllHaveNormals = true;
+	std::vector<size_t> offsets(clouds.size(), 0);
+	for (size_t j = 0; j < clouds.size(); ++j) {
+		offsets.at(j) = numPoints;
+		if (clouds.at(j) != nullptr) {
+			numPoints += clouds.at(j)->cloud_.points_.size();
+			isAllHaveColors = isAllHaveColors && clouds.at(j)->cloud_.HasColors();
+			isAllHaveNormals = isAllHaveNormals && clouds.at(j)->cloud_.HasNormals();
+		}
+	}
+	fused->Clear();
+	fused->points_.resize(numPoints);
+	if (isAllHaveColors) {
+		fused->colors_.resize(numPoints);
+	}
+	if (isAllHaveNormals) {
+		fused->normals_.resize(numPoints);
+	}
+
+	for (size_t j = 0; j < clouds.size(); ++j) {
+		if (clouds.at(j) == nullptr || clouds.at(j)->cloud_.IsEmpty()) {
+			continue;
+		}
+		const LidarFusionParameters &lidar = params_.lidars_.at(j);
+		const PointCloud &in = clouds.at(j)->cloud_;
+		const double timeOffset = toSeconds(clouds.at(j)->time_ - referenceTime);
+		const size_t offset = offsets.at(j);
+		if (isAllHaveColors) {
+			std::copy(in.colors_.begin(), in.colors_.end(), fused->colors_.begin() + offset);
+		}
+		if (isAllHaveNormals) {
+			// the motion during the sweep barely rotates the normals, only the extrinsics are applied
+			rotateVectors(lidar.rangeSensorToLidar_.linear(), in.normals_, &fused->normals_.at(offset));
+		}
+		if (!params_.isUndistortLidars_) {
+			const Transform T = constantVelocityMotion(linearVelocity, angularVelocityRpy, timeOffset)
+					* lidar.rangeSensorToLidar_;
+			transformPoints(T, in.points_, &fused->points_.at(offset));
+			continue;
+		}
+		// each point is measured at its own time within the sweep, phase is computed in the lidar frame
+#pragma omp parallel for
+		for (int i = 0; i < static_cast<int>(in.points_.size()); ++i) {
+			const Eigen::Vector3d &p = in.points_[i];
+			const double dt = timeOffset + lidar.scanDuration_ * computeScanPhase(p.x(), p.y(), lidar.isSpinningClockwise_);
+			fused->points_[offset + i] = constantVelocityMotion(linearVelocity, angularVelocityRpy, dt)
+					* (lidar.rangeSensorToLidar_ * p);
+		}
+	}
+}
+
+} // namespace o3d_slam
@@ -0,0 +1,279 @@
+/*
+ * RangeImage.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "open3d_slam/RangeImage.hpp"
+#include "open3d_slam/assert.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#ifdef open3d_slam_OPENMP_FOUND
+#include <omp.h>
+#endif
+
+namespace o3d_slam {
+
+namespace {
+const double kMinRange = 1e-3; // some drivers report missing returns as zeros
+const int kMinNumNeighboursNormalEstimation = 5;
+const int kCurvatureHalfWindow = 5; // as in loam
+const double kOccludedRangeRatio = 0.9; // a neighbour closer than this ratio of the range occludes the point
+const double kDegToRad = M_PI / 180.0;
+} // namespace
+
+void RangeImage::setParameters(const RangeImageParameters &p) {
+	assert_gt(p.numColumns_, 0, "range image num columns: ");
+	assert_gt(p.ringStep_, 0, "range image ring step: ");
+	assert_gt(p.columnStep_, 0, "range image column step: ");
+	assert_ge(p.normalEstimationHalfWindow_, 1, "range image normal estimation half window: ");
+	params_ = p;
+}
+
+void RangeImage::reset(int numRings, int numColumns, bool hasColors) {
+	numRings_ = numRings;
+	numColumns_ = numColumns;
+	const size_t numCells = numRings_ * numColumns_;
+	points_.assign(numCells, Eigen::Vector3d::Zero());
+	colors_.clear();
+	if (hasColors) {
+		colors_.assign(numCells, Eigen::Vector3d::Zero());
+	}
+	isValid_.assign(numCells, 0);
+	normals_.clear();
+	isNormalValid_.clear();
+	curvature_.clear();
+	labels_.clear();
+	isNormalsEstimated_ = false;
+}
+
+void RangeImage::setCell(int ring, int column, const PointCloud &cloud, size_t idx) {
+	const Eigen::Vector3d &p = cloud.points_[idx];
+	if (!p.allFinite() || p.norm() < kMinRange) {
+		return;
+	}
+	const int cellIdx = toIdx(ring, column);
+	points_[cellIdx] = p;
+	if (!colors_.empty()) {
+		colors_[cellIdx] = cloud.colors_[idx];
+	}
+	isValid_[cellIdx] = 1;
+}
+
+void RangeImage::setFromOrganizedCloud(const PointCloud &cloud, int height, int width) {
+	assert_eq<size_t>(cloud.points_.size(), height * width, "organized cloud size does not match height x width: ");
+	reset(height, width, cloud.HasColors());
+	for (int r = 0; r < height; ++r) {
+		for (int c = 0; c < width; ++c) {
+			setCell(r, c, cloud, r * width + c);
+		}
+	}
+}
+
+void RangeImage::setFromRings(const PointCloud &cloud, const std::vector<int> &rings) {
+	assert_eq(cloud.points_.size(), rings.size(), "range image needs one ring per point: ");
+	const int maxRing = rings.empty() ? -1 : *std::max_element(rings.begin(), rings.end());
+	reset(maxRing + 1, params_.numColumns_, cloud.HasColors());
+	for (size_t i = 0; i < cloud.points_.size(); ++i) {
+		const Eigen::Vector3d &p = cloud.points_[i];
+		if (rings[i] < 0 || !p.allFinite()) {
+			continue;
+		}
+		const double azimuth = std::atan2(p.y(), p.x()) + M_PI; // [0, 2pi]
+		const int column = std::min(numColumns_ - 1, static_cast<int>(azimuth / (2.0 * M_PI) * numColumns_));
+		const int cellIdx = toIdx(rings[i], column);
+		if (!isValid_[cellIdx] || p.squaredNorm() < points_[cellIdx].squaredNorm()) {
+			setCell(rings[i], column, cloud, i);
+		}
+	}
+}
+
+void RangeImage::setFromElevation(const PointCloud &cloud, int numRings, double minElevation, double maxElevation) {
+	assert_gt(numRings, 1, "range image num rings: ");
+	assert_gt(maxElevation, minElevation, "range image elevation range: ");
+	const double ringsPerRad = (numRings - 1) / ((maxElevation - minElevation) * kDegToRad);
+	std::vector<int> rings(cloud.points_.size(), -1);
+	for (size_t i = 0; i < cloud.points_.size(); ++i) {
+		const Eigen::Vector3d &p = cloud.points_[i];
+		const int ring = std::round((std::atan2(p.z(), p.head<2>().norm()) - minElevation * kDegToRad) * ringsPerRad);
+		if (ring >= 0 && ring < numRings) {
+			rings[i] = ring;
+		}
+	}
+	setFromRings(cloud, rings);
+}
+
+int RangeImage::getNumRings() const {
+	return numRings_;
+}
+
+int RangeImage::getNumColumns() const {
+	return numColumns_;
+}
+
+int RangeImage::toIdx(int ring, int column) const {
+	return ring * numColumns_ + column;
+}
+
+int RangeImage::wrapColumn(int column) const {
+	return (column % numColumns_ + numColumns_) % numColumns_;
+}
+
+bool RangeImage::isValid(int ring, int column) const {
+	return isValid_[toIdx(ring, column)] != 0;
+}
+
+const Eigen::Vector3d& RangeImage::getPoint(int ring, int column) const {
+	return points_[toIdx(ring, column)];
+}
+
+void RangeImage::estimateNormals() {
+	normals_.assign(points_.size(), Eigen::Vector3d::Zero());
+	isNormalValid_.assign(points_.size(), 0);
+#pragma omp parallel for schedule(static)
+	for (int r = 0; r < numRings_; ++r) {
+		for (int c = 0; c < numColumns_; ++c) {
+			const int idx = toIdx(r, c);
+			if (isValid_[idx] && computeNormal(r, c, &normals_[idx])) {
+				isNormalValid_[idx] = 1;
+			}
+		}
+	}
+	isNormalsEstimated_ = true;
+}
+
+bool RangeImage::computeNormal(int ring, int column, Eigen::Vector3d *normal) const {
+	const int h = params_.normalEstimationHalfWindow_;
+	const double maxDistanceSquared = params_.maxNeighbourDistance_ * params_.maxNeighbourDistance_;
+	const Eigen::Vector3d &p = getPoint(ring, column);
+	// centered on p, otherwise the covariance loses precision far from the sensor
+	Eigen::Vector3d sum = Eigen::Vector3d::Zero();
+	Eigen::Matrix3d sumOuter = Eigen::Matrix3d::Zero();
+	int n = 0;
+	for (int r = std::max(0, ring - h); r <= std::min(numRings_ - 1, ring + h); ++r) {
+		for (int dc = -h; dc <= h; ++dc) {
+			const int c = wrapColumn(column + dc);
+			if (!isValid(r, c)) {
+				continue;
+			}
+			const Eigen::Vector3d d = getPoint(r, c) - p;
+			if (d.squaredNorm() > maxDistanceSquared) {
+				continue;
+			}
+			sum += d;
+			sumOuter.noalias() += d * d.transpose();
+			++n;
+		}
+	}
+	if (n < kMinNumNeighboursNormalEstimation) {
+		return false;
+	}
+	const Eigen::Vector3d mean = sum / n;
+	const Eigen::Matrix3d covariance = sumOuter / n - mean * mean.transpose();
+	Eigen::SelfAdjointEigenSolver<Eigen::Matrix3d> solver;
+	solver.computeDirect(covariance);
+	*normal = solver.eigenvectors().col(0);
+	if (normal->dot(p) > 0.0) {
+		*normal = -*normal;
+	}
+	return true;
+}
+
+void RangeImage::computeLabels() {
+	curvature_.assign(points_.size(), -1.0);
+	labels_.assign(points_.size(), Label::Invalid);
+#pragma omp parallel for schedule(static)
+	for (int r = 0; r < numRings_; ++r) {
+		for (int c = 0; c < numColumns_; ++c) {
+			if (isValid(r, c)) {
+				computeCurvature(r, c);
+			}
+		}
+	}
+	labelGround();
+}
+
+void RangeImage::computeCurvature(int ring, int column) {
+	const int idx = toIdx(ring, column);
+	const Eigen::Vector3d &p = points_[idx];
+	const double range = p.norm();
+	Eigen::Vector3d diff = Eigen::Vector3d::Zero();
+	labels_[idx] = Label::Unlabeled;
+	for (int dc = -kCurvatureHalfWindow; dc <= kCurvatureHalfWindow; ++dc) {
+		const int c = wrapColumn(column + dc);
+		// missing returns and background next to an occluding object look like edges but depend on the viewpoint
+		if (!isValid(ring, c) || getPoint(ring, c).norm() < kOccludedRangeRatio * range) {
+			return;
+		}
+		diff += getPoint(ring, c) - p;
+	}
+	curvature_[idx] = diff.norm() / (2 * kCurvatureHalfWindow * range);
+	if (curvature_[idx] > params_.edgeCurvatureThreshold_) {
+		labels_[idx] = Label::Edge;
+	} else if (curvature_[idx] < params_.planarCurvatureThreshold_) {
+		labels_[idx] = Label::Planar;
+	}
+}
+
+void RangeImage::labelGround() {
+	const double tanMaxGroundAngle = std::tan(params_.maxGroundAngle_ * kDegToRad);
+	for (int c = 0; c < numColumns_; ++c) {
+		for (int r = 0; r + 1 < numRings_; ++r) {
+			if (!isValid(r, c) || !isValid(r + 1, c)) {
+				continue;
+			}
+			const Eigen::Vector3d &a = getPoint(r, c);
+			const Eigen::Vector3d &b = getPoint(r + 1, c);
+			if (a.z() > 0.0 || b.z() > 0.0) {
+				continue; // only below the sensor
+			}
+			const Eigen::Vector3d d = b - a;
+			if (std::fabs(d.z()) <= tanMaxGroundAngle * d.head<2>().norm()) {
+				labels_[toIdx(r, c)] = Label::Ground;
+				labels_[toIdx(r + 1, c)] = Label::Ground;
+			}
+		}
+	}
+}
+
+RangeImage::Label RangeImage::getLabel(int ring, int column) const {
+	assert_true(!labels_.empty(), "Range image labels are not computed");
+	return labels_[toIdx(ring, column)];
+}
+
+double RangeImage::getCurvature(int ring, int column) const {
+	assert_true(!curvature_.empty(), "Range image labels are not computed");
+	return curvature_[toIdx(ring, column)];
+}
+
+PointCloud RangeImage::toPointCloud() const {
+	PointCloud cloud;
+	const size_t maxNumPoints = points_.size() / (params_.ringStep_ * params_.columnStep_) + 1;
+	cloud.points_.reserve(maxNumPoints);
+	if (isNormalsEstimated_) {
+		cloud.normals_.reserve(maxNumPoints);
+	}
+	if (!colors_.empty()) {
+		cloud.colors_.reserve(maxNumPoints);
+	}
+	for (int r = 0; r < numRings_; r += params_.ringStep_) {
+		for (int c = 0; c < numColumns_; c += params_.columnStep_) {
+			const int idx = toIdx(r, c);
+			if (!isValid_[idx] || (isNormalsEstimated_ && !isNormalValid_[idx])) {
+				continue;
+			}
+			cloud.points_.push_back(points_[idx]);
+			if (isNormalsEstimated_) {
+				cloud.normals_.push_back(normals_[idx]);
+			}
+			if (!colors_.empty()) {
+				cloud.colors_.push_back(colors_[idx]);
+			}
+		}
+	}
+	return cloud;
+}
+
+} // namespace o3d_slam
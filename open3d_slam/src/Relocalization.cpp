@@ -0,0 +1,156 @@
+/*
+ * Relocalization.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "open3d_slam/Relocalization.hpp"
+#include "open3d_slam/CloudRegistration.hpp"
+#include "open3d_slam/ScanToMapRegistration.hpp"
+#include "open3d_slam/VoxelHashMap.hpp"
+#include "open3d_slam/assert.hpp"
+#include "open3d_slam/magic.hpp"
+#include "open3d_slam/output.hpp"
+#include "open3d_slam/time.hpp"
+
+#include <open3d/pipelines/registration/Registration.h>
+
+#ifdef open3d_slam_OPENMP_FOUND
+#include <omp.h>
+#endif
+
+namespace o3d_slam {
+
+namespace {
+namespace registration = open3d::pipelines::registration;
+} // namespace
+
+Relocalizer::Relocalizer() {
+	setParameters(params_);
+}
+
+void Relocalizer::setParameters(const MapperParameters &p) {
+	assert_gt(p.relocalization_.placeSize_, 0.0, "relocalization place size: ");
+	assert_ge(p.relocalization_.placePaddingRatio_, 0.0, "relocalization place padding ratio: ");
+	params_ = p;
+	params_.scanMatcher_.icp_.maxNumIter_ = magic::icpRunUntilConvergenceNumberOfIterations;
+	params_.scanMatcher_.icp_.maxCorrespondenceDistance_ = params_.placeRecognition_.maxIcpCorrespondenceDistance_;
+	cloudRegistration_ = cloudRegistrationFactory(toCloudRegistrationType(params_.scanMatcher_));
+}
+
+std::shared_ptr<Relocalizer::Feature> Relocalizer::computeFeatures(PointCloud *sparseCloud) const {
+	const auto &p = params_.placeRecognition_;
+	sparseCloud->EstimateNormals(open3d::geometry::KDTreeSearchParamHybrid(p.normalEstimationRadius_, p.normalKnn_));
+	sparseCloud->NormalizeNormals();
+	sparseCloud->OrientNormalsTowardsCameraLocation(Eigen::Vector3d::Zero());
+	return registration::ComputeFPFHFeature(*sparseCloud,
+			open3d::geometry::KDTreeSearchParamHybrid(p.featureRadius_, p.featureKnn_));
+}
+
+void Relocalizer::buildPlaces(const PointCloud &map) {
+	Timer t("relocalization_places_build");
+	const auto &p = params_.placeRecognition_;
+	const PointCloud sparseMap = *map.VoxelDownSample(p.featureVoxelSize_);
+
+	// a place is a tile of the map padded by a part of the scan range, the full range would make the places of
+	// a large map overlap so much that every place holds most of the map
+	const Eigen::Vector3d placeSize = Eigen::Vector3d::Constant(params_.relocalization_.placeSize_);
+	const Eigen::Vector3d padding = Eigen::Vector3d::Constant(
+			params_.relocalization_.placePaddingRatio_ * params_.scanProcessing_.cropper_.croppingMaxRadius_);
+	std::unordered_map<Eigen::Vector3i, std::vector<size_t>, EigenVec3iHash> placeIdxs;
+	std::unordered_map<Eigen::Vector3i, bool, EigenVec3iHash> isOccupied;
+	for (size_t i = 0; i < sparseMap.points_.size(); ++i) {
+		isOccupied[getVoxelIdx(sparseMap.points_[i], placeSize)] = true;
+	}
+	for (size_t i = 0; i < sparseMap.points_.size(); ++i) {
+		const Eigen::Vector3d &pt = sparseMap.points_[i];
+		const Eigen::Vector3i lower = getVoxelIdx(pt - padding, placeSize);
+		const Eigen::Vector3i upper = getVoxelIdx(pt + padding, placeSize);
+		for (int x = lower.x(); x <= upper.x(); ++x) {
+			for (int y = lower.y(); y <= upper.y(); ++y) {
+				for (int z = lower.z(); z <= upper.z(); ++z) {
+					const Eigen::Vector3i key(x, y, z);
+					if (isOccupied.count(key) > 0) {
+						placeIdxs[key].push_back(i);
+					}
+				}
+			}
+		}
+	}
+
+	places_.clear();
+	places_.resize(placeIdxs.size());
+	std::vector<std::pair<Eigen::Vector3i, const std::vector<size_t>*>> keys;
+	keys.reserve(placeIdxs.size());
+	for (const auto &kv : placeIdxs) {
+		keys.emplace_back(kv.first, &kv.second);
+	}
+#pragma omp parallel for schedule(dynamic)
+	for (int i = 0; i < static_cast<int>(keys.size()); ++i) {
+		Place &place = places_[i];
+		place.center_ = getVoxelCenter(keys[i].first, placeSize);
+		place.cloud_ = *sparseMap.SelectByIndex(*keys[i].second);
+		place.feature_ = computeFeatures(&place.cloud_);
+		cloudRegistration_->estimateNormalsOrCovariancesIfNeeded(&place.cloud_);
+	}
+	std::cout << "Relocalization: computed features for " << places_.size() << " places \n";
+}
+
+size_t Relocalizer::getNumPlaces() const {
+	return places_.size();
+}
+
+const std::vector<Relocalizer::Place>& Relocalizer::getPlaces() const {
+	return places_;
+}
+
+void Relocalizer::setPlaces(std::vector<Place> places) {
+	places_ = std::move(places);
+}
+
+bool Relocalizer::relocalize(const PointCloud &scan, Transform *mapToRangeSensor) const {
+	Timer t("relocalization");
+	if (places_.empty()) {
+		std::cerr << "Relocalization: no places, has the map been set? \n";
+		return false;
+	}
+	const auto &cfg = params_.placeRecognition_;
+	PointCloud sparseScan = *scan.VoxelDownSample(cfg.featureVoxelSize_);
+	const std::shared_ptr<Feature> scanFeature = computeFeatures(&sparseScan);
+	cloudRegistration_->estimateNormalsOrCovariancesIfNeeded(&sparseScan);
+	const auto edgeLengthChecker = registration::CorrespondenceCheckerBasedOnEdgeLength(
+			cfg.correspondenceCheckerEdgeLength_);
+	const auto distanceChecker = registration::CorrespondenceCheckerBasedOnDistance(cfg.correspondenceCheckerDistance_);
+
+	std::vector<double> fitness(places_.size(), -1.0);
+	std::vector<Transform, Eigen::aligned_allocator<Transform>> poses(places_.size(), Transform::Identity());
+#pragma omp parallel for schedule(dynamic)
+	for (int i = 0; i < static_cast<int>(places_.size()); ++i) {
+		const Place &place = places_[i];
+		const auto ransacResult = registration::RegistrationRANSACBasedOnFeatureMatching(sparseScan, place.cloud_,
+				*scanFeature, *place.feature_, true, cfg.ransacMaxCorrespondenceDistance_,
+				registration::TransformationEstimationPointToPoint(false), cfg.ransacModelSize_, { distanceChecker,
+						edgeLengthChecker }, registration::RANSACConvergenceCriteria(cfg.ransacNumIter_,
+						cfg.ransacProbability_));
+		if (ransacResult.correspondence_set_.size() < cfg.ransacMinCorrespondenceSetSize_) {
+			continue;
+		}
+		const auto icpResult = cloudRegistration_->registerClouds(sparseScan, place.cloud_,
+				Transform(ransacResult.transformation_));
+		fitness[i] = icpResult.fitness_;
+		poses[i] = Transform(icpResult.transformation_);
+	}
+
+	const auto best = std::max_element(fitness.begin(), fitness.end());
+	const size_t bestIdx = std::distance(fitness.begin(), best);
+	if (*best < params_.relocalization_.minRefinementFitness_) {
+		std::cout << "Relocalization failed, best fitness: " << *best << "\n";
+		return false;
+	}
+	*mapToRangeSensor = poses[bestIdx];
+	std::cout << "Relocalized in place " << bestIdx << " with fitness " << *best << ", pose: "
+			<< asStringXYZRPY(*mapToRangeSensor) << "\n";
+	return true;
+}
+
+} // namespace o3d_slam
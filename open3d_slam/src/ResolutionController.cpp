@@ -0,0 +1,65 @@
+/*
+ * ResolutionController.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "open3d_slam/ResolutionController.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace o3d_slam {
+
+namespace {
+const double kLatencySmoothing = 0.2;
+const double kLevelStep = 0.05;
+const double kRelaxLatencyRatio = 0.7; // hysteresis, resolution is refined only well below the target
+} // namespace
+
+void ResolutionController::setParameters(const AdaptiveResolutionParameters &p, const ScanResolution &finest) {
+	params_ = p;
+	finest_ = finest;
+	current_ = finest;
+	level_ = 0.0;
+	isFirstMeasurement_ = true;
+}
+
+bool ResolutionController::update(double latencyMsec, size_t queueSize) {
+	if (!params_.isEnabled_) {
+		return false;
+	}
+	avgLatencyMsec_ =
+			isFirstMeasurement_ ? latencyMsec : (1.0 - kLatencySmoothing) * avgLatencyMsec_ + kLatencySmoothing * latencyMsec;
+	isFirstMeasurement_ = false;
+
+	double level = level_;
+	if (avgLatencyMsec_ > params_.targetLatencyMsec_ || queueSize > params_.maxQueueSize_) {
+		level = std::min(level_ + kLevelStep, 1.0);
+	} else if (avgLatencyMsec_ < kRelaxLatencyRatio * params_.targetLatencyMsec_ && queueSize == 0) {
+		level = std::max(level_ - kLevelStep, 0.0);
+	}
+	if (level == level_) {
+		return false;
+	}
+	level_ = level;
+	const double coarsestVoxelSize = std::max(params_.maxVoxelSize_, finest_.voxelSize_);
+	const double coarsestDownSamplingRatio = std::min(params_.minDownSamplingRatio_, finest_.downSamplingRatio_);
+	const int coarsestMaxNumIter = std::min(params_.minNumIter_, finest_.maxNumIter_);
+	current_.voxelSize_ = finest_.voxelSize_ + level_ * (coarsestVoxelSize - finest_.voxelSize_);
+	current_.downSamplingRatio_ = finest_.downSamplingRatio_
+			+ level_ * (coarsestDownSamplingRatio - finest_.downSamplingRatio_);
+	current_.maxNumIter_ = static_cast<int>(std::round(
+			finest_.maxNumIter_ + level_ * (coarsestMaxNumIter - finest_.maxNumIter_)));
+	return true;
+}
+
+const ScanResolution& ResolutionController::getResolution() const {
+	return current_;
+}
+
+double ResolutionController::getLevel() const {
+	return level_;
+}
+
+} // namespace o3d_slam
@@ -9,6 +9,7 @@
 #include "open3d_slam/helpers.hpp"
 #include "open3d_slam/assert.hpp"
 #include "open3d_slam/CloudRegistration.hpp"
+#include "open3d_slam/GaussNewton.hpp"
 
 namespace o3d_slam {
 
@@ -16,6 +17,37 @@ namespace {
 namespace registration = open3d::pipelines::registration;
 std::shared_ptr<CloudRegistration> cloudRegistration;
 
+const double kMaxMahalanobisDistance = 5.0;
+const double kNdtConvergenceThreshold = 1e-6;
+const int kNdtMinNumCorrespondences = 10;
+
+// Gauss-Newton on the sum of squared Mahalanobis distances, inlier rmse is w.r.t. the voxel means
+RegistrationResult registerToNdtMap(const PointCloud &scan, const NdtVoxelMap &map, const Transform &init,
+		int maxNumIter) {
+	auto linearize = [&](const Transform &T, GaussNewtonSystem *system) {
+		for (const auto &point : scan.points_) {
+			const Eigen::Vector3d p = T * point;
+			const NdtVoxel *voxel = map.getClosestDistribution(p);
+			if (voxel == nullptr) {
+				continue;
+			}
+			const Eigen::Vector3d e = p - voxel->mean_;
+			const Eigen::Vector3d informationTimesE = voxel->information_ * e;
+			const double squaredMahalanobisDistance = e.dot(informationTimesE);
+			if (squaredMahalanobisDistance > kMaxMahalanobisDistance * kMaxMahalanobisDistance) {
+				continue;
+			}
+			const Eigen::Matrix<double, 3, 6> J = pointJacobian(p);
+			system->H_.noalias() += J.transpose() * voxel->information_ * J;
+			system->g_.noalias() += J.transpose() * informationTimesE;
+			system->sumSquaredResiduals_ += e.squaredNorm();
+			++system->numCorrespondences_;
+		}
+	};
+	return optimizeRigidTransform(init, scan.points_.size(), maxNumIter, kNdtMinNumCorrespondences,
+			kNdtConvergenceThreshold, linearize);
+}
+
 } // namespace
 
 ScanToMapIcp::ScanToMapIcp() {
@@ -55,9 +87,8 @@ ProcessedScans ScanToMapIcp::processForScanMatchingAndMerging(const PointCloud &
 }
 RegistrationResult ScanToMapIcp::scanToMapRegistration(const PointCloud &scan, const Submap &activeSubmap,
 		const Transform &mapToRangeSensor, const Transform &initialGuess) const {
-	const PointCloud &activeSubmapPointCloud = activeSubmap.getMapPointCloud();
 	scanMatcherCropper_->setPose(mapToRangeSensor);
-	const PointCloudPtr mapPatch = scanMatcherCropper_->crop(activeSubmapPointCloud);
+	const PointCloudPtr mapPatch = activeSubmap.cropMapPointCloud(*scanMatcherCropper_);
 	assert_gt<int>(mapPatch->points_.size(), 0, "map patch size is zero");
 	return cloudRegistration->registerClouds(scan, *mapPatch, initialGuess);
 }
@@ -84,11 +115,73 @@ void ScanToMapIcp::prepareInitialMap(PointCloud *map) const {
 	cloudRegistration->estimateNormalsOrCovariancesIfNeeded(map);
 }
 
+ScanToMapNdt::ScanToMapNdt() {
+	update(params_);
+}
+
+void ScanToMapNdt::setParameters(const MapperParameters &p) {
+	params_ = p;
+	update(params_);
+}
+
+void ScanToMapNdt::update(const MapperParameters &p) {
+	assert_gt(p.scanMatcher_.ndt_.voxelSize_, 0.0, "ndt voxel size: ");
+	mapBuilderCropper_ = croppingVolumeFactory(p.mapBuilder_.cropper_);
+	scanMatcherCropper_ = croppingVolumeFactory(p.scanProcessing_.cropper_);
+}
+
+ProcessedScans ScanToMapNdt::processForScanMatchingAndMerging(const PointCloud &in,
+		const Transform &mapToRangeSensor) const {
+	ProcessedScans retVal;
+	auto wideCropped = mapBuilderCropper_->crop(in);
+	o3d_slam::voxelize(params_.scanProcessing_.voxelSize_, wideCropped.get());
+	wideCropped = wideCropped->RandomDownSample(params_.scanProcessing_.downSamplingRatio_);
+	scanMatcherCropper_->setPose(Transform::Identity());
+	retVal.match_ = scanMatcherCropper_->crop(*wideCropped);
+	retVal.merge_ = wideCropped;
+	assert_gt<int>(retVal.match_->points_.size(), 0, "ScanToMapNdt::narrow cropped size is zero");
+	assert_gt<int>(retVal.merge_->points_.size(), 0, "ScanToMapNdt::wideCropped cropped size is zero");
+	return retVal;
+}
+
+RegistrationResult ScanToMapNdt::scanToMapRegistration(const PointCloud &scan, const Submap &activeSubmap,
+		const Transform &mapToRangeSensor, const Transform &initialGuess) const {
+	const NdtVoxelMap ndtMap = activeSubmap.getNdtMapCopy();
+	assert_gt<int>(ndtMap.size(), 0, "ndt map size is zero");
+	return registerToNdtMap(scan, ndtMap, initialGuess, params_.scanMatcher_.ndt_.maxNumIter_);
+}
+
+bool ScanToMapNdt::isMergeScanValid(const PointCloud &in) const {
+	return true;
+}
+
+void ScanToMapNdt::prepareInitialMap(PointCloud *map) const {
+	// distributions are built by the submap
+}
+
+void ScanToMapNdt::setScanResolution(const ScanResolution &resolution) {
+	params_.scanProcessing_.voxelSize_ = resolution.voxelSize_;
+	params_.scanProcessing_.downSamplingRatio_ = resolution.downSamplingRatio_;
+	params_.scanMatcher_.ndt_.maxNumIter_ = resolution.maxNumIter_;
+}
+
+void ScanToMapIcp::setScanResolution(const ScanResolution &resolution) {
+	params_.scanProcessing_.voxelSize_ = resolution.voxelSize_;
+	params_.scanProcessing_.downSamplingRatio_ = resolution.downSamplingRatio_;
+	params_.scanMatcher_.icp_.maxNumIter_ = resolution.maxNumIter_;
+	cloudRegistration->setMaxNumIterations(resolution.maxNumIter_);
+}
+
 std::unique_ptr<ScanToMapIcp> createScanToMapIcp(const MapperParameters &p) {
 	auto ret = std::make_unique<ScanToMapIcp>();
 	ret->setParameters(p);
 	return std::move(ret);
 }
+std::unique_ptr<ScanToMapNdt> createScanToMapNdt(const MapperParameters &p) {
+	auto ret = std::make_unique<ScanToMapNdt>();
+	ret->setParameters(p);
+	return std::move(ret);
+}
 std::unique_ptr<ScanToMapRegistration> scanToMapRegistrationFactory(const MapperParameters &p) {
 	switch (p.scanMatcher_.scanToMapRegType_) {
 	case ScanToMapRegistrationType::PointToPlaneIcp:
@@ -96,6 +189,9 @@ std::unique_ptr<ScanToMapRegistration> scanToMapRegistrationFactory(const Mapper
 	case ScanToMapRegistrationType::PointToPointIcp: {
 		return createScanToMapIcp(p);
 	}
+	case ScanToMapRegistrationType::Ndt: {
+		return createScanToMapNdt(p);
+	}
 
 	default:
 		throw std::runtime_error("scanToMapRegistrationFactory: unknown type of registration scan to map");
@@ -111,6 +207,7 @@ CloudRegistrationParameters toCloudRegistrationType(const ScanToMapRegistrationP
 		retVal.regType_ = CloudRegistrationType::PointToPlaneIcp;
 		break;
 	}
+	case ScanToMapRegistrationType::Ndt: // place recognition and relocalization register point clouds, no distributions
 	case ScanToMapRegistrationType::PointToPointIcp: {
 		retVal.regType_ = CloudRegistrationType::PointToPointIcp;
 		break;
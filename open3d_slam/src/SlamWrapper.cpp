@@ -7,6 +7,7 @@
 
 #include "open3d_slam/SlamWrapper.hpp"
 
+#include <algorithm>
 #include <chrono>
 #include <open3d/Open3D.h>
 #include "open3d_slam/Parameters.hpp"
@@ -22,6 +23,8 @@
 #include "open3d_slam/constraint_builders.hpp"
 #include "open3d_slam/Odometry.hpp"
 #include "open3d_slam/MotionCompensation.hpp"
+#include "open3d_slam/PoseExtrapolator.hpp"
+#include "open3d_slam/InitialMapCache.hpp"
 #include "open3d_slam/ScanToMapRegistration.hpp"
 
 #ifdef open3d_slam_OPENMP_FOUND
@@ -33,6 +36,21 @@ namespace o3d_slam {
 namespace {
 using namespace o3d_slam::frames;
 const double timingStatsEveryNsec = 15.0;
+
+void printResolution(const std::string &stage, const AdaptiveResolutionParameters &p, const ResolutionController &controller) {
+	if (!p.isEnabled_) {
+		return;
+	}
+	const ScanResolution &r = controller.getResolution();
+	std::cout << stage << " resolution: level " << controller.getLevel() << ", voxel size " << r.voxelSize_
+			<< ", downsampling ratio " << r.downSamplingRatio_ << ", max num iter " << r.maxNumIter_ << " \n";
+}
+
+// odometry and mapping always run, see startWorkers
+int getNumDedicatedWorkers(const MapperParameters &p) {
+	return 2 + static_cast<int>(p.isAttemptLoopClosures_) + static_cast<int>(p.isBuildDenseMap_)
+			+ static_cast<int>(p.meshing_.isEnabled_);
+}
 }
 
 SlamWrapper::SlamWrapper() {
@@ -62,6 +80,10 @@ SlamWrapper::~SlamWrapper() {
 		denseMapWorker_.join();
 		std::cout << "Joined the dense map worker! \n";
 	}
+	if (meshWorker_.joinable()) {
+		meshWorker_.join();
+		std::cout << "Joined the mesh worker \n";
+	}
 
 	std::cout << "    Scan insertion: Avg execution time: "
 			<< mapperOnlyTimer_.getAvgMeasurementMsec() << " msec , frequency: "
@@ -78,6 +100,12 @@ SlamWrapper::~SlamWrapper() {
 		if (mapperParams_.isBuildDenseMap_ && savingParameters_.isSaveDenseSubmaps_){
 			saveDenseSubmaps(mapSavingFolderPath_);
 		}
+		if (savingParameters_.isSaveSession_){
+			saveSession(mapSavingFolderPath_ + "session/");
+		}
+		if (mapperParams_.meshing_.isEnabled_ && savingParameters_.isSaveMeshes_){
+			saveMeshes(mapSavingFolderPath_);
+		}
 		std::cout << "All done! \n";
 		std::cout << "Maps saved in " << mapSavingFolderPath_ << "\n";
 
@@ -91,6 +119,15 @@ const MapperParameters &SlamWrapper::getMapperParameters() const{
 MapperParameters *SlamWrapper::getMapperParametersPtr(){
 	return mapper_->getParametersPtr();
 }
+const ThreadingParameters &SlamWrapper::getThreadingParameters() const {
+	return threadingParameters_;
+}
+const ConstantVelocityMotionCompensationParameters &SlamWrapper::getMotionCompensationParameters() const {
+	return motionCompensationParameters_;
+}
+const TransformInterpolationBuffer &SlamWrapper::getOdometryToRangeSensorBuffer() const {
+	return odometry_->getBuffer();
+}
 size_t SlamWrapper::getOdometryBufferSize() const {
 	return odometryBuffer_.size();
 }
@@ -105,6 +142,24 @@ size_t SlamWrapper::getMappingBufferSizeLimit() const {
 	return mappingBuffer_.size_limit();
 }
 
+void SlamWrapper::setInputBufferSizeLimit(size_t sizeLimit) {
+	odometryBuffer_.set_size_limit(sizeLimit);
+	mappingBuffer_.set_size_limit(sizeLimit);
+	registeredCloudBuffer_.set_size_limit(sizeLimit);
+}
+
+bool SlamWrapper::isInputBufferSpaceAvailable() const {
+	return odometryBuffer_.size() + 1 < odometryBuffer_.size_limit()
+			&& mappingBuffer_.size() + 1 < mappingBuffer_.size_limit();
+}
+
+bool SlamWrapper::waitForInputBufferSpace(const std::chrono::milliseconds &timeout) {
+	std::unique_lock<std::mutex> lck(inputBufferSpaceMutex_);
+	return inputBufferSpaceCv_.wait_for(lck, timeout, [this]() {
+		return isInputBufferSpaceAvailable();
+	});
+}
+
 void SlamWrapper::addRangeScan(const open3d::geometry::PointCloud cloud, const Time timestamp) {
 	updateFirstMeasurementTime(timestamp);
 
@@ -129,6 +184,15 @@ std::pair<PointCloud, Time> SlamWrapper::getLatestRegisteredCloudTimestampPair()
 	return {c.raw_.cloud_,c.raw_.time_};
 }
 
+bool SlamWrapper::isPoseExtrapolationAvailable() const {
+	return poseExtrapolator_ != nullptr && poseExtrapolator_->isReady();
+}
+
+Transform SlamWrapper::getExtrapolatedMapToRangeSensor(const Time &queryTime) const {
+	assert_nonNullptr(poseExtrapolator_, "SlamWrapper: pose extrapolator not initialized");
+	return poseExtrapolator_->extrapolateMapToRangeSensor(queryTime);
+}
+
 void SlamWrapper::finishProcessing() {
 	while (isRunWorkers_) {
 		if (!mappingBuffer_.empty()) {
@@ -197,12 +261,34 @@ void SlamWrapper::loadParametersAndInitialize() {
 	loadParameters(paramFile, &odometryParams_);
 	odometry_ = std::make_shared<o3d_slam::LidarOdometry>();
 	odometry_->setParameters(odometryParams_);
+	odometryResolutionController_.setParameters(odometryParams_.adaptiveResolution_,
+			ScanResolution { odometryParams_.scanProcessing_.voxelSize_, odometryParams_.scanProcessing_.downSamplingRatio_,
+					odometryParams_.scanMatcher_.icp_.maxNumIter_ });
+
+	o3d_slam::loadParameters(paramFile, &mapperParams_);
+	loadParameters(paramFile, &threadingParameters_);
+	// the cores left over by the dedicated workers
+	const int numThreads =
+			threadingParameters_.numThreads_ > 0 ?
+					threadingParameters_.numThreads_ :
+					std::max<int>(1,
+							static_cast<int>(std::thread::hardware_concurrency()) - getNumDedicatedWorkers(mapperParams_));
+	// a thread has one os priority, all the tasks in the pool are feature computations
+	threadPool_ = std::make_shared<ThreadPool>(numThreads, [this]() {
+		configureCurrentThread(threadingParameters_, ThreadPriority::Features);
+	});
 
 	submaps_ = std::make_shared<o3d_slam::SubmapCollection>();
 	submaps_->setFolderPath(folderPath_);
+	submaps_->setThreadPool(threadPool_);
 	mapper_ = std::make_shared<o3d_slam::Mapper>(odometry_->getBuffer(), submaps_);
-	o3d_slam::loadParameters(paramFile, &mapperParams_);
 	mapper_->setParameters(mapperParams_);
+	const int mappingMaxNumIter =
+			mapperParams_.scanMatcher_.scanToMapRegType_ == ScanToMapRegistrationType::Ndt ?
+					mapperParams_.scanMatcher_.ndt_.maxNumIter_ : mapperParams_.scanMatcher_.icp_.maxNumIter_;
+	mappingResolutionController_.setParameters(mapperParams_.adaptiveResolution_,
+			ScanResolution { mapperParams_.scanProcessing_.voxelSize_, mapperParams_.scanProcessing_.downSamplingRatio_,
+					mappingMaxNumIter });
 
 	optimizationProblem_ = std::make_shared<o3d_slam::OptimizationProblem>();
 	optimizationProblem_->setParameters(mapperParams_);
@@ -223,19 +309,70 @@ void SlamWrapper::loadParametersAndInitialize() {
 		motionCompMap->setParameters(motionCompensationParameters_);
 		motionCompensationMap_ = motionCompMap;
 	}
+
+	PoseExtrapolationParameters poseExtrapolationParameters;
+	loadParameters(paramFile, &poseExtrapolationParameters);
+	poseExtrapolator_ = std::make_shared<PoseExtrapolator>(odometry_->getBuffer(), mapper_->getMapToRangeSensorBuffer());
+	poseExtrapolator_->setParameters(poseExtrapolationParameters);
+
+	if (!mapperParams_.loadSessionFolderPath_.empty()) {
+		assert_true(!mapperParams_.isUseInitialMap_, "Loading a session and using an initial map are mutually exclusive");
+		if (!loadSession(mapperParams_.loadSessionFolderPath_)) {
+			throw std::runtime_error("Failed to load the session from: " + mapperParams_.loadSessionFolderPath_);
+		}
+	}
 }
 
 void SlamWrapper::setInitialMap(const PointCloud &initialMap) {
-	TimestampedPointCloud measurement{fromUniversal(0), std::move(initialMap)};
-  {
-	  Timer t("initial map preparation");
-  	mapper_->getScanToMapRegistration().prepareInitialMap(&measurement.cloud_);
-  }
+	TimestampedPointCloud measurement{fromUniversal(0), PointCloud()};
+	const std::string cacheDirectory = folderPath_ + "initial_map_cache/";
+	uint64 cacheKey = 0;
+	bool isLoadedFromCache = false;
+	if (mapperParams_.isCacheInitialMap_) {
+		Timer t("initial map cache lookup");
+		cacheKey = computeInitialMapCacheKey(initialMap, mapperParams_);
+		isLoadedFromCache = loadInitialMapCache(getInitialMapCacheFilename(cacheDirectory, cacheKey), cacheKey,
+				&measurement.cloud_);
+	}
+	if (isLoadedFromCache) {
+		std::cout << "Initial map loaded from cache! \n";
+	} else {
+		Timer t("initial map preparation");
+		measurement.cloud_ = initialMap;
+		mapper_->getScanToMapRegistration().prepareInitialMap(&measurement.cloud_);
+		voxelize(mapperParams_.mapBuilder_.mapVoxelSize_, &measurement.cloud_);
+		if (mapperParams_.isCacheInitialMap_) {
+			createDirectoryOrNoActionIfExists(cacheDirectory);
+			if (!saveInitialMapCache(getInitialMapCacheFilename(cacheDirectory, cacheKey), cacheKey, measurement.cloud_)) {
+				std::cerr << "WARNING: could not cache the prepared initial map \n";
+			}
+		}
+	}
   std::cout << "Initial map prepared! \n";
+	const auto relocalizer = mapper_->getRelocalizer();
+	const bool isCachePlaces = mapperParams_.isCacheInitialMap_ && relocalizer != nullptr;
+	const uint64 placesCacheKey = isCachePlaces ? computeRelocalizationPlacesCacheKey(cacheKey, mapperParams_) : 0;
+	bool isPlacesLoadedFromCache = false;
+	if (isCachePlaces) {
+		std::vector<Relocalizer::Place> places;
+		isPlacesLoadedFromCache = loadRelocalizationPlacesCache(
+				getRelocalizationPlacesCacheFilename(cacheDirectory, placesCacheKey), placesCacheKey, &places);
+		if (isPlacesLoadedFromCache) {
+			std::cout << "Relocalization places loaded from cache! \n";
+			relocalizer->setPlaces(std::move(places));
+		}
+	}
 	const bool mappingResult = mapper_->addRangeMeasurement(measurement.cloud_, measurement.time_);
 	if (!mappingResult) {
 		std::cerr << "WARNING: mapping initialization has failed!!!! \n";
 	}
+	if (isCachePlaces && !isPlacesLoadedFromCache && relocalizer->getNumPlaces() > 0) {
+		createDirectoryOrNoActionIfExists(cacheDirectory);
+		if (!saveRelocalizationPlacesCache(getRelocalizationPlacesCacheFilename(cacheDirectory, placesCacheKey),
+				placesCacheKey, relocalizer->getPlaces())) {
+			std::cerr << "WARNING: could not cache the relocalization places \n";
+		}
+	}
 }
 
 
@@ -246,26 +383,40 @@ void SlamWrapper::setInitialTransform(const Eigen::Matrix4d initialTransform) {
 
 void SlamWrapper::startWorkers() {
 	odometryWorker_ = std::thread([this]() {
+		configureCurrentThread(threadingParameters_, ThreadPriority::Odometry);
 		odometryWorker();
 	});
 	mappingWorker_ = std::thread([this]() {
+		configureCurrentThread(threadingParameters_, ThreadPriority::Mapping);
 		mappingWorker();
 	});
 	if (mapperParams_.isAttemptLoopClosures_) {
 		loopClosureWorker_ = std::thread([this]() {
+			configureCurrentThread(threadingParameters_, ThreadPriority::LoopClosure);
 			loopClosureWorker();
 		});
 	}
 	if (mapperParams_.isBuildDenseMap_) {
 		denseMapWorker_ = std::thread([this]() {
+			configureCurrentThread(threadingParameters_, ThreadPriority::DenseMap);
 			denseMapWorker();
 		});
 	}
+	if (mapperParams_.meshing_.isEnabled_) {
+		meshWorker_ = std::thread([this]() {
+			configureCurrentThread(threadingParameters_, ThreadPriority::Meshing);
+			meshWorker();
+		});
+	}
 
 }
 
 void SlamWrapper::stopWorkers(){
-	isRunWorkers_ = false;
+	{
+		std::lock_guard<std::mutex> lck(meshingQueueMutex_);
+		isRunWorkers_ = false;
+	}
+	meshingQueueCv_.notify_all();
 }
 
 bool SlamWrapper::saveMap(const std::string &directory) {
@@ -284,6 +435,59 @@ bool SlamWrapper::saveSubmaps(const std::string &directory, const bool& isDenseM
 	return savingResult;
 }
 
+bool SlamWrapper::saveSession(const std::string &directory) {
+	createDirectoryOrNoActionIfExists(directory);
+	// the pose graph has to contain every submap, including the active one
+	Constraints odometryConstraints = submaps_->getOdometryConstraints();
+	computeOdometryConstraints(*submaps_, &odometryConstraints);
+	const size_t activeSubmapIdx = submaps_->getActiveSubmap().getId();
+	const size_t activeSubmapParentIdx = submaps_->getActiveSubmap().getParentId();
+	const bool hasActiveSubmapConstraint = std::any_of(odometryConstraints.begin(), odometryConstraints.end(),
+			[&](const Constraint &c) {
+				return c.sourceSubmapIdx_ == activeSubmapParentIdx && c.targetSubmapIdx_ == activeSubmapIdx;
+			});
+	if (activeSubmapIdx > 0 && !hasActiveSubmapConstraint) {
+		odometryConstraints.push_back(buildOdometryConstraint(activeSubmapParentIdx, activeSubmapIdx, *submaps_));
+	}
+	optimizationProblem_->clearOdometryConstraints();
+	optimizationProblem_->insertOdometryConstraints(odometryConstraints);
+	optimizationProblem_->buildOptimizationProblem(*submaps_);
+	optimizationProblem_->dumpToFile(directory + "pose_graph.json");
+	const bool savingResult = submaps_->saveSession(directory);
+	std::cout << "Session saved in " << directory << "\n";
+	return savingResult;
+}
+
+bool SlamWrapper::saveMeshes(const std::string &directory) {
+	createDirectoryOrNoActionIfExists(directory);
+	bool savingResult = true;
+	for (size_t i = 0; i < submaps_->getNumSubmaps(); ++i) {
+		Submap *submap = submaps_->getSubmapPtr(i);
+		submap->computeMesh();
+		const auto mesh = submap->getMesh();
+		if (mesh == nullptr || mesh->IsEmpty()) {
+			continue;
+		}
+		const std::string filename = directory + "mesh_" + std::to_string(i) + ".ply";
+		savingResult = open3d::io::WriteTriangleMesh(filename, *mesh) && savingResult;
+	}
+	return savingResult;
+}
+
+bool SlamWrapper::loadSession(const std::string &folderPath) {
+	Timer t("session_loading");
+	const std::string directory = folderPath.back() == '/' ? folderPath : folderPath + "/";
+	optimizationProblem_->loadFromFile(directory + "pose_graph.json");
+	const bool loadingResult = submaps_->loadSession(directory, optimizationProblem_->getOdometryConstraints(),
+			optimizationProblem_->getLoopClosureConstraints());
+	if (loadingResult) {
+		assert_eq(optimizationProblem_->getOdometryConstraints().size() + 1, submaps_->getNumSubmaps(),
+				"Session pose graph does not match the submaps: ");
+		mapper_->buildRelocalizationPlacesIfNeeded(mapper_->getAssembledMapPointCloud());
+	}
+	return loadingResult;
+}
+
 void SlamWrapper::odometryWorker() {
 	while (isRunWorkers_) {
 		if (odometryBuffer_.empty()) {
@@ -292,6 +496,7 @@ void SlamWrapper::odometryWorker() {
 		}
 		odometryStatisticsTimer_.startStopwatch();
 		const TimestampedPointCloud measurement = odometryBuffer_.pop();
+		inputBufferSpaceCv_.notify_all();
 		auto undistortedCloud = motionCompensationOdom_->undistortInputPointCloud(measurement.cloud_, measurement.time_);
 
 		const auto isOdomOkay = odometry_->addRangeScan(*undistortedCloud, measurement.time_);
@@ -308,10 +513,14 @@ void SlamWrapper::odometryWorker() {
 
 		const double timeMeasurement = odometryStatisticsTimer_.elapsedMsecSinceStopwatchStart();
 		odometryStatisticsTimer_.addMeasurementMsec(timeMeasurement);
+		if (odometryResolutionController_.update(timeMeasurement, odometryBuffer_.size())) {
+			odometry_->setScanResolution(odometryResolutionController_.getResolution());
+		}
 		if (mapperParams_.isPrintTimingStatistics_ && odometryStatisticsTimer_.elapsedSec() > timingStatsEveryNsec) {
 			std::cout << "Odometry timing stats: Avg execution time: "
 					<< odometryStatisticsTimer_.getAvgMeasurementMsec() << " msec , frequency: "
 					<< 1e3 / odometryStatisticsTimer_.getAvgMeasurementMsec() << " Hz \n";
+			printResolution("Odometry", odometryParams_.adaptiveResolution_, odometryResolutionController_);
 			odometryStatisticsTimer_.reset();
 		}
 
@@ -329,6 +538,7 @@ void SlamWrapper::mappingWorker() {
 		TimestampedPointCloud measurement;
 		{
 			const TimestampedPointCloud raw = mappingBuffer_.pop();
+			inputBufferSpaceCv_.notify_all();
 			auto undistortedCloud =
 					motionCompensationMap_->undistortInputPointCloud(raw.cloud_,
 							raw.time_);
@@ -374,10 +584,23 @@ void SlamWrapper::mappingWorker() {
 		//just get the stats
 		const double timeMeasurement = mappingStatisticsTimer_.elapsedMsecSinceStopwatchStart();
 		mappingStatisticsTimer_.addMeasurementMsec(timeMeasurement);
+		// scans in between keyframes only chain the odometry, their latency says nothing about the resolution
+		if (mapper_->isLastScanKeyframe()
+				&& mappingResolutionController_.update(timeMeasurement, mappingBuffer_.size())) {
+			mapper_->setScanResolution(mappingResolutionController_.getResolution());
+		}
 		if (mapperParams_.isPrintTimingStatistics_ && mappingStatisticsTimer_.elapsedSec() > timingStatsEveryNsec) {
 			std::cout << "Mapper timing stats: Avg execution time: "
 					<< mappingStatisticsTimer_.getAvgMeasurementMsec() << " msec , frequency: "
 					<< 1e3 / mappingStatisticsTimer_.getAvgMeasurementMsec() << " Hz \n";
+			printResolution("Mapper", mapperParams_.adaptiveResolution_, mappingResolutionController_);
+			if (mapperParams_.keyframes_.isEnabled_) {
+				const KeyframeStatistics stats = mapper_->getAndResetKeyframeStatistics();
+				const KeyframeParameters &p = mapperParams_.keyframes_;
+				std::cout << "Mapper keyframes: " << stats.numKeyframes_ << "/" << stats.numScans_ << " scans refined (every "
+						<< p.minDistance_ << " m, " << p.minRotation_ / params_internal::kDegToRad << " deg or "
+						<< p.maxTimeBetweenKeyframes_ << " sec) \n";
+			}
 			mappingStatisticsTimer_.reset();
 		}
 
@@ -425,11 +648,43 @@ void SlamWrapper::denseMapWorker() {
 
 }
 
+void SlamWrapper::meshWorker() {
+	while (isRunWorkers_) {
+		{
+			std::unique_lock<std::mutex> lck(meshingQueueMutex_);
+			meshingQueueCv_.wait(lck, [this]() {
+				return !isRunWorkers_ || !meshingQueue_.empty();
+			});
+		}
+		if (!isRunWorkers_) {
+			break;
+		}
+		const auto submapIds = meshingQueue_.popAllElements();
+		for (const auto id : submapIds) {
+			// submaps that did not change since they were last meshed return right away
+			submaps_->getSubmapPtr(id)->computeMesh();
+		}
+	} // end while
+}
+
+void SlamWrapper::pushToMeshingQueue(size_t submapId) {
+	{
+		std::lock_guard<std::mutex> lck(meshingQueueMutex_);
+		meshingQueue_.push(submapId);
+	}
+	meshingQueueCv_.notify_one();
+}
+
 void SlamWrapper::computeFeaturesIfReady() {
 	if (submaps_->numFinishedSubmaps() > 0 && !submaps_->isComputingFeatures()) {
-		computeFeaturesResult_ = std::async(std::launch::async, [this]() {
+		computeFeaturesResult_ = threadPool_->enqueue([this]() {
 			const auto finishedSubmapIds = submaps_->popFinishedSubmapIds();
 			submaps_->computeFeatures(finishedSubmapIds);
+			if (mapperParams_.meshing_.isEnabled_) {
+				for (const auto &id : finishedSubmapIds) {
+					pushToMeshingQueue(id.submapId_);
+				}
+			}
 		});
 	}
 }
@@ -529,6 +784,16 @@ void SlamWrapper::updateSubmapsAndTrajectory() {
 
 	submaps_->updateAdjacencyMatrix(loopClosureConstraints);
 
+	// the meshes were moved along with the submaps, only the ones that changed in the meantime are recomputed
+	if (mapperParams_.meshing_.isEnabled_) {
+		const size_t activeSubmapId = submaps_->getActiveSubmap().getId();
+		for (size_t i = 0; i < submaps_->getNumSubmaps(); ++i) {
+			if (i != activeSubmapId && submaps_->getSubmap(i).isMeshDirty()) {
+				pushToMeshingQueue(i);
+			}
+		}
+	}
+
 }
 
 
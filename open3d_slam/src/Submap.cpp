@@ -10,18 +10,20 @@
 #include "open3d_slam/assert.hpp"
 #include "open3d_slam/magic.hpp"
 #include "open3d_slam/typedefs.hpp"
+#include "open3d_slam/ThreadPool.hpp"
 
 #include <algorithm>
 #include <iostream>
 #include <numeric>
 #include <utility>
-#include <thread>
+#include <future>
 
 namespace o3d_slam {
 
 namespace {
 namespace registration = open3d::pipelines::registration;
 const std::string voxelMapLayer = "layer";
+const double kMaxRemovedMapPointsRatio = 0.02; // tombstoned map points are compacted away above this ratio
 } // namespace
 
 Submap::Submap(size_t id, size_t parentId) :
@@ -45,20 +47,40 @@ bool Submap::insertScan(const PointCloud &rawScan, const PointCloud &preProcesse
 	}
 
 	mapToRangeSensor_ = mapToRangeSensor;
+	{
+		std::lock_guard<std::mutex> lck(mapPointCloudMutex_);
+		expandMapPointCloud();
+	}
+	{
+		std::lock_guard<std::mutex> lck(denseMapMutex_);
+		isFinished_ = false; // active again
+	}
 
 	if (params_.isUseInitialMap_ && mapCloud_.IsEmpty()){
 		std::lock_guard<std::mutex> lck(mapPointCloudMutex_);
-		mapCloud_ = preProcessedScan;
-		voxelize(params_.mapBuilder_.mapVoxelSize_, &mapCloud_);
+		mapCloud_ = preProcessedScan; // initial map comes already voxelized, see SlamWrapper::setInitialMap
+		isMapVoxelIndexValid_ = false;
+		isOccupancyMapPointsValid_ = false;
+		isNdtMapValid_ = false;
+		clearRemovedMapPoints();
 		return true;
 	}
 
 	auto transformedCloud = o3d_slam::transform(mapToRangeSensor.matrix(), preProcessedScan);
+	if (params_.meshing_.isEnabled_ && !params_.isBuildDenseMap_ && !transformedCloud->HasNormals()) {
+		// the map is meshed, orient per scan since the surface is seen from the sensor
+		estimateNormals(params_.meshing_.knnNormalEstimation_, transformedCloud.get());
+		transformedCloud->OrientNormalsTowardsCameraLocation(mapToRangeSensor.translation());
+	}
 	if (isPerformCarving) {
 		carvingStatisticsTimer_.startStopwatch();
 		{
 			std::lock_guard<std::mutex> lck(mapPointCloudMutex_);
-			carve(rawScan, mapToRangeSensor, *mapBuilderCropper_, params_.mapBuilder_.carving_, &mapCloud_);
+			const auto idxsToRemove =
+					params_.mapBuilder_.carving_.occupancy_.isEnabled_ ?
+							updateOccupancy(*transformedCloud, mapToRangeSensor) :
+							carve(rawScan, mapToRangeSensor, *mapBuilderCropper_, params_.mapBuilder_.carving_, mapCloud_);
+			removeMapPoints(idxsToRemove);
 		}
 		const double timeMeasurement = carvingStatisticsTimer_.elapsedMsecSinceStopwatchStart();
 		carvingStatisticsTimer_.addMeasurementMsec(timeMeasurement);
@@ -70,10 +92,30 @@ bool Submap::insertScan(const PointCloud &rawScan, const PointCloud &preProcesse
 		}
 	}
 	std::lock_guard<std::mutex> lck(mapPointCloudMutex_);
-	mapCloud_ += *transformedCloud;
+	const size_t nPointsBeforeInsertion = mapCloud_.points_.size();
+	const bool isUpdateNdtMap = isUseNdtMap() && isNdtMapValid_;
+	std::vector<size_t> movedIdxs;
+	std::vector<Eigen::Vector3d> previousPositions;
+	if (params_.mapBuilder_.mapVoxelSize_ > 0.0) {
+		if (!isMapVoxelIndexValid_) {
+			mapVoxelIndex_.rebuild(mapCloud_, isMapPointRemoved_);
+			isMapVoxelIndexValid_ = true;
+		}
+		mapVoxelIndex_.insert(*transformedCloud, &mapCloud_, isUpdateNdtMap ? &movedIdxs : nullptr,
+				isUpdateNdtMap ? &previousPositions : nullptr);
+	} else {
+		mapCloud_ += *transformedCloud;
+	}
+	if (isUpdateNdtMap) {
+		ndtMap_.move(mapCloud_, movedIdxs, previousPositions);
+		ndtMap_.insert(mapCloud_, nPointsBeforeInsertion);
+	}
+	if (params_.mapBuilder_.carving_.occupancy_.isEnabled_ && isOccupancyMapPointsValid_) {
+		occupancyMap_.addPoints(mapCloud_, nPointsBeforeInsertion);
+	}
 	mapBuilderCropper_->setPose(mapToRangeSensor);
-	voxelizeInsideCroppingVolume(*mapBuilderCropper_, params_.mapBuilder_, &mapCloud_);
 	++nScansInsertedMap_;
+	setMeshDirty();
 	return true;
 }
 
@@ -83,50 +125,135 @@ bool Submap::insertScanDenseMap(const PointCloud &rawScan, const Transform &mapT
 	denseMapCropper_->setPose(Transform::Identity());
 	auto cropped = denseMapCropper_->crop(rawScan);
 	auto validColors = colorCropper_.crop(*cropped);
+	if (params_.meshing_.isEnabled_) {
+		// the sensor is at the origin, averaged in the dense map the normals point to where the surface was seen from
+		if (!validColors->HasNormals()) {
+			estimateNormals(params_.meshing_.knnNormalEstimation_, validColors.get());
+		}
+		validColors->OrientNormalsTowardsCameraLocation(Eigen::Vector3d::Zero());
+	}
 	auto transformedCloud = o3d_slam::transform(mapToRangeSensor.matrix(), *validColors);
 	{
 		std::lock_guard<std::mutex> lck(denseMapMutex_);
+		expandDenseMap();
 		denseMap_.insert(*transformedCloud);
-	}
-	if (isPerformCarving) {
-		std::lock_guard<std::mutex> lck(denseMapMutex_);
-		carve(rawScan, mapToRangeSensor.translation(), params_.denseMapBuilder_.carving_, &denseMap_);
+		if (isPerformCarving) {
+			carve(rawScan, mapToRangeSensor.translation(), params_.denseMapBuilder_.carving_, &denseMap_);
+		}
+		// the dense map worker runs behind the mapper, the last scans arrive after the submap was finished
+		if (isFinished_ && time >= finishTime_) {
+			compactDenseMap();
+		}
 	}
 	++nScansInsertedDenseMap_;
+	setMeshDirty();
 	return true;
 }
 
 void Submap::transform(const Transform &T) {
 	const Eigen::Matrix4d mat(T.matrix());
-	sparseMapCloud_.Transform(mat);
+	o3d_slam::transformInPlace(mat, &sparseMapCloud_);
 	{
 		std::lock_guard<std::mutex> lck(mapPointCloudMutex_);
-		mapCloud_.Transform(mat);
+		if (isMapCloudCompact_) {
+			compactMapCloud_.transform(T);
+		} else {
+			o3d_slam::transformInPlace(mat, &mapCloud_);
+		}
+		isMapVoxelIndexValid_ = false;
+		isNdtMapValid_ = false;
+		occupancyMap_.clear(); // voxels are axis aligned, they are recreated from the map points on the next update
+		isOccupancyMapPointsValid_ = false;
 
 	}
 	{
 		std::lock_guard<std::mutex> lck(denseMapMutex_);
-		denseMap_.transform(T);
+		if (isDenseMapCompact_) {
+			compactDenseMap_.transform(T);
+		} else {
+			denseMap_.transform(T);
+		}
+	}
+	{
+		std::lock_guard<std::mutex> lck(meshMutex_);
+		if (mesh_ != nullptr) {
+			auto transformedMesh = std::make_shared<TriangleMesh>(*mesh_);
+			transformedMesh->Transform(mat);
+			mesh_ = transformedMesh;
+		}
+		++nMeshTransforms_;
 	}
 	mapToRangeSensor_ = mapToRangeSensor_ * T;
 	submapCenter_ = T * submapCenter_;
 }
 
-void Submap::carve(const PointCloud &rawScan, const Transform &mapToRangeSensor,
-		const CroppingVolume &cropper, const SpaceCarvingParameters &params, PointCloud *map) {
-	if (map->points_.empty() || !(nScansInsertedMap_ % params.carveSpaceEveryNscans_ == 1)) {
-		return;
+std::vector<size_t> Submap::carve(const PointCloud &rawScan, const Transform &mapToRangeSensor,
+		const CroppingVolume &cropper, const SpaceCarvingParameters &params, const PointCloud &map) {
+	if (map.points_.empty() || !(nScansInsertedMap_ % params.carveSpaceEveryNscans_ == 1)) {
+		return {};
 	}
 //	Timer timer("carving");
 	auto scan = o3d_slam::transform(mapToRangeSensor.matrix(), rawScan);
 //	auto croppedScan = removeDuplicatePointsWithinSameVoxels(*scan, Eigen::Vector3d::Constant(params_.mapBuilder_.mapVoxelSize_));
-	const auto wideCroppedIdxs = cropper.getIndicesWithinVolume(*map);
+	const auto wideCroppedIdxs = cropper.getIndicesWithinVolume(map);
 	auto idxsToRemove = std::move(
-			getIdxsOfCarvedPoints(*scan, *map, mapToRangeSensor.translation(), wideCroppedIdxs, params));
-	toRemove_ = std::move(*(map->SelectByIndex(idxsToRemove)));
-	scanRef_ = std::move(*scan);
+			getIdxsOfCarvedPoints(*scan, map, mapToRangeSensor.translation(), wideCroppedIdxs, params));
+	if (params.isKeepCarvedPointsForDebugging_) {
+		toRemove_ = std::move(*(map.SelectByIndex(idxsToRemove)));
+		scanRef_ = std::move(*scan);
+	}
 //	std::cout << "Would remove: " << idxsToRemove.size() << std::endl;
-	removeByIds(idxsToRemove, map);
+	return idxsToRemove;
+}
+
+std::vector<size_t> Submap::updateOccupancy(const PointCloud &scan, const Transform &mapToRangeSensor) {
+	if (!isOccupancyMapPointsValid_) {
+		occupancyMap_.rebuildPoints(mapCloud_, isMapPointRemoved_);
+		isOccupancyMapPointsValid_ = true;
+	}
+	return occupancyMap_.insertScan(scan, mapToRangeSensor.translation());
+}
+
+void Submap::removeMapPoints(const std::vector<size_t> &idxs) {
+	if (idxs.empty()) {
+		return;
+	}
+	isMapPointRemoved_.resize(mapCloud_.points_.size(), false);
+	std::vector<size_t> newlyRemoved;
+	newlyRemoved.reserve(idxs.size());
+	for (const auto idx : idxs) {
+		if (!isMapPointRemoved_[idx]) {
+			isMapPointRemoved_[idx] = true;
+			newlyRemoved.push_back(idx);
+		}
+	}
+	nRemovedMapPoints_ += newlyRemoved.size();
+	// evicted right away so that a re-observed surface is added again and the distributions only hold live points
+	if (isMapVoxelIndexValid_) {
+		mapVoxelIndex_.remove(mapCloud_, newlyRemoved);
+	}
+	if (isNdtMapValid_) {
+		ndtMap_.remove(mapCloud_, newlyRemoved);
+	}
+	if (nRemovedMapPoints_ > kMaxRemovedMapPointsRatio * mapCloud_.points_.size()) {
+		eraseRemovedMapPoints();
+	}
+}
+
+void Submap::eraseRemovedMapPoints() {
+	if (nRemovedMapPoints_ == 0) {
+		return;
+	}
+	removeMarkedPoints(isMapPointRemoved_, &mapCloud_);
+	clearRemovedMapPoints();
+	isMapVoxelIndexValid_ = false;
+	isOccupancyMapPointsValid_ = false;
+	isNdtMapValid_ = false;
+}
+
+void Submap::clearRemovedMapPoints() {
+	isMapPointRemoved_.clear();
+	nRemovedMapPoints_ = 0;
 }
 
 void Submap::carve(const PointCloud &scan, const Eigen::Vector3d &sensorPosition, const SpaceCarvingParameters &param, VoxelizedPointCloud *cloud){
@@ -140,15 +267,6 @@ void Submap::carve(const PointCloud &scan, const Eigen::Vector3d &sensorPosition
 	}
 }
 
-void Submap::voxelizeInsideCroppingVolume(const CroppingVolume &cropper, const MapBuilderParameters &param,
-		PointCloud *map) const {
-	if (param.mapVoxelSize_ > 0.0) {
-		//			Timer timer("voxelize_map",true);
-		auto voxelizedMap = voxelizeWithinCroppingVolume(param.mapVoxelSize_, cropper, *map);
-		*map = *voxelizedMap;
-	}
-}
-
 void Submap::setParameters(const MapperParameters &mapperParams) {
 	params_ = mapperParams;
 	update(mapperParams);
@@ -160,6 +278,20 @@ Submap::Submap(const Submap &other) :
   colorCropper_ = other.colorCropper_;
   denseMap_ = other.denseMap_;
   voxelMap_ = other.voxelMap_;
+  mapVoxelIndex_ = other.mapVoxelIndex_;
+  isMapVoxelIndexValid_ = other.isMapVoxelIndexValid_;
+  ndtMap_ = other.ndtMap_;
+  isNdtMapValid_ = other.isNdtMapValid_;
+  occupancyMap_ = other.occupancyMap_;
+  isOccupancyMapPointsValid_ = other.isOccupancyMapPointsValid_;
+  compactMapCloud_ = other.compactMapCloud_;
+  isMapCloudCompact_ = other.isMapCloudCompact_;
+  compactDenseMap_ = other.compactDenseMap_;
+  isDenseMapCompact_ = other.isDenseMapCompact_;
+  isFinished_ = other.isFinished_;
+  finishTime_ = other.finishTime_;
+  isMapPointRemoved_ = other.isMapPointRemoved_;
+  nRemovedMapPoints_ = other.nRemovedMapPoints_;
   scanCounter_ = other.scanCounter_;
   carvingStatisticsTimer_ = other.carvingStatisticsTimer_;
   parentId_ = other.parentId_;
@@ -177,6 +309,9 @@ Submap::Submap(const Submap &other) :
   mapToSubmap_ = other.mapToSubmap_;
   mapCloud_ = other.mapCloud_;
   sparseMapCloud_ = other.sparseMapCloud_;
+  mesh_ = other.mesh_;
+  isMeshDirty_ = other.isMeshDirty_;
+  nMeshTransforms_ = other.nMeshTransforms_;
 
 //	update(params_);
 }
@@ -189,24 +324,123 @@ Eigen::Vector3d Submap::getMapToSubmapCenter() const {
 	return isCenterComputed_ ? submapCenter_ : mapToSubmap_.translation();
 }
 
-const Submap::PointCloud& Submap::getMapPointCloud() const {
-	return mapCloud_;
+PointCloudPtr Submap::cropMapPointCloud(const CroppingVolume &cropper) const {
+	std::lock_guard<std::mutex> lck(mapPointCloudMutex_);
+	expandMapPointCloud();
+	auto idxs = cropper.getIndicesWithinVolume(mapCloud_);
+	if (nRemovedMapPoints_ > 0) {
+		idxs.erase(std::remove_if(idxs.begin(), idxs.end(), [this](size_t idx) {
+			return idx < isMapPointRemoved_.size() && isMapPointRemoved_[idx];
+		}), idxs.end());
+	}
+	return mapCloud_.SelectByIndex(idxs);
 }
+
 PointCloud Submap::getMapPointCloudCopy() const {
 	std::lock_guard<std::mutex> lck(mapPointCloudMutex_);
+	if (isMapCloudCompact_) {
+		PointCloud copy;
+		compactMapCloud_.decode(&copy);
+		return std::move(copy);
+	}
 	auto copy = mapCloud_;
+	if (nRemovedMapPoints_ > 0) {
+		removeMarkedPoints(isMapPointRemoved_, &copy);
+	}
 	return std::move(copy);
 }
 const VoxelizedPointCloud& Submap::getDenseMap() const {
+	std::lock_guard<std::mutex> lck(denseMapMutex_);
+	expandDenseMap();
 	return denseMap_;
 }
 
 VoxelizedPointCloud Submap::getDenseMapCopy() const {
 	std::lock_guard<std::mutex> lck(denseMapMutex_);
+	if (isDenseMapCompact_) {
+		VoxelizedPointCloud copy(denseMap_.getVoxelSize());
+		PointCloud cloud;
+		std::vector<int> numAggregatedPoints;
+		compactDenseMap_.decode(&cloud, &numAggregatedPoints);
+		copy.insert(cloud, numAggregatedPoints);
+		return std::move(copy);
+	}
 	auto copy = denseMap_;
 	return std::move(copy);
 }
 
+size_t Submap::getNumMapPoints() const {
+	std::lock_guard<std::mutex> lck(mapPointCloudMutex_);
+	return isMapCloudCompact_ ? compactMapCloud_.size() : mapCloud_.points_.size();
+}
+
+void Submap::compactMaps(const Time &finishTime) {
+	const auto &p = params_.compactStorage_;
+	if (!p.isEnabled_) {
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lck(mapPointCloudMutex_);
+		if (!isMapCloudCompact_ && !mapCloud_.IsEmpty()) {
+			eraseRemovedMapPoints();
+			const double voxelSize = getMapVoxelSize(params_.mapBuilder_,
+					magic::voxelSizeCorrespondenceSearchIfMapVoxelSizeIsZero);
+			compactMapCloud_.encode(mapCloud_, mapToSubmap_, p.resolutionRatio_ * voxelSize);
+			mapCloud_ = PointCloud();
+			isMapCloudCompact_ = true;
+			// the lookup structures are rebuilt from the decoded points if needed
+			mapVoxelIndex_.clear();
+			isMapVoxelIndexValid_ = false;
+			ndtMap_.clear();
+			isNdtMapValid_ = false;
+			occupancyMap_.clear();
+			isOccupancyMapPointsValid_ = false;
+		}
+	}
+	{
+		std::lock_guard<std::mutex> lck(denseMapMutex_);
+		isFinished_ = true;
+		finishTime_ = finishTime;
+		compactDenseMap();
+	}
+}
+
+void Submap::compactDenseMap() {
+	if (!params_.compactStorage_.isEnabled_ || isDenseMapCompact_ || denseMap_.empty()) {
+		return;
+	}
+	const double voxelSize = getMapVoxelSize(params_.denseMapBuilder_,
+			magic::voxelSizeCorrespondenceSearchIfMapVoxelSizeIsZero);
+	// keep the voxel point counts so that the averages weigh the same once the submap is active again
+	std::vector<int> numAggregatedPoints;
+	const PointCloud cloud = denseMap_.toPointCloud(&numAggregatedPoints);
+	compactDenseMap_.encode(cloud, mapToSubmap_, params_.compactStorage_.resolutionRatio_ * voxelSize,
+			numAggregatedPoints);
+	denseMap_ = VoxelizedPointCloud(denseMap_.getVoxelSize());
+	isDenseMapCompact_ = true;
+}
+
+void Submap::expandMapPointCloud() const {
+	if (!isMapCloudCompact_) {
+		return;
+	}
+	compactMapCloud_.decode(&mapCloud_);
+	compactMapCloud_.clear();
+	isMapCloudCompact_ = false;
+}
+
+void Submap::expandDenseMap() const {
+	if (!isDenseMapCompact_) {
+		return;
+	}
+	PointCloud cloud;
+	std::vector<int> numAggregatedPoints;
+	compactDenseMap_.decode(&cloud, &numAggregatedPoints);
+	denseMap_.insert(cloud, numAggregatedPoints);
+	compactDenseMap_.clear();
+	isDenseMapCompact_ = false;
+}
+
 const Submap::PointCloud& Submap::getSparseMapPointCloud() const {
 	return sparseMapCloud_;
 }
@@ -215,10 +449,32 @@ void Submap::setMapToSubmapOrigin(const Transform &T) {
 	mapToSubmap_ = T;
 }
 
+void Submap::setMapPointCloud(const PointCloud &cloud) {
+	std::lock_guard<std::mutex> lck(mapPointCloudMutex_);
+	mapCloud_ = cloud;
+	compactMapCloud_.clear();
+	isMapCloudCompact_ = false;
+	isMapVoxelIndexValid_ = false;
+	isNdtMapValid_ = false;
+	occupancyMap_.clear();
+	isOccupancyMapPointsValid_ = false;
+	clearRemovedMapPoints();
+}
+
 void Submap::update(const MapperParameters &p) {
 	mapBuilderCropper_ = croppingVolumeFactory(p.mapBuilder_.cropper_);
 	denseMapCropper_ = croppingVolumeFactory(p.denseMapBuilder_.cropper_);
 	denseMap_ = std::move(VoxelizedPointCloud(Eigen::Vector3d::Constant(p.denseMapBuilder_.mapVoxelSize_)));
+	compactDenseMap_.clear();
+	isDenseMapCompact_ = false;
+	mapVoxelIndex_ = std::move(PointCloudVoxelIndex(Eigen::Vector3d::Constant(p.mapBuilder_.mapVoxelSize_)));
+	isMapVoxelIndexValid_ = false;
+	ndtMap_ = std::move(
+			NdtVoxelMap(Eigen::Vector3d::Constant(p.scanMatcher_.ndt_.voxelSize_), p.scanMatcher_.ndt_.minNumPointsPerVoxel_));
+	isNdtMapValid_ = false;
+	occupancyMap_ = std::move(
+			OccupancyVoxelMap(Eigen::Vector3d::Constant(p.mapBuilder_.carving_.voxelSize_), p.mapBuilder_.carving_));
+	isOccupancyMapPointsValid_ = false;
 
 	//todo remove magic
 	voxelMap_ = std::move(
@@ -228,26 +484,93 @@ void Submap::update(const MapperParameters &p) {
 }
 
 bool Submap::isEmpty() const {
-	return mapCloud_.points_.empty();
+	return getNumMapPoints() == 0;
 }
 
 const VoxelMap& Submap::getVoxelMap() const {
 	return voxelMap_;
 }
 
-void Submap::computeFeatures() {
+NdtVoxelMap Submap::getNdtMapCopy() const {
+	std::lock_guard<std::mutex> lck(mapPointCloudMutex_);
+	if (!isNdtMapValid_) {
+		expandMapPointCloud();
+		ndtMap_.rebuild(mapCloud_, isMapPointRemoved_);
+		isNdtMapValid_ = true;
+	}
+	return ndtMap_;
+}
+
+bool Submap::isUseNdtMap() const {
+	return params_.scanMatcher_.scanToMapRegType_ == ScanToMapRegistrationType::Ndt;
+}
+
+void Submap::setMeshDirty() {
+	std::lock_guard<std::mutex> lck(meshMutex_);
+	isMeshDirty_ = true;
+}
+
+bool Submap::isMeshDirty() const {
+	std::lock_guard<std::mutex> lck(meshMutex_);
+	return isMeshDirty_;
+}
+
+std::shared_ptr<const TriangleMesh> Submap::getMesh() const {
+	std::lock_guard<std::mutex> lck(meshMutex_);
+	return mesh_;
+}
+
+void Submap::computeMesh() {
+	size_t nTransforms = 0;
+	{
+		std::lock_guard<std::mutex> lck(meshMutex_);
+		if (!isMeshDirty_) {
+			return;
+		}
+		isMeshDirty_ = false;
+		nTransforms = nMeshTransforms_;
+	}
+	const auto &p = params_.meshing_;
+	const bool isMeshDenseMap = params_.isBuildDenseMap_;
+	PointCloud cloud = isMeshDenseMap ? getDenseMapCopy().toPointCloud() : getMapPointCloudCopy();
+	const double mapVoxelSize = getMapVoxelSize(isMeshDenseMap ? params_.denseMapBuilder_ : params_.mapBuilder_,
+			magic::voxelSizeCorrespondenceSearchIfMapVoxelSizeIsZero);
+	const double voxelSize = p.voxelSize_ > 0.0 ? p.voxelSize_ : mapVoxelSize;
+	if (!cloud.IsEmpty() && !cloud.HasNormals()) {
+		// e.g. an initial map, the sensor poses are unknown
+		estimateNormals(p.knnNormalEstimation_, &cloud);
+		cloud.OrientNormalsConsistentTangentPlane(p.knnNormalEstimation_);
+	}
+	const auto mesh = computeSurfaceMesh(cloud, voxelSize, p.truncationDistanceRatio_ * voxelSize);
+	std::lock_guard<std::mutex> lck(meshMutex_);
+	if (nTransforms != nMeshTransforms_) {
+		isMeshDirty_ = true; // meshed in the frame before the transform
+		return;
+	}
+	mesh_ = mesh;
+}
+
+void Submap::computeFeatures(ThreadPool *threadPool) {
 	if (feature_ != nullptr
 			&& featureTimer_.elapsedSec() < params_.submaps_.minSecondsBetweenFeatureComputation_) {
 		return;
 	}
+	{
+		std::lock_guard<std::mutex> lck(mapPointCloudMutex_);
+		eraseRemovedMapPoints();
+	}
 
-	std::thread computeVoxelMapThread([this]() {
+	const auto mapCopy = getMapPointCloudCopy();
+	auto computeVoxelMap = [this, &mapCopy]() {
 //		Timer t("compute_voxel_submap");
 		voxelMap_.clear();
-		voxelMap_.insertCloud(voxelMapLayer,mapCloud_);
-	});
+		voxelMap_.insertCloud(voxelMapLayer,mapCopy);
+	};
+	std::future<void> voxelMapResult =
+			threadPool != nullptr ?
+					threadPool->enqueue(computeVoxelMap) :
+					std::async(std::launch::async, computeVoxelMap);
 
-	auto mapCopy = getMapPointCloudCopy();
 	const auto &p = params_.placeRecognition_;
 	sparseMapCloud_ = *(mapCopy.VoxelDownSample(p.featureVoxelSize_));
 	sparseMapCloud_.EstimateNormals(
@@ -256,7 +579,11 @@ void Submap::computeFeatures() {
 	sparseMapCloud_.OrientNormalsTowardsCameraLocation(Eigen::Vector3d::Zero());
 	feature_ = registration::ComputeFPFHFeature(sparseMapCloud_,
 			open3d::geometry::KDTreeSearchParamHybrid(p.featureRadius_, p.featureKnn_));
-	computeVoxelMapThread.join();
+	if (threadPool != nullptr) {
+		threadPool->waitFor(voxelMapResult);
+	} else {
+		voxelMapResult.get();
+	}
 	featureTimer_.reset();
 }
 
@@ -15,16 +15,25 @@
 #include "open3d_slam/constraint_builders.hpp"
 
 #include <open3d/io/PointCloudIO.h>
+#include <yaml-cpp/yaml.h>
 #include <open3d/pipelines/registration/Registration.h>
 
 #include <algorithm>
 #include <numeric>
 #include <utility>
 #include <set>
-#include <thread>
+#include <future>
+#include <fstream>
 
 namespace o3d_slam {
 
+namespace {
+const std::string sessionFilename = "session.yaml";
+std::string getSessionSubmapFilename(const std::string &folderPath, size_t submapId) {
+	return folderPath + "session_submap_" + std::to_string(submapId) + ".pcd";
+}
+} // namespace
+
 SubmapCollection::SubmapCollection() {
 	submaps_.reserve(500);
 	createNewSubmap(mapToRangeSensor_);
@@ -69,7 +78,7 @@ size_t SubmapCollection::numLoopClosureCandidates() const {
 size_t SubmapCollection::getTotalNumPoints() const {
 	const int nSubmaps = submaps_.size();
 	return std::accumulate(submaps_.begin(), submaps_.end(), 0, [](size_t sum, const Submap &s) {
-		return sum + s.getMapPointCloud().points_.size();
+		return sum + s.getNumMapPoints();
 	});
 }
 
@@ -133,6 +142,32 @@ void SubmapCollection::updateActiveSubmap(const Transform &mapToRangeSensor, con
 	}
 }
 
+// the first submap of a new trajectory is a child of the closest submap of the loaded session, the odometry
+// constraint between them anchors the trajectories to each other in the pose graph
+void SubmapCollection::startNewTrajectory(const Transform &mapToRangeSensor) {
+	activeSubmapIdx_ = findClosestSubmap(mapToRangeSensor);
+	const size_t parentIdx = activeSubmapIdx_;
+	trajectoryStartIdxs_.push_back(submaps_.size());
+	createNewSubmap(mapToRangeSensor);
+	adjacencyMatrix_.addEdge(submaps_.at(parentIdx).getId(), submaps_.at(activeSubmapIdx_).getId());
+	lastFinishedSubmapIdx_ = parentIdx;
+	overlapScansBuffer_.clear();
+	isStartingNewTrajectory_ = false;
+}
+
+bool SubmapCollection::isStartingNewTrajectory() const {
+	return isStartingNewTrajectory_;
+}
+
+size_t SubmapCollection::getTrajectoryIdx(size_t submapIdx) const {
+	return std::upper_bound(trajectoryStartIdxs_.begin(), trajectoryStartIdxs_.end(), submapIdx)
+			- trajectoryStartIdxs_.begin() - 1;
+}
+
+bool SubmapCollection::isSameTrajectory(size_t submapIdx1, size_t submapIdx2) const {
+	return getTrajectoryIdx(submapIdx1) == getTrajectoryIdx(submapIdx2);
+}
+
 void SubmapCollection::createNewSubmap(const Transform &mapToSubmap) {
 	const size_t submapId = submapId_++;
 	const size_t submapParentId = activeSubmapIdx_;
@@ -165,7 +200,7 @@ const Submap& SubmapCollection::getActiveSubmap() const {
 }
 
 void SubmapCollection::forceNewSubmapCreation(){
-	if (submaps_.empty()){
+	if (submaps_.empty() || isStartingNewTrajectory_){
 		return;
 	}
 	isForceNewSubmapCreation_ = true;
@@ -178,8 +213,12 @@ bool SubmapCollection::insertScan(const PointCloud &rawScan, const PointCloud &p
 
 	mapToRangeSensor_ = mapToRangeSensor;
 	timestamp_ = timestamp;
-	if (submaps_.empty()) {
-		createNewSubmap(mapToRangeSensor_);
+	if (submaps_.empty() || isStartingNewTrajectory_) {
+		if (isStartingNewTrajectory_) {
+			startNewTrajectory(mapToRangeSensor_);
+		} else {
+			createNewSubmap(mapToRangeSensor_);
+		}
 		submaps_.at(activeSubmapIdx_).insertScan(rawScan, preProcessedScan, mapToRangeSensor, timestamp, true);
 		++numScansMergedInActiveSubmap_;
 		return true;
@@ -193,6 +232,7 @@ bool SubmapCollection::insertScan(const PointCloud &rawScan, const PointCloud &p
 		std::lock_guard<std::mutex> lck(featureComputationMutex_);
 		submaps_.at(prevActiveSubmapIdx).insertScan(rawScan, preProcessedScan, mapToRangeSensor, timestamp, true);
 		submaps_.at(prevActiveSubmapIdx).computeSubmapCenter();
+		submaps_.at(prevActiveSubmapIdx).compactMaps(timestamp);
 		std::cout << "Active submap changed from " << prevActiveSubmapIdx << " to " << activeSubmapIdx_ << "\n";
 		lastFinishedSubmapIdx_ = prevActiveSubmapIdx;
 		TimestampedSubmapId timestampedId { prevActiveSubmapIdx, timestamp };
@@ -230,19 +270,26 @@ void SubmapCollection::computeFeatures(const TimestampedSubmapIds &finishedSubma
 		for (const auto &id : finishedSubmapIds) {
 //			std::cout << "computing features for submap: " << id.submapId_ << std::endl;
 //			std::cout << "submap size: " << submaps_.at(id.submapId_).getMapPointCloud().points_.size() << std::endl;
-			submaps_.at(id.submapId_).computeFeatures();
+			submaps_.at(id.submapId_).computeFeatures(threadPool_.get());
 			loopClosureCandidatesIdxs_.push(id);
 		}
 	};
 
-	std::thread t(featureComputation);
+	std::future<void> featureResult =
+			threadPool_ != nullptr ?
+					threadPool_->enqueue(featureComputation) :
+					std::async(std::launch::async, featureComputation);
 
 	{
 //		Timer t("odometry_constraint_computation");
 		computeOdometryConstraints(*this, finishedSubmapIds, &odometryConstraints_);
 	}
 
-	t.join();
+	if (threadPool_ != nullptr) {
+		threadPool_->waitFor(featureResult);
+	} else {
+		featureResult.get();
+	}
 	isComputingFeatures_ = false;
 }
 
@@ -286,6 +333,102 @@ bool SubmapCollection::dumpToFile(const std::string &folderPath, const std::stri
 	return result;
 }
 
+bool SubmapCollection::saveSession(const std::string &folderPath) const {
+	YAML::Emitter out;
+	out << YAML::BeginMap << YAML::Key << "submaps" << YAML::Value << YAML::BeginSeq;
+	bool result = true;
+	for (const auto &submap : submaps_) {
+		const Transform &T = submap.getMapToSubmapOrigin();
+		const Eigen::Quaterniond q(T.linear());
+		out << YAML::BeginMap;
+		out << YAML::Key << "id" << YAML::Value << submap.getId();
+		out << YAML::Key << "parent_id" << YAML::Value << submap.getParentId();
+		out << YAML::Key << "map_to_submap_origin" << YAML::Value << YAML::Flow
+				<< std::vector<double> { T.translation().x(), T.translation().y(), T.translation().z(), q.w(), q.x(), q.y(),
+						q.z() };
+		out << YAML::EndMap;
+		result = result
+				&& open3d::io::WritePointCloudToPCD(getSessionSubmapFilename(folderPath, submap.getId()),
+						submap.getMapPointCloudCopy(), open3d::io::WritePointCloudOption());
+	}
+	out << YAML::EndSeq;
+	out << YAML::Key << "trajectory_start_ids" << YAML::Value << YAML::Flow << trajectoryStartIdxs_;
+	out << YAML::EndMap;
+	std::ofstream file(folderPath + sessionFilename);
+	file << out.c_str();
+	return result && file.good();
+}
+
+bool SubmapCollection::loadSession(const std::string &folderPath, const Constraints &odometryConstraints,
+		const Constraints &loopClosureConstraints) {
+	const YAML::Node node = YAML::LoadFile(folderPath + sessionFilename);
+	if (!node["submaps"].IsDefined() || node["submaps"].size() == 0) {
+		std::cerr << "Session in " << folderPath << " has no submaps \n";
+		return false;
+	}
+	submaps_.clear();
+	adjacencyMatrix_.clear();
+	overlapScansBuffer_.clear();
+	for (const auto &submapNode : node["submaps"]) {
+		const size_t id = submapNode["id"].as<size_t>();
+		const size_t parentId = submapNode["parent_id"].as<size_t>();
+		assert_eq(id, submaps_.size(), "Session submaps are expected to be stored in order of their ids: ");
+		const std::vector<double> pose = submapNode["map_to_submap_origin"].as<std::vector<double>>();
+		assert_eq<size_t>(pose.size(), 7, "Session submap origin should be xyz + quaternion wxyz: ");
+		Transform mapToSubmap = Transform::Identity();
+		mapToSubmap.translation() = Eigen::Vector3d(pose[0], pose[1], pose[2]);
+		mapToSubmap.linear() = Eigen::Quaterniond(pose[3], pose[4], pose[5], pose[6]).normalized().toRotationMatrix();
+
+		PointCloud cloud;
+		if (!open3d::io::ReadPointCloud(getSessionSubmapFilename(folderPath, id), cloud)) {
+			std::cerr << "Could not read session submap " << id << " from " << folderPath << "\n";
+			return false;
+		}
+		Submap submap(id, parentId);
+		submap.setParameters(params_);
+		submap.setMapToSubmapOrigin(mapToSubmap);
+		submap.setMapPointCloud(cloud);
+		submap.computeSubmapCenter();
+		submaps_.emplace_back(std::move(submap));
+		if (id != parentId) {
+			adjacencyMatrix_.addEdge(parentId, id);
+		}
+	}
+
+	if (threadPool_ != nullptr) {
+		std::vector<std::future<void>> featureResults;
+		featureResults.reserve(submaps_.size());
+		for (auto &submap : submaps_) {
+			featureResults.push_back(threadPool_->enqueue([this, &submap]() {
+				submap.computeFeatures(threadPool_.get());
+			}));
+		}
+		for (auto &result : featureResults) {
+			threadPool_->waitFor(result);
+		}
+	} else {
+		for (auto &submap : submaps_) {
+			submap.computeFeatures();
+		}
+	}
+
+	trajectoryStartIdxs_ = { 0 };
+	if (node["trajectory_start_ids"].IsDefined()) {
+		trajectoryStartIdxs_ = node["trajectory_start_ids"].as<std::vector<size_t>>();
+	}
+	submapId_ = submaps_.size();
+	odometryConstraints_ = odometryConstraints;
+	updateAdjacencyMatrix(loopClosureConstraints);
+	// placeholder until the first scan, which opens the submap of the new trajectory
+	activeSubmapIdx_ = submaps_.size() - 1;
+	lastFinishedSubmapIdx_ = activeSubmapIdx_;
+	numScansMergedInActiveSubmap_ = 0;
+	isStartingNewTrajectory_ = true;
+	std::cout << "Loaded session with " << submaps_.size() << " submaps in " << trajectoryStartIdxs_.size()
+			<< " trajectories \n";
+	return true;
+}
+
 void SubmapCollection::transform(const OptimizedTransforms &transformIncrements) {
 	const size_t nTransforms = transformIncrements.size();
 	std::vector<size_t> optimizedIdxs;
@@ -356,6 +499,10 @@ void SubmapCollection::setFolderPath(const std::string &folderPath) {
 	placeRecognition_.setFolderPath(folderPath);
 }
 
+void SubmapCollection::setThreadPool(std::shared_ptr<ThreadPool> threadPool) {
+	threadPool_ = threadPool;
+}
+
 bool SubmapCollection::isSwitchingSubmapsConsistant(const PointCloud &scan,
 		size_t newActiveSubmapCandidate, const Transform &mapToRangeSensor) const {
 	//Timer("submap_switch_consistency_check");
@@ -0,0 +1,173 @@
+/*
+ * SurfaceMesh.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "open3d_slam/SurfaceMesh.hpp"
+#include "open3d_slam/VoxelHashMap.hpp"
+#include "open3d_slam/assert.hpp"
+
+#include <cmath>
+#include <unordered_map>
+
+namespace o3d_slam {
+
+namespace {
+
+struct TsdfSample {
+	double weightedDistance_ = 0.0;
+	double weight_ = 0.0;
+	Eigen::Vector3d weightedColor_ = Eigen::Vector3d::Zero();
+	double distance() const {
+		return weightedDistance_ / weight_;
+	}
+};
+
+using TsdfGrid = std::unordered_map<Eigen::Vector3i, TsdfSample, EigenVec3iHash>;
+using CellVertices = std::unordered_map<Eigen::Vector3i, int, EigenVec3iHash>;
+
+const int kCellEdges[12][2] = { { 0, 1 }, { 2, 3 }, { 4, 5 }, { 6, 7 }, { 0, 2 }, { 1, 3 }, { 4, 6 }, { 5, 7 },
+		{ 0, 4 }, { 1, 5 }, { 2, 6 }, { 3, 7 } };
+
+// corner i of a cell has the offset (i & 1, (i >> 1) & 1, (i >> 2) & 1)
+Eigen::Vector3i cornerOffset(int i) {
+	return Eigen::Vector3i(i & 1, (i >> 1) & 1, (i >> 2) & 1);
+}
+
+TsdfGrid integrate(const PointCloud &cloud, double voxelSize, double truncationDistance) {
+	TsdfGrid grid;
+	grid.reserve(cloud.points_.size() * 8);
+	const bool isColored = cloud.HasColors();
+	const int radius = static_cast<int>(std::ceil(truncationDistance / voxelSize));
+	for (size_t i = 0; i < cloud.points_.size(); ++i) {
+		const Eigen::Vector3d &p = cloud.points_[i];
+		const double normalLength = cloud.normals_[i].norm();
+		if (normalLength < 1e-6) {
+			continue;
+		}
+		const Eigen::Vector3d n = cloud.normals_[i] / normalLength;
+		const Eigen::Vector3i base = getVoxelIdx(p, Eigen::Vector3d::Constant(voxelSize));
+		for (int x = 1 - radius; x <= radius; ++x) {
+			for (int y = 1 - radius; y <= radius; ++y) {
+				for (int z = 1 - radius; z <= radius; ++z) {
+					const Eigen::Vector3i key = base + Eigen::Vector3i(x, y, z);
+					const Eigen::Vector3d d = key.cast<double>() * voxelSize - p;
+					const double distance = d.norm();
+					if (distance >= truncationDistance) {
+						continue;
+					}
+					const double weight = 1.0 - distance / truncationDistance;
+					auto &sample = grid[key];
+					sample.weightedDistance_ += weight * n.dot(d);
+					sample.weight_ += weight;
+					if (isColored) {
+						sample.weightedColor_ += weight * cloud.colors_[i];
+					}
+				}
+			}
+		}
+	}
+	return grid;
+}
+
+// places a vertex in every cell with a sign change at the mean of the edge crossings
+CellVertices computeCellVertices(const TsdfGrid &grid, double voxelSize, bool isColored, TriangleMesh *mesh) {
+	CellVertices cellVertices;
+	const TsdfSample *corners[8];
+	for (const auto &sample : grid) {
+		const Eigen::Vector3i &cell = sample.first;
+		bool isComplete = true;
+		bool hasInside = false, hasOutside = false;
+		for (int i = 0; i < 8 && isComplete; ++i) {
+			const auto search = grid.find(cell + cornerOffset(i));
+			isComplete = search != grid.end();
+			if (isComplete) {
+				corners[i] = &search->second;
+				hasInside = hasInside || corners[i]->distance() < 0.0;
+				hasOutside = hasOutside || corners[i]->distance() >= 0.0;
+			}
+		}
+		if (!isComplete || !hasInside || !hasOutside) {
+			continue;
+		}
+		Eigen::Vector3d vertex = Eigen::Vector3d::Zero();
+		int nCrossings = 0;
+		for (const auto &edge : kCellEdges) {
+			const double d0 = corners[edge[0]]->distance();
+			const double d1 = corners[edge[1]]->distance();
+			if ((d0 < 0.0) == (d1 < 0.0)) {
+				continue;
+			}
+			const double t = d0 / (d0 - d1);
+			vertex += (1.0 - t) * cornerOffset(edge[0]).cast<double>() + t * cornerOffset(edge[1]).cast<double>();
+			++nCrossings;
+		}
+		vertex = (cell.cast<double>() + vertex / nCrossings) * voxelSize;
+		cellVertices[cell] = mesh->vertices_.size();
+		mesh->vertices_.push_back(vertex);
+		if (isColored) {
+			Eigen::Vector3d color = Eigen::Vector3d::Zero();
+			for (const auto *corner : corners) {
+				color += corner->weightedColor_ / corner->weight_;
+			}
+			mesh->vertex_colors_.push_back(color / 8.0);
+		}
+	}
+	return cellVertices;
+}
+
+// two triangles for every grid edge with a sign change, joining the vertices of the four cells around it
+void computeTriangles(const TsdfGrid &grid, const CellVertices &cellVertices, TriangleMesh *mesh) {
+	for (const auto &sample : grid) {
+		const Eigen::Vector3i &key = sample.first;
+		const bool isInside = sample.second.distance() < 0.0;
+		for (int a = 0; a < 3; ++a) {
+			const auto neighbor = grid.find(key + Eigen::Vector3i::Unit(a));
+			if (neighbor == grid.end() || (neighbor->second.distance() < 0.0) == isInside) {
+				continue;
+			}
+			const Eigen::Vector3i eb = Eigen::Vector3i::Unit((a + 1) % 3);
+			const Eigen::Vector3i ec = Eigen::Vector3i::Unit((a + 2) % 3);
+			// counter clockwise around the edge when looking against the axis a
+			const Eigen::Vector3i cells[4] = { key, key - eb, key - eb - ec, key - ec };
+			int v[4];
+			bool isComplete = true;
+			for (int i = 0; i < 4 && isComplete; ++i) {
+				const auto search = cellVertices.find(cells[i]);
+				isComplete = search != cellVertices.end();
+				v[i] = isComplete ? search->second : -1;
+			}
+			if (!isComplete) {
+				continue;
+			}
+			// the normals point towards positive distances
+			if (isInside) {
+				mesh->triangles_.emplace_back(v[0], v[1], v[2]);
+				mesh->triangles_.emplace_back(v[0], v[2], v[3]);
+			} else {
+				mesh->triangles_.emplace_back(v[0], v[2], v[1]);
+				mesh->triangles_.emplace_back(v[0], v[3], v[2]);
+			}
+		}
+	}
+}
+
+} // namespace
+
+std::shared_ptr<TriangleMesh> computeSurfaceMesh(const PointCloud &cloud, double voxelSize,
+		double truncationDistance) {
+	assert_gt(voxelSize, 0.0, "computeSurfaceMesh voxel size");
+	assert_gt(truncationDistance, 0.0, "computeSurfaceMesh truncation distance");
+	auto mesh = std::make_shared<TriangleMesh>();
+	if (!cloud.HasNormals()) {
+		return mesh;
+	}
+	const TsdfGrid grid = integrate(cloud, voxelSize, truncationDistance);
+	const CellVertices cellVertices = computeCellVertices(grid, voxelSize, cloud.HasColors(), mesh.get());
+	computeTriangles(grid, cellVertices, mesh.get());
+	mesh->ComputeVertexNormals();
+	return mesh;
+}
+
+} // namespace o3d_slam
@@ -0,0 +1,124 @@
+/*
+ * ThreadPool.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include "open3d_slam/ThreadPool.hpp"
+#include "open3d_slam/assert.hpp"
+
+#include <iostream>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#ifdef open3d_slam_OPENMP_FOUND
+#include <omp.h>
+#endif
+
+namespace o3d_slam {
+
+namespace {
+const int kNicenessStep = 2;
+}
+
+void configureCurrentThread(const ThreadingParameters &p, ThreadPriority priority) {
+#ifdef open3d_slam_OPENMP_FOUND
+	// the thread count is a per thread setting, hence it is set in every thread that runs omp loops
+	if (p.numOmpThreads_ > 0) {
+		omp_set_num_threads(p.numOmpThreads_);
+	}
+#endif
+#ifdef __linux__
+	if (!p.cpuAffinity_.empty()) {
+		cpu_set_t cpuSet;
+		CPU_ZERO(&cpuSet);
+		for (const int cpu : p.cpuAffinity_) {
+			CPU_SET(cpu, &cpuSet);
+		}
+		if (pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuSet) != 0) {
+			std::cerr << "WARNING: could not set the cpu affinity of a slam thread \n";
+		}
+	}
+	if (p.isSetThreadPriorities_) {
+		// nice values are per thread on linux, raising them does not need privileges
+		const id_t tid = static_cast<id_t>(syscall(SYS_gettid));
+		const int niceness = getpriority(PRIO_PROCESS, tid) + kNicenessStep * static_cast<int>(priority);
+		if (setpriority(PRIO_PROCESS, tid, niceness) != 0) {
+			std::cerr << "WARNING: could not set the priority of a slam thread \n";
+		}
+	}
+#endif
+}
+
+ThreadPool::ThreadPool(size_t numThreads, const std::function<void()> &onThreadStart) {
+	assert_gt<size_t>(numThreads, 0, "thread pool needs at least one thread: ");
+	workers_.reserve(numThreads);
+	for (size_t i = 0; i < numThreads; ++i) {
+		workers_.emplace_back([this, onThreadStart]() {
+			if (onThreadStart) {
+				onThreadStart();
+			}
+			workerLoop();
+		});
+	}
+}
+
+ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard<std::mutex> lck(tasksMutex_);
+		isStopped_ = true;
+	}
+	tasksCv_.notify_all();
+	for (auto &worker : workers_) {
+		worker.join();
+	}
+}
+
+size_t ThreadPool::getNumThreads() const {
+	return workers_.size();
+}
+
+bool ThreadPool::popTask(std::function<void()> *task) {
+	if (tasks_.empty()) {
+		return false;
+	}
+	*task = std::move(tasks_.front());
+	tasks_.pop_front();
+	return true;
+}
+
+bool ThreadPool::runPendingTask() {
+	std::function<void()> task;
+	{
+		std::lock_guard<std::mutex> lck(tasksMutex_);
+		if (!popTask(&task)) {
+			return false;
+		}
+	}
+	task();
+	return true;
+}
+
+void ThreadPool::workerLoop() {
+	while (true) {
+		std::function<void()> task;
+		{
+			std::unique_lock<std::mutex> lck(tasksMutex_);
+			tasksCv_.wait(lck, [this]() {
+				return isStopped_ || !tasks_.empty();
+			});
+			if (!popTask(&task)) {
+				return; // stopped and drained
+			}
+		}
+		task();
+	}
+}
+
+} // namespace o3d_slam
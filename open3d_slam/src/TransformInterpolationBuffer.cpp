@@ -8,137 +8,237 @@
 #include "open3d_slam/time.hpp"
 #include "open3d_slam/assert.hpp"
 
+#include <algorithm>
 #include <iostream>
 
 namespace o3d_slam {
 
+namespace {
+const size_t kInitialCapacity = 64;
+} // namespace
+
+bool TransformBufferSnapshot::empty() const {
+	return begin_ == end_;
+}
+
+size_t TransformBufferSnapshot::size() const {
+	return end_ - begin_;
+}
+
+uint64_t TransformBufferSnapshot::version() const {
+	return version_;
+}
+
+bool TransformBufferSnapshot::has(const Time &time) const {
+	if (empty()) {
+		return false;
+	}
+	return at(0).time_ <= time && time <= at(size() - 1).time_;
+}
+
+Transform TransformBufferSnapshot::lookup(const Time &time) const {
+	if (!has(time)) {
+		throw std::runtime_error("TransformInterpolationBuffer:: Missing transform for: " + toString(time));
+	}
+	return lookupImpl(time);
+}
+
+Transform TransformBufferSnapshot::lookupClamped(const Time &time) const {
+	if (empty()) {
+		throw std::runtime_error("TransformInterpolationBuffer:: Empty buffer");
+	}
+	if (time < at(0).time_) {
+		return at(0).transform_;
+	}
+	if (at(size() - 1).time_ < time) {
+		return at(size() - 1).transform_;
+	}
+	return lookupImpl(time);
+}
+
+Time TransformBufferSnapshot::earliest_time() const {
+	if (empty()) {
+		throw std::runtime_error("TransformInterpolationBuffer:: Empty buffer");
+	}
+	return at(0).time_;
+}
+
+Time TransformBufferSnapshot::latest_time() const {
+	if (empty()) {
+		throw std::runtime_error("TransformInterpolationBuffer:: Empty buffer");
+	}
+	return at(size() - 1).time_;
+}
+
+const TimestampedTransform& TransformBufferSnapshot::latest_measurement(int offsetFromLastElement /*=0*/) const {
+	if (empty()) {
+		throw std::runtime_error("TransformInterpolationBuffer:: latest_measurement: Empty buffer");
+	}
+	if (offsetFromLastElement < 0 || static_cast<size_t>(offsetFromLastElement) >= size()) {
+		throw std::runtime_error("TransformInterpolationBuffer:: latest_measurement: offset out of range");
+	}
+	return at(size() - 1 - offsetFromLastElement);
+}
+
+const TimestampedTransform& TransformBufferSnapshot::at(size_t idx) const {
+	return (*storage_)[begin_ + idx];
+}
+
+Transform TransformBufferSnapshot::lookupImpl(const Time &time) const {
+	const size_t idx = lowerBound(time);
+	const TimestampedTransform &getMeasurement = at(idx);
+	if (idx == 0 || getMeasurement.time_ == time) {
+		return getMeasurement.transform_;
+	}
+	return interpolate(at(idx - 1), getMeasurement, time).transform_;
+}
+
+size_t TransformBufferSnapshot::lowerBound(const Time &time) const {
+	const auto first = storage_->begin() + begin_;
+	const auto it = std::lower_bound(first, storage_->begin() + end_, time,
+			[](const TimestampedTransform &tf, const Time &t) {
+				return tf.time_ < t;
+			});
+	return std::distance(first, it);
+}
+
 TransformInterpolationBuffer::TransformInterpolationBuffer() :
 		TransformInterpolationBuffer(2000) {
 }
 
-TransformInterpolationBuffer::TransformInterpolationBuffer(size_t bufferSize) {
+TransformInterpolationBuffer::TransformInterpolationBuffer(size_t bufferSize) :
+		storage_(std::make_shared<Storage>()) {
+	auto empty = std::make_shared<TransformBufferSnapshot>();
+	empty->storage_ = storage_;
+	snapshot_ = std::move(empty);
 	setSizeLimit(bufferSize);
 }
 
-void TransformInterpolationBuffer::push(const Time &time, const Transform &tf) {
+void TransformInterpolationBuffer::publish(std::shared_ptr<TransformBufferSnapshot> snapshot) {
+	snapshot->version_ = std::atomic_load(&snapshot_)->version_ + 1;
+	std::atomic_store(&snapshot_, SnapshotPtr(std::move(snapshot)));
+}
+
+// the old block stays alive as long as some reader holds a snapshot of it
+void TransformInterpolationBuffer::moveToNewStorage(const TransformBufferSnapshot &current, size_t numKept,
+		size_t capacity) {
+	auto storage = std::make_shared<Storage>(std::max(capacity, numKept));
+	std::copy(current.storage_->begin() + current.end_ - numKept, current.storage_->begin() + current.end_,
+			storage->begin());
+	storage_ = std::move(storage);
+}
 
+TransformInterpolationBuffer::SnapshotPtr TransformInterpolationBuffer::snapshot() const {
+	return std::atomic_load(&snapshot_);
+}
+
+uint64_t TransformInterpolationBuffer::version() const {
+	return snapshot()->version();
+}
+
+void TransformInterpolationBuffer::push(const Time &time, const Transform &tf) {
+	std::lock_guard<std::mutex> lck(writerMutex_);
+	const SnapshotPtr current = snapshot();
 	//this relies that they will be pushed in order!!!
-	if (!transforms_.empty()) {
-		if (time < earliest_time()) {
+	if (!current->empty()) {
+		if (time < current->earliest_time()) {
 			std::cerr
 					<< "TransformInterpolationBuffer:: you are trying to push something earlier than the earliest measurement, this should not happen \n";
 			std::cerr << "ingnoring the mesurement \n";
 			std::cerr << "Time: " << toSecondsSinceFirstMeasurement(time) << std::endl;
-			std::cerr << "earliest time: " << toSecondsSinceFirstMeasurement(earliest_time()) << std::endl;
+			std::cerr << "earliest time: " << toSecondsSinceFirstMeasurement(current->earliest_time()) << std::endl;
 			return;
 		}
 
-		if (time < latest_time()) {
+		if (time < current->latest_time()) {
 			std::cerr
 					<< "TransformInterpolationBuffer:: you are trying to push something out of order, this should not happen \n";
 			std::cerr << "ingnoring the mesurement \n";
 			std::cerr << "Time: " << time << std::endl;
-			std::cerr << "latest time: " << toSecondsSinceFirstMeasurement(latest_time()) << std::endl;
+			std::cerr << "latest time: " << toSecondsSinceFirstMeasurement(current->latest_time()) << std::endl;
 			return;
 		}
 	}
-	transforms_.push_back( { time, tf });
-	removeOldMeasurementsIfNeeded();
+	const size_t limit = bufferSizeLimit_;
+	if (limit == 0) {
+		return;
+	}
+	// write past the end of the published window, readers never look there
+	const size_t numKept = std::min(current->size(), limit - 1);
+	size_t end = current->end_;
+	if (end == storage_->size()) {
+		moveToNewStorage(*current, numKept, std::max(kInitialCapacity, 2 * (numKept + 1)));
+		end = numKept;
+	}
+	(*storage_)[end] = { time, tf };
+	auto next = std::make_shared<TransformBufferSnapshot>();
+	next->storage_ = storage_;
+	next->begin_ = end - numKept;
+	next->end_ = end + 1;
+	publish(std::move(next));
 }
 
 void TransformInterpolationBuffer::applyToAllElementsInTimeInterval(const Transform &t, const Time &begin,
 		const Time &end) {
-//	assert_ge(toUniversal(end),toUniversal(begin));
-	for(auto it = transforms_.begin(); it != transforms_.end(); ++it){
-		if(it->time_ >= begin && it->time_ <= end){
-			it->transform_ = it->transform_ * t;
-		}
+	std::lock_guard<std::mutex> lck(writerMutex_);
+	const SnapshotPtr current = snapshot();
+	// the elements are visible to readers, modify a copy
+	moveToNewStorage(*current, current->size(), std::max(kInitialCapacity, 2 * current->size()));
+	auto next = std::make_shared<TransformBufferSnapshot>();
+	next->storage_ = storage_;
+	next->end_ = current->size();
+	for (size_t i = next->lowerBound(begin); i < next->size() && next->at(i).time_ <= end; ++i) {
+		(*storage_)[i].transform_ = (*storage_)[i].transform_ * t;
 	}
+	publish(std::move(next));
 }
 
 void TransformInterpolationBuffer::setSizeLimit(const size_t buffer_size_limit) {
-
+	std::lock_guard<std::mutex> lck(writerMutex_);
 	bufferSizeLimit_ = buffer_size_limit;
-	removeOldMeasurementsIfNeeded();
+	const SnapshotPtr current = snapshot();
+	if (current->size() <= buffer_size_limit) {
+		return;
+	}
+	auto next = std::make_shared<TransformBufferSnapshot>(*current);
+	next->begin_ = current->end_ - buffer_size_limit;
+	publish(std::move(next));
 }
 
 void TransformInterpolationBuffer::clear() {
-	transforms_.clear();
+	std::lock_guard<std::mutex> lck(writerMutex_);
+	storage_ = std::make_shared<Storage>();
+	auto next = std::make_shared<TransformBufferSnapshot>();
+	next->storage_ = storage_;
+	publish(std::move(next));
 }
 
-const TimestampedTransform& TransformInterpolationBuffer::latest_measurement(int offsetFromLastElement /*=0*/) const {
-	if (empty()) {
-		throw std::runtime_error("TransformInterpolationBuffer:: latest_measurement: Empty buffer");
-	}
-	return *(std::prev(transforms_.end(), offsetFromLastElement+1));
-}
-TimestampedTransform& TransformInterpolationBuffer::latest_measurement(int offsetFromLastElement /*=0*/) {
-	if (empty()) {
-		throw std::runtime_error("TransformInterpolationBuffer:: latest_measurement: Empty buffer");
-	}
-	return *(std::prev(transforms_.end(), offsetFromLastElement+1));
+TimestampedTransform TransformInterpolationBuffer::latest_measurement(int offsetFromLastElement /*=0*/) const {
+	return snapshot()->latest_measurement(offsetFromLastElement);
 }
 
 bool TransformInterpolationBuffer::has(const Time &time) const {
-	if (transforms_.empty()) {
-		return false;
-	}
-	return earliest_time() <= time && time <= latest_time();
+	return snapshot()->has(time);
 }
 
 Transform TransformInterpolationBuffer::lookup(const Time &time) const {
-
-	if (!has(time)) {
-		throw std::runtime_error("TransformInterpolationBuffer:: Missing transform for: " + toString(time));
-	}
-
-	if (size() == 1) {
-		return transforms_.front().transform_;
-	}
-
-	//just return the closest
-	const auto getMeasurement = std::find_if(transforms_.begin(), transforms_.end(),
-			[&time](const TimestampedTransform &tf) {
-				return time <= tf.time_;
-			});
-	const bool isIteratorValid = getMeasurement != transforms_.end();
-	if (isIteratorValid && getMeasurement->time_ == time) {
-		return getMeasurement->transform_;
-	}
-	const auto start = std::prev(getMeasurement);
-
-//  std::cout << "buffer size: " << size() << "\n";
-//  std::cout << "left time: " << toSecondsSinceFirstMeasurement(start->time_) << "\n";
-//  std::cout << "right time: " << toSecondsSinceFirstMeasurement(getMeasurement->time_) << "\n";
-//  std::cout << "query time: " << toSecondsSinceFirstMeasurement(time) << "\n \n";
-//  std::cout << "times in buffer: \n";
-  printTimesCurrentlyInBuffer();
-
-	return interpolate(*start, *getMeasurement, time).transform_;
+	return snapshot()->lookup(time);
 }
 
-void TransformInterpolationBuffer::removeOldMeasurementsIfNeeded() {
-	while (transforms_.size() > bufferSizeLimit_) {
-		transforms_.pop_front();
-	}
+Transform TransformInterpolationBuffer::lookupClamped(const Time &time) const {
+	return snapshot()->lookupClamped(time);
 }
 
 Time TransformInterpolationBuffer::earliest_time() const {
-	if (empty()) {
-		throw std::runtime_error("TransformInterpolationBuffer:: Empty buffer");
-	}
-	return transforms_.front().time_;
+	return snapshot()->earliest_time();
 }
 
 Time TransformInterpolationBuffer::latest_time() const {
-	if (empty()) {
-		throw std::runtime_error("TransformInterpolationBuffer:: Empty buffer");
-	}
-	return transforms_.back().time_;
+	return snapshot()->latest_time();
 }
 
 bool TransformInterpolationBuffer::empty() const {
-	return transforms_.empty();
+	return snapshot()->empty();
 }
 
 size_t TransformInterpolationBuffer::size_limit() const {
@@ -146,24 +246,18 @@ size_t TransformInterpolationBuffer::size_limit() const {
 }
 
 size_t TransformInterpolationBuffer::size() const {
-	return transforms_.size();
+	return snapshot()->size();
 }
 
 void TransformInterpolationBuffer::printTimesCurrentlyInBuffer() const {
-	for (auto it = transforms_.cbegin(); it != transforms_.cend(); ++it) {
-		std::cout << toSecondsSinceFirstMeasurement(it->time_) << std::endl;
+	const SnapshotPtr s = snapshot();
+	for (size_t i = 0; i < s->size(); ++i) {
+		std::cout << toSecondsSinceFirstMeasurement(s->at(i).time_) << std::endl;
 	}
 }
 
 Transform getTransform(const Time &time, const TransformInterpolationBuffer &buffer) {
-	if (time < buffer.earliest_time()) {
-		return buffer.lookup(buffer.earliest_time());
-	}
-	if (time > buffer.latest_time()) {
-		return buffer.lookup(buffer.latest_time());
-	}
-	return buffer.lookup(time);
+	return buffer.lookupClamped(time);
 }
 
 } // namespace o3d_slam
-
@@ -7,6 +7,10 @@
 
 #include "open3d_slam/Voxel.hpp"
 #include "open3d_slam/time.hpp"
+#include "open3d_slam/assert.hpp"
+#include <Eigen/Eigenvalues>
+#include <algorithm>
+#include <limits>
 #include <numeric>
 #include <iostream>
 #include <unordered_set>
@@ -24,15 +28,15 @@ Eigen::Vector3d AggregatedVoxel::getAggregatedPosition() const {
  Eigen::Vector3d AggregatedVoxel::getAggregatedColor() const {
 	return numAggregatedPoints_ == 0 ? zero3d : aggregatedColor_ / numAggregatedPoints_;
 }
-void AggregatedVoxel::aggregatePoint(const Eigen::Vector3d &p) {
-	aggregatedPosition_ += p;
-	++numAggregatedPoints_;
+void AggregatedVoxel::aggregatePoint(const Eigen::Vector3d &p, int weight) {
+	aggregatedPosition_ += static_cast<double>(weight) * p;
+	numAggregatedPoints_ += weight;
 }
-void AggregatedVoxel::aggregateNormal(const Eigen::Vector3d &normal) {
-	aggregatedNormal_ += normal;
+void AggregatedVoxel::aggregateNormal(const Eigen::Vector3d &normal, int weight) {
+	aggregatedNormal_ += static_cast<double>(weight) * normal;
 }
-void AggregatedVoxel::aggregateColor(const Eigen::Vector3d &c) {
-	aggregatedColor_ += c;
+void AggregatedVoxel::aggregateColor(const Eigen::Vector3d &c, int weight) {
+	aggregatedColor_ += static_cast<double>(weight) * c;
 }
 
 VoxelizedPointCloud::VoxelizedPointCloud() :
@@ -59,8 +63,10 @@ void VoxelizedPointCloud::transform(const Transform &T){
 		for (const auto &v : voxels_) {
 			if (v.second.numAggregatedPoints_ > 0) {
 				AggregatedVoxel vTransformed(v.second);
-				vTransformed.aggregatedNormal_ = T * vTransformed.aggregatedNormal_;
-				vTransformed.aggregatedPosition_ = T * vTransformed.aggregatedPosition_;
+				// sums of numAggregatedPoints_ normals and positions
+				vTransformed.aggregatedNormal_ = T.linear() * vTransformed.aggregatedNormal_;
+				vTransformed.aggregatedPosition_ = T.linear() * vTransformed.aggregatedPosition_
+						+ static_cast<double>(v.second.numAggregatedPoints_) * T.translation();
 				voxels[v.first] = vTransformed;
 			}
 		}
@@ -68,7 +74,13 @@ void VoxelizedPointCloud::transform(const Transform &T){
 }
 
 void VoxelizedPointCloud::insert(const open3d::geometry::PointCloud &cloud) {
+	insert(cloud, std::vector<int>());
+}
+
+void VoxelizedPointCloud::insert(const open3d::geometry::PointCloud &cloud, const std::vector<int> &weights) {
+	const bool isWeighted = !weights.empty();
 	for (size_t i = 0; i < cloud.points_.size(); ++i) {
+		const int weight = isWeighted ? weights[i] : 1;
 		const auto voxelIdx = getKey(cloud.points_[i]);
 		auto search = voxels_.find(voxelIdx);
 		if (search == voxels_.end()) {
@@ -79,13 +91,13 @@ void VoxelizedPointCloud::insert(const open3d::geometry::PointCloud &cloud) {
 			}
 			search = insertResult.first;
 		}
-		search->second.aggregatePoint(cloud.points_[i]);
+		search->second.aggregatePoint(cloud.points_[i], weight);
 		if (cloud.HasNormals()) {
-			search->second.aggregateNormal(cloud.normals_[i]);
+			search->second.aggregateNormal(cloud.normals_[i], weight);
 			isHasNormals_ = true;
 		}
 		if (cloud.HasColors()) {
-			search->second.aggregateColor(cloud.colors_[i]);
+			search->second.aggregateColor(cloud.colors_[i], weight);
 			isHasColors_ = true;
 		}
 
@@ -93,6 +105,14 @@ void VoxelizedPointCloud::insert(const open3d::geometry::PointCloud &cloud) {
 }
 
 PointCloud VoxelizedPointCloud::toPointCloud() const {
+	return toPointCloud(nullptr);
+}
+
+PointCloud VoxelizedPointCloud::toPointCloud(std::vector<int> *numAggregatedPoints) const {
+	if (numAggregatedPoints != nullptr) {
+		numAggregatedPoints->clear();
+		numAggregatedPoints->reserve(voxels_.size());
+	}
 	if (empty()){
 		return PointCloud();
 	}
@@ -107,6 +127,9 @@ PointCloud VoxelizedPointCloud::toPointCloud() const {
 	for (const auto &voxel : voxels_) {
 		if (voxel.second.numAggregatedPoints_ > 0) {
 			ret.points_.push_back(voxel.second.getAggregatedPosition());
+			if (numAggregatedPoints != nullptr) {
+				numAggregatedPoints->push_back(voxel.second.numAggregatedPoints_);
+			}
 			if (isHasNormals_) {
 				ret.normals_.push_back(voxel.second.getAggregatedNormal());
 			}
@@ -171,6 +194,240 @@ bool VoxelMap::isVoxelHasLayer(const Eigen::Vector3i &key, const std::string &la
 	return false;
 }
 
+PointCloudVoxelIndex::PointCloudVoxelIndex() :
+		PointCloudVoxelIndex(Eigen::Vector3d::Constant(0.25)) {
+}
+
+PointCloudVoxelIndex::PointCloudVoxelIndex(const Eigen::Vector3d &voxelSize) :
+		BASE(voxelSize) {
+}
+
+void PointCloudVoxelIndex::insert(const PointCloud &cloud, PointCloud *map, std::vector<size_t> *movedIdxs,
+		std::vector<Eigen::Vector3d> *previousPositions) {
+	const size_t nPointsBeforeInsertion = map->points_.size();
+	std::unordered_set<size_t> moved;
+	const bool isMapEmpty = map->points_.empty();
+	const bool hasNormals = cloud.HasNormals() && (isMapEmpty || map->HasNormals());
+	const bool hasColors = cloud.HasColors() && (isMapEmpty || map->HasColors());
+	const bool hasCovariances = cloud.HasCovariances() && (isMapEmpty || map->HasCovariances());
+	// same as PointCloud::operator+=, attributes missing in one of the clouds are dropped
+	if (!hasNormals) {
+		map->normals_.clear();
+	}
+	if (!hasColors) {
+		map->colors_.clear();
+	}
+	if (!hasCovariances) {
+		map->covariances_.clear();
+	}
+	for (size_t i = 0; i < cloud.points_.size(); ++i) {
+		const auto insertResult = voxels_.insert( { getKey(cloud.points_[i]), VoxelWithPointIdx { map->points_.size(), 1 } });
+		if (insertResult.second) {
+			map->points_.push_back(cloud.points_[i]);
+			if (hasNormals) {
+				map->normals_.push_back(cloud.normals_[i]);
+			}
+			if (hasColors) {
+				map->colors_.push_back(cloud.colors_[i]);
+			}
+			if (hasCovariances) {
+				map->covariances_.push_back(cloud.covariances_[i]);
+			}
+			continue;
+		}
+		VoxelWithPointIdx &voxel = insertResult.first->second;
+		const size_t idx = voxel.idx_;
+		const double w = 1.0 / (++voxel.numAggregatedPoints_);
+		if (movedIdxs != nullptr && idx < nPointsBeforeInsertion && moved.insert(idx).second) {
+			movedIdxs->push_back(idx);
+			if (previousPositions != nullptr) {
+				previousPositions->push_back(map->points_[idx]);
+			}
+		}
+		map->points_[idx] += w * (cloud.points_[i] - map->points_[idx]);
+		if (hasNormals) {
+			const Eigen::Vector3d n = map->normals_[idx] + w * (cloud.normals_[i] - map->normals_[idx]);
+			const double norm = n.norm();
+			map->normals_[idx] = norm > 0.0 ? Eigen::Vector3d(n / norm) : cloud.normals_[i];
+		}
+		if (hasColors) {
+			map->colors_[idx] += w * (cloud.colors_[i] - map->colors_[idx]);
+		}
+		if (hasCovariances) {
+			map->covariances_[idx] += w * (cloud.covariances_[i] - map->covariances_[idx]);
+		}
+	}
+}
+
+void PointCloudVoxelIndex::rebuild(const PointCloud &map, const std::vector<bool> &isPointRemoved) {
+	voxels_.clear();
+	voxels_.reserve(map.points_.size());
+	for (size_t i = 0; i < map.points_.size(); ++i) {
+		if (i < isPointRemoved.size() && isPointRemoved[i]) {
+			continue;
+		}
+		voxels_.insert( { getKey(map.points_[i]), VoxelWithPointIdx { i, 1 } });
+	}
+}
+
+void PointCloudVoxelIndex::remove(const PointCloud &map, const std::vector<size_t> &idxs) {
+	for (const auto idx : idxs) {
+		// the averaged point stays inside the voxel it was inserted into
+		const auto search = voxels_.find(getKey(map.points_[idx]));
+		if (search != voxels_.end() && search->second.idx_ == idx) {
+			voxels_.erase(search);
+		}
+	}
+}
+
+NdtVoxelMap::NdtVoxelMap() :
+		NdtVoxelMap(Eigen::Vector3d::Constant(1.0), 5) {
+}
+
+NdtVoxelMap::NdtVoxelMap(const Eigen::Vector3d &voxelSize, int minNumPointsPerVoxel) :
+		BASE(voxelSize), minNumPointsPerVoxel_(std::max(minNumPointsPerVoxel, 3)) {
+}
+
+void NdtVoxelMap::insert(const PointCloud &cloud, size_t startIdx) {
+	std::vector<NdtVoxel*> touched;
+	for (size_t i = startIdx; i < cloud.points_.size(); ++i) {
+		const Eigen::Vector3d &p = cloud.points_[i];
+		NdtVoxel &voxel = voxels_[getKey(p)];
+		++voxel.numPoints_;
+		voxel.sum_ += p;
+		voxel.sumOfOuterProducts_.noalias() += p * p.transpose();
+		if (!voxel.isDirty_) {
+			voxel.isDirty_ = true;
+			touched.push_back(&voxel);
+		}
+	}
+	for (NdtVoxel *voxel : touched) {
+		updateDistribution(voxel);
+	}
+}
+
+void NdtVoxelMap::rebuild(const PointCloud &cloud, const std::vector<bool> &isPointRemoved) {
+	voxels_.clear();
+	if (isPointRemoved.empty()) {
+		insert(cloud);
+		return;
+	}
+	for (size_t i = 0; i < cloud.points_.size(); ++i) {
+		if (i < isPointRemoved.size() && isPointRemoved[i]) {
+			continue;
+		}
+		const Eigen::Vector3d &p = cloud.points_[i];
+		NdtVoxel &voxel = voxels_[getKey(p)];
+		++voxel.numPoints_;
+		voxel.sum_ += p;
+		voxel.sumOfOuterProducts_.noalias() += p * p.transpose();
+	}
+	for (auto &voxel : voxels_) {
+		updateDistribution(&voxel.second);
+	}
+}
+
+void NdtVoxelMap::remove(const PointCloud &cloud, const std::vector<size_t> &idxs) {
+	std::vector<Eigen::Vector3i> touched;
+	for (const auto idx : idxs) {
+		const Eigen::Vector3d &p = cloud.points_[idx];
+		const Eigen::Vector3i key = getKey(p);
+		NdtVoxel *voxel = getVoxelPtr(key);
+		if (voxel == nullptr) {
+			continue;
+		}
+		--voxel->numPoints_;
+		voxel->sum_ -= p;
+		voxel->sumOfOuterProducts_.noalias() -= p * p.transpose();
+		if (!voxel->isDirty_) {
+			voxel->isDirty_ = true;
+			touched.push_back(key);
+		}
+	}
+	updateDistributions(touched);
+}
+
+void NdtVoxelMap::move(const PointCloud &cloud, const std::vector<size_t> &idxs,
+		const std::vector<Eigen::Vector3d> &previousPositions) {
+	assert_eq(idxs.size(), previousPositions.size(), "ndt map move: every index needs its previous position");
+	std::vector<Eigen::Vector3i> touched;
+	for (size_t i = 0; i < idxs.size(); ++i) {
+		const Eigen::Vector3d &previous = previousPositions[i];
+		const Eigen::Vector3i previousKey = getKey(previous);
+		NdtVoxel *previousVoxel = getVoxelPtr(previousKey);
+		if (previousVoxel != nullptr) {
+			--previousVoxel->numPoints_;
+			previousVoxel->sum_ -= previous;
+			previousVoxel->sumOfOuterProducts_.noalias() -= previous * previous.transpose();
+			if (!previousVoxel->isDirty_) {
+				previousVoxel->isDirty_ = true;
+				touched.push_back(previousKey);
+			}
+		}
+		const Eigen::Vector3d &p = cloud.points_[idxs[i]];
+		const Eigen::Vector3i key = getKey(p);
+		NdtVoxel &voxel = voxels_[key];
+		++voxel.numPoints_;
+		voxel.sum_ += p;
+		voxel.sumOfOuterProducts_.noalias() += p * p.transpose();
+		if (!voxel.isDirty_) {
+			voxel.isDirty_ = true;
+			touched.push_back(key);
+		}
+	}
+	updateDistributions(touched);
+}
+
+void NdtVoxelMap::updateDistributions(const std::vector<Eigen::Vector3i> &keys) {
+	for (const auto &key : keys) {
+		NdtVoxel *voxel = getVoxelPtr(key);
+		if (voxel->numPoints_ <= 0) {
+			removeKey(key);
+		} else {
+			updateDistribution(voxel);
+		}
+	}
+}
+
+void NdtVoxelMap::updateDistribution(NdtVoxel *voxel) const {
+	// eigenvalues are clamped to a fraction of the largest one so that planar voxels stay invertible
+	static const double kMinEigenvalueRatio = 1e-2;
+	static const double kMinEigenvalue = 1e-6;
+	voxel->isDirty_ = false;
+	voxel->isValid_ = voxel->numPoints_ >= minNumPointsPerVoxel_;
+	if (!voxel->isValid_) {
+		return;
+	}
+	const double n = voxel->numPoints_;
+	voxel->mean_ = voxel->sum_ / n;
+	const Eigen::Matrix3d covariance = (voxel->sumOfOuterProducts_ - n * voxel->mean_ * voxel->mean_.transpose())
+			/ (n - 1.0);
+	const Eigen::SelfAdjointEigenSolver<Eigen::Matrix3d> solver(covariance);
+	const double minEigenvalue = std::max(kMinEigenvalueRatio * solver.eigenvalues().maxCoeff(), kMinEigenvalue);
+	const Eigen::Vector3d inverseEigenvalues = solver.eigenvalues().cwiseMax(minEigenvalue).cwiseInverse();
+	voxel->information_ = solver.eigenvectors() * inverseEigenvalues.asDiagonal() * solver.eigenvectors().transpose();
+}
+
+const NdtVoxel *NdtVoxelMap::getClosestDistribution(const Eigen::Vector3d &p) const {
+	static const Eigen::Vector3i kNeighbors[7] = { Eigen::Vector3i(0, 0, 0), Eigen::Vector3i(1, 0, 0), Eigen::Vector3i(-1,
+			0, 0), Eigen::Vector3i(0, 1, 0), Eigen::Vector3i(0, -1, 0), Eigen::Vector3i(0, 0, 1), Eigen::Vector3i(0, 0, -1) };
+	const Eigen::Vector3i key = getKey(p);
+	const NdtVoxel *closest = nullptr;
+	double minSquaredDistance = std::numeric_limits<double>::max();
+	for (const auto &offset : kNeighbors) {
+		const NdtVoxel *voxel = getVoxelPtr(key + offset);
+		if (voxel == nullptr || !voxel->isValid_) {
+			continue;
+		}
+		const double squaredDistance = (voxel->mean_ - p).squaredNorm();
+		if (squaredDistance < minSquaredDistance) {
+			minSquaredDistance = squaredDistance;
+			closest = voxel;
+		}
+	}
+	return closest;
+}
+
 std::shared_ptr<PointCloud> removeDuplicatePointsWithinSameVoxels(const open3d::geometry::PointCloud &cloud, const Eigen::Vector3d &voxelSize){
 
 	std::unordered_set<Eigen::Vector3i, EigenVec3iHash> voxelSet;
@@ -75,34 +75,31 @@ CroppingVolume::Indices CroppingVolume::getIndicesWithinVolume(const PointCloud
 }
 
 std::shared_ptr<CroppingVolume::PointCloud> CroppingVolume::crop(const PointCloud &cloud) const {
+	const Indices idxs = getIndicesWithinVolume(cloud);
 	std::shared_ptr<CroppingVolume::PointCloud> cropped(new PointCloud());
-	const int nPoints = cloud.points_.size();
-	cropped->points_.reserve(nPoints);
+	const size_t nPoints = idxs.size();
+	cropped->points_.resize(nPoints);
+	for (size_t i = 0; i < nPoints; ++i) {
+		cropped->points_[i] = cloud.points_[idxs[i]];
+	}
 	if (cloud.HasColors()) {
-		cropped->colors_.reserve(nPoints);
+		cropped->colors_.resize(nPoints);
+		for (size_t i = 0; i < nPoints; ++i) {
+			cropped->colors_[i] = cloud.colors_[idxs[i]];
+		}
 	}
 	if (cloud.HasNormals()) {
-		cropped->normals_.reserve(nPoints);
+		cropped->normals_.resize(nPoints);
+		for (size_t i = 0; i < nPoints; ++i) {
+			cropped->normals_[i] = cloud.normals_[idxs[i]];
+		}
 	}
 	if (cloud.HasCovariances()) {
-		cropped->covariances_.reserve(nPoints);
-	}
-
-	for (size_t i = 0; i < nPoints; ++i) {
-		if (isWithinVolume(cloud.points_[i])) {
-			cropped->points_.push_back(cloud.points_[i]);
-			if (cloud.HasColors()) {
-				cropped->colors_.push_back(cloud.colors_[i]);
-			}
-			if (cloud.HasNormals()) {
-				cropped->normals_.push_back(cloud.normals_[i]);
-			}
-			if (cloud.HasCovariances()) {
-				cropped->covariances_.push_back(cloud.covariances_[i]);
-			}
-		} // end if
+		cropped->covariances_.resize(nPoints);
+		for (size_t i = 0; i < nPoints; ++i) {
+			cropped->covariances_[i] = cloud.covariances_[idxs[i]];
+		}
 	}
-
 	return cropped;
 
 }
@@ -123,10 +120,6 @@ MinMaxRadiusCroppingVolume::MinMaxRadiusCroppingVolume(double radiusMin, double
 
 }
 
-bool MinMaxRadiusCroppingVolume::isWithinVolumeImpl(const Eigen::Vector3d &p) const {
-	const double d = (p - pose_.translation()).norm();
-	return  d <= radiusMax_ && d >= radiusMin_;
-}
 void MinMaxRadiusCroppingVolume::setParameters(double radiusMin, double radiusMax) {
 	radiusMin_ = radiusMin;
 	radiusMax_ = radiusMax;
@@ -140,9 +133,6 @@ MaxRadiusCroppingVolume::MaxRadiusCroppingVolume(double radius) :
 		radius_(radius) {
 }
 
-bool MaxRadiusCroppingVolume::isWithinVolumeImpl(const Eigen::Vector3d &p) const {
-	return (p - pose_.translation()).norm() <= radius_;
-}
 void MaxRadiusCroppingVolume::setParameters(double radius) {
 	radius_ = radius;
 }
@@ -155,10 +145,6 @@ MinRadiusCroppingVolume::MinRadiusCroppingVolume(double radius) :
 		radius_(radius) {
 }
 
-bool MinRadiusCroppingVolume::isWithinVolumeImpl(const Eigen::Vector3d &p) const {
-	return (p - pose_.translation()).norm() >= radius_;
-}
-
 void MinRadiusCroppingVolume::setParameters(double radius) {
 	radius_ = radius;
 }
@@ -172,10 +158,6 @@ CylinderCroppingVolume::CylinderCroppingVolume(double radius, double minZ, doubl
 
 }
 
-bool CylinderCroppingVolume::isWithinVolumeImpl(const Eigen::Vector3d &p) const {
-	return p.z() >= minZ_ && p.z() <= maxZ_ && (p - pose_.translation()).head<2>().norm() <= radius_;
-}
-
 void CylinderCroppingVolume::setParameters(double radius, double minZ, double maxZ) {
 	radius_ = radius;
 	minZ_ = minZ;
@@ -27,6 +27,49 @@ namespace o3d_slam {
 namespace {
 namespace registration = open3d::pipelines::registration;
 
+constexpr int kTransformBlockSize = 512;
+using TransformBlock = Eigen::Matrix<double, 3, Eigen::Dynamic, Eigen::ColMajor, 3, kTransformBlockSize>;
+
+// vectors are stored contiguously, hence the whole vector can be mapped as a 3xN matrix
+void rotateAndTranslateInPlace(const Eigen::Matrix3d &R, const Eigen::Vector3d &t,
+		std::vector<Eigen::Vector3d> *vectors) {
+	const int n = vectors->size();
+	if (n == 0) {
+		return;
+	}
+	Eigen::Map<Eigen::Matrix3Xd> data(vectors->front().data(), 3, n);
+	const bool isTranslate = !t.isZero();
+	const int nBlocks = (n + kTransformBlockSize - 1) / kTransformBlockSize;
+#pragma omp parallel for schedule(static)
+	for (int b = 0; b < nBlocks; ++b) {
+		const int start = b * kTransformBlockSize;
+		auto block = data.middleCols(start, std::min(kTransformBlockSize, n - start));
+		TransformBlock rotated(3, block.cols()); // stack allocated
+		rotated.noalias() = R * block;
+		if (isTranslate) {
+			block = rotated.colwise() + t;
+		} else {
+			block = rotated;
+		}
+	}
+}
+
+// keeps the order of the remaining elements, elements past the end of isRemove are kept
+template<typename T, typename Allocator>
+void removeMarkedInPlace(const std::vector<bool> &isRemove, std::vector<T, Allocator> *v) {
+	size_t nKept = 0;
+	for (size_t i = 0; i < v->size(); ++i) {
+		if (i < isRemove.size() && isRemove[i]) {
+			continue;
+		}
+		if (nKept != i) {
+			(*v)[nKept] = std::move((*v)[i]);
+		}
+		++nKept;
+	}
+	v->resize(nKept);
+}
+
 class AccumulatedPoint {
 public:
 	void AddPoint(const open3d::geometry::PointCloud &cloud, int index) {
@@ -150,9 +193,13 @@ std::shared_ptr<open3d::geometry::PointCloud> voxelizeWithinCroppingVolume(doubl
 		output->covariances_.reserve(cloud.points_.size());
 	}
 
+	std::vector<uint8_t> isWithinVolume(cloud.points_.size(), 0);
+	for (const size_t idx : croppingVolume.getIndicesWithinVolume(cloud)) {
+		isWithinVolume[idx] = 1;
+	}
 	voxelindex_to_accpoint.reserve(cloud.points_.size());
 	for (size_t i = 0; i < cloud.points_.size(); i++) {
-		if (croppingVolume.isWithinVolume(cloud.points_[i])) {
+		if (isWithinVolume[i]) {
 			const Eigen::Vector3i voxelIdx = getVoxelIdx(cloud.points_[i], invVoxelSize);
 			voxelindex_to_accpoint[voxelIdx].AddPoint(cloud, i);
 		} else {
@@ -228,9 +275,18 @@ void removeByIds(const std::vector<size_t> &ids, open3d::geometry::PointCloud *c
 	if (ids.empty()) {
 		return;
 	}
-	const bool isInvertSelection = true;
-	auto trimmedCloud = cloud->SelectByIndex(ids, isInvertSelection);
-	*cloud = std::move(*trimmedCloud);
+	std::vector<bool> isRemove(cloud->points_.size(), false);
+	for (const auto id : ids) {
+		isRemove[id] = true;
+	}
+	removeMarkedPoints(isRemove, cloud);
+}
+
+void removeMarkedPoints(const std::vector<bool> &isRemove, open3d::geometry::PointCloud *cloud) {
+	removeMarkedInPlace(isRemove, &cloud->points_);
+	removeMarkedInPlace(isRemove, &cloud->normals_);
+	removeMarkedInPlace(isRemove, &cloud->colors_);
+	removeMarkedInPlace(isRemove, &cloud->covariances_);
 }
 
 std::vector<size_t> getIdxsOfCarvedPoints(const open3d::geometry::PointCloud &scan,
@@ -282,39 +338,26 @@ std::vector<size_t> getIdxsOfCarvedPoints(const open3d::geometry::PointCloud &sc
 
 std::shared_ptr<open3d::geometry::PointCloud> transform(const Eigen::Matrix4d &T,
 		const open3d::geometry::PointCloud &cloud) {
+	auto out = std::make_shared<open3d::geometry::PointCloud>(cloud);
+	transformInPlace(T, out.get());
+	return out;
+}
 
-	auto out = std::make_shared<open3d::geometry::PointCloud>();
-	const auto isIdentity = (T - Eigen::Matrix4d::Identity()).array().abs().maxCoeff() < 1e-4;
-	if (isIdentity) {
-		*out = cloud;
-	}
-
-	out->points_.reserve(cloud.points_.size());
-	out->colors_ = cloud.colors_;
-	if (cloud.HasNormals()) {
-		out->normals_.reserve(cloud.points_.size());
-	}
-	if (cloud.HasCovariances()) {
-		out->covariances_.reserve(cloud.points_.size());
+void transformInPlace(const Eigen::Matrix4d &T, open3d::geometry::PointCloud *cloud) {
+	// only skip exact identities, small corrections have to be applied
+	if (T.isIdentity(1e-12)) {
+		return;
 	}
-	for (size_t i = 0; i < cloud.points_.size(); ++i) {
-		const auto &p = cloud.points_[i];
-		Eigen::Vector4d new_point = T * Eigen::Vector4d(p(0), p(1), p(2), 1.0);
-		Eigen::Vector3d xyz = new_point.head<3>() / new_point(3);
-		out->points_.emplace_back(std::move(xyz));
-		if (cloud.HasNormals()) {
-			const auto &n = cloud.normals_[i];
-			Eigen::Vector4d new_normal = T * Eigen::Vector4d(n(0), n(1), n(2), 0.0);
-			out->normals_.emplace_back(std::move(new_normal.head<3>()));
-		}
-		if (cloud.HasCovariances()) {
-			const auto &cov = cloud.covariances_[i];
-			const Eigen::Matrix3d R = T.block<3, 3>(0, 0);
-			out->covariances_.emplace_back(std::move(R * cov * R.transpose()));
-		}
+	const Eigen::Matrix3d R = T.block<3, 3>(0, 0);
+	const Eigen::Vector3d t = T.block<3, 1>(0, 3);
+	rotateAndTranslateInPlace(R, t, &cloud->points_);
+	rotateAndTranslateInPlace(R, Eigen::Vector3d::Zero(), &cloud->normals_);
+	auto &covariances = cloud->covariances_;
+	const int nCovariances = covariances.size();
+#pragma omp parallel for schedule(static)
+	for (int i = 0; i < nCovariances; ++i) {
+		covariances[i] = R * covariances[i] * R.transpose();
 	}
-	return out;
-
 }
 
 void computeIndicesOfOverlappingPoints(const open3d::geometry::PointCloud &source,
@@ -326,7 +369,7 @@ void computeIndicesOfOverlappingPoints(const open3d::geometry::PointCloud &sourc
 	VoxelMap voxelMap(Eigen::Vector3d::Constant(voxelSize));
 	voxelMap.insertCloud(targetLayer, target);
 	auto sourceTransformed = source;
-	sourceTransformed.Transform(sourceToTarget.matrix());
+	transformInPlace(sourceToTarget.matrix(), &sourceTransformed);
 	voxelMap.insertCloud(sourceLayer, sourceTransformed);
 	idxsSource->clear();
 	idxsSource->reserve(source.points_.size());
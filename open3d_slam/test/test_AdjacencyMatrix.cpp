@@ -0,0 +1,111 @@
+/*
+ * test_AdjacencyMatrix.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+// GTest
+#include <gtest/gtest.h>
+
+// open3d_slam
+#include "open3d_slam/AdjacencyMatrix.hpp"
+
+#include <limits>
+#include <queue>
+#include <random>
+#include <set>
+
+using namespace o3d_slam;
+
+namespace {
+const int kUnreachable = std::numeric_limits<int>::max();
+
+// full bfs from the loop closure submaps, in submaps in between
+std::vector<int> computeDistances(int numSubmaps, const std::vector<std::pair<int, int>> &edges,
+		const std::set<int> &loopClosureSubmaps) {
+	std::vector<std::vector<int>> neighbours(numSubmaps);
+	for (const auto &edge : edges) {
+		neighbours[edge.first].push_back(edge.second);
+		neighbours[edge.second].push_back(edge.first);
+	}
+	std::vector<int> distances(numSubmaps, kUnreachable);
+	std::queue<int> toProcess;
+	for (const int id : loopClosureSubmaps) {
+		distances[id] = 0;
+		toProcess.push(id);
+	}
+	while (!toProcess.empty()) {
+		const int id = toProcess.front();
+		toProcess.pop();
+		for (const int adj : neighbours[id]) {
+			if (distances[adj] == kUnreachable) {
+				distances[adj] = distances[id] + 1;
+				toProcess.push(adj);
+			}
+		}
+	}
+	for (auto &d : distances) {
+		d = d == kUnreachable ? d : std::max(0, d - 1);
+	}
+	return distances;
+}
+} // namespace
+
+TEST(AdjacencyMatrix, edgesAreSymmetric) {
+	AdjacencyMatrix adjacencyMatrix;
+	adjacencyMatrix.addEdge(0, 1);
+	adjacencyMatrix.addEdge(3, 1);
+	adjacencyMatrix.addEdge(1, 3);
+	EXPECT_TRUE(adjacencyMatrix.isAdjacent(0, 1));
+	EXPECT_TRUE(adjacencyMatrix.isAdjacent(1, 0));
+	EXPECT_TRUE(adjacencyMatrix.isAdjacent(1, 3));
+	EXPECT_TRUE(adjacencyMatrix.isAdjacent(2, 2));
+	EXPECT_FALSE(adjacencyMatrix.isAdjacent(0, 3));
+	EXPECT_FALSE(adjacencyMatrix.isAdjacent(7, 0));
+}
+
+TEST(AdjacencyMatrix, distanceCountsTheSubmapsInBetween) {
+	AdjacencyMatrix adjacencyMatrix;
+	for (int id = 0; id < 5; ++id) {
+		adjacencyMatrix.addEdge(id, id + 1);
+	}
+	EXPECT_EQ(adjacencyMatrix.getDistanceToNearestLoopClosureSubmap(2), kUnreachable);
+	EXPECT_EQ(adjacencyMatrix.getDistanceToNearestLoopClosureSubmap(42), kUnreachable);
+	adjacencyMatrix.markAsLoopClosureSubmap(0);
+	const std::vector<int> expected = { 0, 0, 1, 2, 3, 4 };
+	for (int id = 0; id < 6; ++id) {
+		EXPECT_EQ(adjacencyMatrix.getDistanceToNearestLoopClosureSubmap(id), expected[id]);
+	}
+	adjacencyMatrix.markAsLoopClosureSubmap(5);
+	EXPECT_EQ(adjacencyMatrix.getDistanceToNearestLoopClosureSubmap(4), 0);
+	EXPECT_EQ(adjacencyMatrix.getDistanceToNearestLoopClosureSubmap(3), 1);
+
+	adjacencyMatrix.clear();
+	EXPECT_EQ(adjacencyMatrix.getDistanceToNearestLoopClosureSubmap(0), kUnreachable);
+}
+
+TEST(AdjacencyMatrix, incrementalDistancesMatchAFullSearch) {
+	const int numSubmaps = 60;
+	std::mt19937 generator(7);
+	std::uniform_int_distribution<int> randomId(0, numSubmaps - 1);
+	std::uniform_int_distribution<int> randomAction(0, 9);
+	AdjacencyMatrix adjacencyMatrix;
+	std::vector<std::pair<int, int>> edges;
+	std::set<int> loopClosureSubmaps;
+	for (int i = 0; i < 200; ++i) {
+		if (randomAction(generator) == 0) {
+			const int id = randomId(generator);
+			adjacencyMatrix.markAsLoopClosureSubmap(id);
+			loopClosureSubmaps.insert(id);
+		} else {
+			const int id1 = randomId(generator), id2 = randomId(generator);
+			adjacencyMatrix.addEdge(id1, id2);
+			edges.emplace_back(id1, id2);
+		}
+		const std::vector<int> expected = computeDistances(numSubmaps, edges, loopClosureSubmaps);
+		for (int id = 0; id < numSubmaps; ++id) {
+			ASSERT_EQ(adjacencyMatrix.getDistanceToNearestLoopClosureSubmap(id), expected[id]) << "step " << i
+					<< ", submap " << id;
+		}
+	}
+}
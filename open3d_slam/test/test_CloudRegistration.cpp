@@ -0,0 +1,68 @@
+/*
+ * test_CloudRegistration.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+// GTest
+#include <gtest/gtest.h>
+
+// open3d_slam
+#include "open3d_slam/CloudRegistration.hpp"
+#include "open3d_slam/helpers.hpp"
+
+using namespace o3d_slam;
+
+namespace {
+PointCloud createCloudWithNormals() {
+	PointCloud cloud;
+	cloud.points_ = { Eigen::Vector3d(1.0, 0.0, 0.0), Eigen::Vector3d(0.0, 2.0, 0.0), Eigen::Vector3d(0.0, 0.0, 3.0) };
+	// not normalized, e.g. averaged by the voxelization
+	cloud.normals_ = { Eigen::Vector3d(0.0, 0.0, 0.5), Eigen::Vector3d(1.0, 1.0, 0.0), Eigen::Vector3d(-2.0, 0.0, 0.0) };
+	return cloud;
+}
+} // namespace
+
+TEST(RegistrationIcpGeneralized, covariancesAreFlatAlongTheNormals) {
+	const auto gicp = createGeneralizedIcp(CloudRegistrationParameters());
+	const double epsilon = gicp->tranformationEstimationGICP_.epsilon_;
+	PointCloud cloud = createCloudWithNormals();
+	gicp->estimateNormalsOrCovariancesIfNeeded(&cloud);
+	ASSERT_TRUE(cloud.HasCovariances());
+	for (size_t i = 0; i < cloud.points_.size(); ++i) {
+		const Eigen::Vector3d &n = cloud.normals_[i];
+		EXPECT_NEAR(n.norm(), 1.0, 1e-9);
+		const Eigen::Vector3d tangent = n.unitOrthogonal();
+		EXPECT_TRUE((cloud.covariances_[i] * n).isApprox(epsilon * n));
+		EXPECT_TRUE((cloud.covariances_[i] * tangent).isApprox(tangent));
+		EXPECT_TRUE((cloud.covariances_[i] * n.cross(tangent)).isApprox(n.cross(tangent)));
+	}
+}
+
+TEST(RegistrationIcpGeneralized, existingCovariancesAreKept) {
+	const auto gicp = createGeneralizedIcp(CloudRegistrationParameters());
+	PointCloud cloud = createCloudWithNormals();
+	cloud.covariances_.assign(cloud.points_.size(), 2.0 * Eigen::Matrix3d::Identity());
+	gicp->estimateNormalsOrCovariancesIfNeeded(&cloud);
+	for (const auto &covariance : cloud.covariances_) {
+		EXPECT_TRUE(covariance.isApprox(2.0 * Eigen::Matrix3d::Identity()));
+	}
+}
+
+TEST(RegistrationIcpGeneralized, transformedCovariancesMatchRecomputedOnes) {
+	const auto gicp = createGeneralizedIcp(CloudRegistrationParameters());
+	PointCloud cloud = createCloudWithNormals();
+	gicp->estimateNormalsOrCovariancesIfNeeded(&cloud);
+	Transform T = Transform::Identity();
+	T.translation() = Eigen::Vector3d(1.0, -2.0, 0.5);
+	T.linear() = Eigen::AngleAxisd(0.7, Eigen::Vector3d(1.0, 2.0, 3.0).normalized()).toRotationMatrix();
+	const auto transformed = transform(T.matrix(), cloud);
+
+	PointCloud recomputed = *transformed;
+	recomputed.covariances_.clear();
+	gicp->estimateNormalsOrCovariancesIfNeeded(&recomputed);
+	ASSERT_EQ(transformed->covariances_.size(), recomputed.covariances_.size());
+	for (size_t i = 0; i < recomputed.covariances_.size(); ++i) {
+		EXPECT_TRUE(transformed->covariances_[i].isApprox(recomputed.covariances_[i], 1e-9));
+	}
+}
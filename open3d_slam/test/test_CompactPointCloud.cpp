@@ -0,0 +1,127 @@
+/*
+ * test_CompactPointCloud.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+// GTest
+#include <gtest/gtest.h>
+
+// open3d_slam
+#include "open3d_slam/CompactPointCloud.hpp"
+
+#include <cmath>
+#include <limits>
+#include <random>
+
+using namespace o3d_slam;
+
+namespace {
+const double kResolution = 0.005;
+
+PointCloud createRandomCloud(size_t numPoints, double size) {
+	std::mt19937 generator(42);
+	std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+	auto random = [&]() {
+		return Eigen::Vector3d(distribution(generator), distribution(generator), distribution(generator));
+	};
+	PointCloud cloud;
+	for (size_t i = 0; i < numPoints; ++i) {
+		cloud.points_.push_back(size * random());
+		cloud.normals_.push_back(random().normalized()); // both hemispheres of the octahedral encoding
+		cloud.colors_.push_back(0.5 * (random() + Eigen::Vector3d::Ones()));
+		const Eigen::Vector3d d = random();
+		cloud.covariances_.push_back(d * d.transpose() + 0.1 * Eigen::Matrix3d::Identity());
+	}
+	return cloud;
+}
+
+Transform createOrigin() {
+	Transform origin = Transform::Identity();
+	origin.translation() = Eigen::Vector3d(10.0, -5.0, 2.0);
+	origin.linear() = Eigen::AngleAxisd(0.4, Eigen::Vector3d(1.0, -1.0, 2.0).normalized()).toRotationMatrix();
+	return origin;
+}
+
+void expectSamePoints(const PointCloud &decoded, const PointCloud &cloud, const Transform &origin) {
+	ASSERT_EQ(decoded.points_.size(), cloud.points_.size());
+	for (size_t i = 0; i < cloud.points_.size(); ++i) {
+		const Eigen::Vector3d errorInOrigin = origin.linear().transpose() * (decoded.points_[i] - cloud.points_[i]);
+		EXPECT_LE(errorInOrigin.lpNorm<Eigen::Infinity>(), 0.5 * kResolution + 1e-9);
+	}
+}
+} // namespace
+
+TEST(CompactPointCloud, roundTripKeepsEveryAttribute) {
+	const PointCloud cloud = createRandomCloud(500, 20.0);
+	std::vector<int> weights;
+	for (size_t i = 0; i < cloud.points_.size(); ++i) {
+		weights.push_back(i + 1);
+	}
+	CompactPointCloud compact;
+	compact.encode(cloud, createOrigin(), kResolution, weights);
+	EXPECT_EQ(compact.size(), cloud.points_.size());
+
+	PointCloud decoded;
+	std::vector<int> decodedWeights;
+	compact.decode(&decoded, &decodedWeights);
+	expectSamePoints(decoded, cloud, createOrigin());
+	EXPECT_EQ(decodedWeights, weights);
+	ASSERT_EQ(decoded.normals_.size(), cloud.normals_.size());
+	ASSERT_EQ(decoded.colors_.size(), cloud.colors_.size());
+	ASSERT_EQ(decoded.covariances_.size(), cloud.covariances_.size());
+	for (size_t i = 0; i < cloud.points_.size(); ++i) {
+		EXPECT_GT(decoded.normals_[i].dot(cloud.normals_[i]), std::cos(1e-3));
+		EXPECT_LE((decoded.colors_[i] - cloud.colors_[i]).lpNorm<Eigen::Infinity>(), 0.5 / 255.0 + 1e-9);
+		EXPECT_TRUE(decoded.covariances_[i].isApprox(cloud.covariances_[i], 1e-5));
+	}
+}
+
+TEST(CompactPointCloud, largeExtentFallsBackToInt32) {
+	const PointCloud cloud = createRandomCloud(100, 500.0);
+	CompactPointCloud compact, compactPointsOnly;
+	compact.encode(cloud, createOrigin(), kResolution);
+	PointCloud pointsOnly;
+	pointsOnly.points_ = cloud.points_;
+	compactPointsOnly.encode(pointsOnly, createOrigin(), kResolution);
+	EXPECT_EQ(compactPointsOnly.getNumBytes(), cloud.points_.size() * 3 * sizeof(int32));
+
+	PointCloud decoded;
+	compact.decode(&decoded);
+	expectSamePoints(decoded, cloud, createOrigin());
+}
+
+TEST(CompactPointCloud, weightsSaturate) {
+	PointCloud cloud;
+	cloud.points_ = { Eigen::Vector3d::Zero(), Eigen::Vector3d::Ones(), Eigen::Vector3d::UnitX() };
+	CompactPointCloud compact;
+	compact.encode(cloud, Transform::Identity(), kResolution, { -1, 7, 100000 });
+	PointCloud decoded;
+	std::vector<int> weights;
+	compact.decode(&decoded, &weights);
+	EXPECT_EQ(weights, std::vector<int>( { 0, 7, std::numeric_limits<uint16>::max() }));
+	EXPECT_TRUE(decoded.normals_.empty());
+	EXPECT_TRUE(decoded.colors_.empty());
+}
+
+TEST(CompactPointCloud, transformMovesTheDecodedCloud) {
+	const PointCloud cloud = createRandomCloud(100, 5.0);
+	CompactPointCloud compact;
+	compact.encode(cloud, createOrigin(), kResolution);
+	PointCloud decoded;
+	compact.decode(&decoded);
+
+	Transform T = Transform::Identity();
+	T.translation() = Eigen::Vector3d(-3.0, 1.0, 0.5);
+	T.linear() = Eigen::AngleAxisd(-1.1, Eigen::Vector3d::UnitZ()).toRotationMatrix();
+	compact.transform(T);
+	PointCloud transformed;
+	compact.decode(&transformed);
+	ASSERT_EQ(transformed.points_.size(), decoded.points_.size());
+	for (size_t i = 0; i < decoded.points_.size(); ++i) {
+		EXPECT_LT((transformed.points_[i] - T * decoded.points_[i]).norm(), 1e-9);
+		EXPECT_LT((transformed.normals_[i] - T.linear() * decoded.normals_[i]).norm(), 1e-9);
+		EXPECT_TRUE(transformed.covariances_[i].isApprox(
+				T.linear() * decoded.covariances_[i] * T.linear().transpose(), 1e-9));
+	}
+}
@@ -0,0 +1,145 @@
+/*
+ * test_LoamRegistration.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+// GTest
+#include <gtest/gtest.h>
+
+// open3d_slam
+#include "open3d_slam/LoamRegistration.hpp"
+#include "open3d_slam/helpers.hpp"
+
+#include <cmath>
+#include <limits>
+
+using namespace o3d_slam;
+
+namespace {
+const double kDegToRad = M_PI / 180.0;
+const int kNumRings = 16;
+const int kNumColumns = 1024;
+const double kMinElevation = -25.0;
+const double kMaxElevation = 15.0;
+const Eigen::Vector3d kRoomMin(-12.0, -6.0, -1.5), kRoomMax(8.0, 10.0, 2.5);
+const Eigen::Vector3d kPillarMin(1.5, 0.8, -1.5), kPillarMax(1.8, 1.1, 2.5);
+
+// range along the ray to the pillar, infinity if it misses
+double rayToPillar(const Eigen::Vector3d &origin, const Eigen::Vector3d &direction) {
+	double tMin = 0.0, tMax = std::numeric_limits<double>::infinity();
+	for (int i = 0; i < 3; ++i) {
+		if (direction(i) == 0.0) {
+			if (origin(i) < kPillarMin(i) || origin(i) > kPillarMax(i)) {
+				return std::numeric_limits<double>::infinity();
+			}
+			continue;
+		}
+		const double t0 = (kPillarMin(i) - origin(i)) / direction(i);
+		const double t1 = (kPillarMax(i) - origin(i)) / direction(i);
+		tMin = std::max(tMin, std::min(t0, t1));
+		tMax = std::min(tMax, std::max(t0, t1));
+	}
+	return tMin <= tMax ? tMin : std::numeric_limits<double>::infinity();
+}
+
+// spinning lidar at worldToLidar inside an axis aligned room with a pillar, points in the lidar frame
+PointCloud scanRoom(const Eigen::Isometry3d &worldToLidar) {
+	PointCloud cloud;
+	for (int r = 0; r < kNumRings; ++r) {
+		const double elevation = (kMinElevation + r * (kMaxElevation - kMinElevation) / (kNumRings - 1)) * kDegToRad;
+		for (int c = 0; c < kNumColumns; ++c) {
+			const double azimuth = -M_PI + (c + 0.5) * 2.0 * M_PI / kNumColumns;
+			const Eigen::Vector3d direction(std::cos(elevation) * std::cos(azimuth),
+					std::cos(elevation) * std::sin(azimuth), std::sin(elevation));
+			const Eigen::Vector3d origin = worldToLidar.translation();
+			const Eigen::Vector3d worldDirection = worldToLidar.linear() * direction;
+			double range = rayToPillar(origin, worldDirection);
+			for (int i = 0; i < 3; ++i) {
+				if (worldDirection(i) > 0.0) {
+					range = std::min(range, (kRoomMax(i) - origin(i)) / worldDirection(i));
+				} else if (worldDirection(i) < 0.0) {
+					range = std::min(range, (kRoomMin(i) - origin(i)) / worldDirection(i));
+				}
+			}
+			cloud.points_.push_back(range * direction);
+		}
+	}
+	return cloud;
+}
+
+double distanceToSurface(const Eigen::Vector3d &p) {
+	const double toRoom = std::min((p - kRoomMin).minCoeff(), (kRoomMax - p).minCoeff());
+	const Eigen::Vector3d outsidePillar = (kPillarMin - p).cwiseMax(p - kPillarMax);
+	const double toPillar = outsidePillar.maxCoeff() < 0.0 ? 0.0 : outsidePillar.cwiseMax(0.0).norm();
+	return std::min(toRoom, toPillar);
+}
+
+LoamParameters createParameters() {
+	LoamParameters p;
+	p.numRings_ = kNumRings;
+	p.minElevation_ = kMinElevation;
+	p.maxElevation_ = kMaxElevation;
+	p.numColumns_ = kNumColumns;
+	return p;
+}
+} // namespace
+
+TEST(LoamRegistration, featuresOfARoom) {
+	const PointCloudPtr features = extractLoamFeatures(scanRoom(Eigen::Isometry3d::Identity()), createParameters());
+	ASSERT_TRUE(features->HasNormals());
+	size_t numEdges = 0, numPlanars = 0, numAxisAlignedNormals = 0;
+	for (size_t i = 0; i < features->points_.size(); ++i) {
+		const Eigen::Vector3d &p = features->points_[i];
+		EXPECT_LT(distanceToSurface(p), 1e-6);
+		if (isLoamEdgeFeature(*features, i)) {
+			++numEdges;
+			continue;
+		}
+		++numPlanars;
+		// walls, floor and ceiling face the lidar, only normals next to a corner are off the axes
+		const Eigen::Vector3d &n = features->normals_[i];
+		EXPECT_LT(n.dot(p), 0.0);
+		if (n.cwiseAbs().maxCoeff() > 0.99) {
+			++numAxisAlignedNormals;
+		}
+	}
+	EXPECT_GT(numEdges, 0);
+	EXPECT_GT(numPlanars, numEdges);
+	EXPECT_GT(numAxisAlignedNormals, 0.9 * numPlanars);
+}
+
+TEST(LoamRegistration, featuresOfATiltedLidarFollowTheExtrinsics) {
+	Eigen::Isometry3d rangeSensorToLidar = Eigen::Isometry3d::Identity();
+	rangeSensorToLidar.translation() = Eigen::Vector3d(0.1, 0.0, 0.3);
+	rangeSensorToLidar.linear() = Eigen::AngleAxisd(20.0 * kDegToRad, Eigen::Vector3d::UnitY()).toRotationMatrix();
+	const PointCloud lidarScan = scanRoom(rangeSensorToLidar);
+	const PointCloudPtr lidarFeatures = extractLoamFeatures(lidarScan, createParameters());
+
+	LoamParameters params = createParameters();
+	params.rangeSensorToLidar_ = rangeSensorToLidar;
+	const PointCloudPtr features = extractLoamFeatures(*transform(rangeSensorToLidar.matrix(), lidarScan), params);
+	// the range sensor sits at the room origin, so features in its frame lie on the surfaces of the room
+	EXPECT_GT(features->points_.size(), 0.9 * lidarFeatures->points_.size());
+	for (const auto &p : features->points_) {
+		EXPECT_LT(distanceToSurface(p), 1e-6);
+	}
+}
+
+TEST(LoamRegistration, recoversTheMotionBetweenTwoScans) {
+	Eigen::Isometry3d motion = Eigen::Isometry3d::Identity();
+	motion.translation() = Eigen::Vector3d(0.2, -0.1, 0.05);
+	motion.linear() = Eigen::AngleAxisd(2.0 * kDegToRad, Eigen::Vector3d::UnitZ()).toRotationMatrix();
+	const LoamParameters params = createParameters();
+	const PointCloudPtr source = extractLoamFeatures(scanRoom(Eigen::Isometry3d::Identity()), params);
+	const PointCloudPtr target = extractLoamFeatures(scanRoom(motion), params);
+
+	RegistrationLoam registration;
+	registration.setMaxCorrespondenceDistance(1.0);
+	registration.setMaxNumIterations(30);
+	const auto result = registration.registerClouds(*source, *target, Transform::Identity());
+	const Transform error = Transform(result.transformation_) * motion;
+	EXPECT_GT(result.fitness_, 0.5);
+	EXPECT_LT(error.translation().norm(), 0.02);
+	EXPECT_LT(Eigen::AngleAxisd(error.rotation()).angle(), 0.2 * kDegToRad);
+}
@@ -0,0 +1,117 @@
+/*
+ * test_OccupancyMap.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+// GTest
+#include <gtest/gtest.h>
+
+// open3d_slam
+#include "open3d_slam/OccupancyMap.hpp"
+
+#include <algorithm>
+
+using namespace o3d_slam;
+
+namespace {
+const double kVoxelSize = 0.1;
+
+OccupancyVoxelMap createMap() {
+	SpaceCarvingParameters params;
+	params.voxelSize_ = kVoxelSize;
+	return OccupancyVoxelMap(Eigen::Vector3d::Constant(kVoxelSize), params);
+}
+
+PointCloud createCloud(const std::vector<Eigen::Vector3d> &points) {
+	PointCloud cloud;
+	cloud.points_ = points;
+	return cloud;
+}
+
+// scans until something is freed, returns the freed idxs sorted
+std::vector<size_t> carve(const PointCloud &scan, const Eigen::Vector3d &sensorPosition, int maxNumScans,
+		OccupancyVoxelMap *map, int *numScans) {
+	for (*numScans = 1; *numScans <= maxNumScans; ++(*numScans)) {
+		std::vector<size_t> freedIdxs = map->insertScan(scan, sensorPosition);
+		if (!freedIdxs.empty()) {
+			std::sort(freedIdxs.begin(), freedIdxs.end());
+			return freedIdxs;
+		}
+	}
+	return {};
+}
+} // namespace
+
+TEST(OccupancyVoxelMap, repeatedMissesFreeTheVoxelWithItsPoints) {
+	OccupancyVoxelMap map = createMap();
+	const PointCloud mapCloud = createCloud( { Eigen::Vector3d(2.02, 0.05, 0.05), Eigen::Vector3d(5.05, 0.05, 0.05),
+			Eigen::Vector3d(2.08, 0.03, 0.07) });
+	map.addPoints(mapCloud);
+	const PointCloud scan = createCloud( { Eigen::Vector3d(4.05, 0.05, 0.05) });
+	int numScans = 0;
+	const std::vector<size_t> freedIdxs = carve(scan, Eigen::Vector3d(0.05, 0.05, 0.05), 20, &map, &numScans);
+	EXPECT_EQ(freedIdxs, std::vector<size_t>( { 0, 2 }));
+	// a voxel of a map point counts as hit once, hence it takes more than one miss
+	const auto &p = SpaceCarvingParameters().occupancy_;
+	EXPECT_EQ(numScans, static_cast<int>(std::ceil((p.removalLogOdds_ - p.hitLogOdds_) / p.missLogOdds_)));
+	EXPECT_FALSE(map.hasVoxelContainingPoint(mapCloud.points_[0]));
+	EXPECT_TRUE(map.hasVoxelContainingPoint(mapCloud.points_[1]));
+	EXPECT_TRUE(map.insertScan(scan, Eigen::Vector3d(0.05, 0.05, 0.05)).empty());
+}
+
+TEST(OccupancyVoxelMap, voxelsHitByTheScanAreNotMissed) {
+	OccupancyVoxelMap map = createMap();
+	map.addPoints(createCloud( { Eigen::Vector3d(2.05, 0.05, 0.05) }));
+	const PointCloud scan = createCloud( { Eigen::Vector3d(2.05, 0.05, 0.05), Eigen::Vector3d(4.05, 0.05, 0.05) });
+	int numScans = 0;
+	EXPECT_TRUE(carve(scan, Eigen::Vector3d(0.05, 0.05, 0.05), 20, &map, &numScans).empty());
+}
+
+TEST(OccupancyVoxelMap, raysGrazingASurfaceDontFreeIt) {
+	OccupancyVoxelMap map = createMap();
+	PointCloud surface = createCloud( { Eigen::Vector3d(2.05, 0.05, 0.05) });
+	surface.normals_ = { Eigen::Vector3d::UnitZ() };
+	map.insertScan(surface, Eigen::Vector3d(2.05, 0.05, 3.05));
+	map.addPoints(surface);
+	const PointCloud scan = createCloud( { Eigen::Vector3d(4.05, 0.05, 0.05) });
+	int numScans = 0;
+	EXPECT_TRUE(carve(scan, Eigen::Vector3d(0.05, 0.05, 0.05), 20, &map, &numScans).empty());
+}
+
+TEST(OccupancyVoxelMap, diagonalRaysVisitEveryVoxelAlongTheLine) {
+	OccupancyVoxelMap map = createMap();
+	// the traversal steps between voxel centers, it follows the ray exactly when both ends are centers
+	const Eigen::Vector3d sensorPosition(0.05, 0.05, 0.05);
+	const Eigen::Vector3d end = sensorPosition + Eigen::Vector3d(3.1, -1.7, 0.9);
+	// points on the segment and points two voxels away from it
+	std::vector<Eigen::Vector3d> points;
+	const int numPointsOnSegment = 10;
+	for (int i = 1; i <= numPointsOnSegment; ++i) {
+		points.push_back(sensorPosition + 0.07 * i * (end - sensorPosition));
+	}
+	for (int i = 1; i <= numPointsOnSegment; ++i) {
+		points.push_back(points[i - 1] + Eigen::Vector3d(0.0, 0.0, 2.5 * kVoxelSize));
+	}
+	map.addPoints(createCloud(points));
+	int numScans = 0;
+	const std::vector<size_t> freedIdxs = carve(createCloud( { end }), sensorPosition, 20, &map, &numScans);
+	ASSERT_EQ(freedIdxs.size(), numPointsOnSegment);
+	for (int i = 0; i < numPointsOnSegment; ++i) {
+		EXPECT_EQ(freedIdxs[i], i);
+	}
+}
+
+TEST(OccupancyVoxelMap, rebuiltPointsFollowTheNewIdxs) {
+	OccupancyVoxelMap map = createMap();
+	PointCloud mapCloud = createCloud( { Eigen::Vector3d(1.05, 0.05, 0.05), Eigen::Vector3d(2.05, 0.05, 0.05),
+			Eigen::Vector3d(2.06, 0.06, 0.06) });
+	map.addPoints(mapCloud);
+	// the first point was removed and the map compacted
+	mapCloud.points_.erase(mapCloud.points_.begin());
+	map.rebuildPoints(mapCloud, { false, true });
+	int numScans = 0;
+	const std::vector<size_t> freedIdxs = carve(createCloud( { Eigen::Vector3d(4.05, 0.05, 0.05) }),
+			Eigen::Vector3d(0.05, 0.05, 0.05), 20, &map, &numScans);
+	EXPECT_EQ(freedIdxs, std::vector<size_t>( { 0 }));
+}
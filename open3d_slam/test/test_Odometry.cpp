@@ -0,0 +1,54 @@
+/*
+ * test_Odometry.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+// GTest
+#include <gtest/gtest.h>
+
+// open3d_slam
+#include "open3d_slam/Odometry.hpp"
+
+#include <cmath>
+
+using namespace o3d_slam;
+
+namespace {
+Transform createTranslation(double x) {
+	Transform T = Transform::Identity();
+	T.translation() = Eigen::Vector3d(x, 0.0, 0.0);
+	return T;
+}
+} // namespace
+
+TEST(AdaptiveCorrespondenceDistance, initialDistanceUntilTheFirstSample) {
+	AdaptiveCorrespondenceDistance distance(1.0, 0.1, 50.0, 0.01);
+	EXPECT_DOUBLE_EQ(distance.getDistance(), 1.0);
+	// deviations below the min motion carry no information about the prediction error
+	distance.update(createTranslation(0.005));
+	EXPECT_DOUBLE_EQ(distance.getDistance(), 1.0);
+}
+
+TEST(AdaptiveCorrespondenceDistance, threeTimesTheRmsDeviation) {
+	AdaptiveCorrespondenceDistance distance(1.0, 0.1, 50.0, 0.01);
+	distance.update(createTranslation(0.1));
+	EXPECT_NEAR(distance.getDistance(), 0.3, 1e-9);
+	distance.update(createTranslation(-0.2));
+	EXPECT_NEAR(distance.getDistance(), 3.0 * std::sqrt(0.5 * (0.01 + 0.04)), 1e-9);
+}
+
+TEST(AdaptiveCorrespondenceDistance, rotationCountsAtMaxRange) {
+	const double maxRange = 20.0, angle = 0.01;
+	AdaptiveCorrespondenceDistance distance(1.0, 0.1, maxRange, 0.01);
+	Transform T = Transform::Identity();
+	T.linear() = Eigen::AngleAxisd(angle, Eigen::Vector3d::UnitZ()).toRotationMatrix();
+	distance.update(T);
+	EXPECT_NEAR(distance.getDistance(), 3.0 * 2.0 * maxRange * std::sin(0.5 * angle), 1e-9);
+}
+
+TEST(AdaptiveCorrespondenceDistance, clampedToTheMinDistance) {
+	AdaptiveCorrespondenceDistance distance(1.0, 0.1, 50.0, 0.01);
+	distance.update(createTranslation(0.02));
+	EXPECT_DOUBLE_EQ(distance.getDistance(), 0.1);
+}
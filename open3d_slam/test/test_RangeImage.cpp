@@ -0,0 +1,114 @@
+/*
+ * test_RangeImage.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+// GTest
+#include <gtest/gtest.h>
+
+// open3d_slam
+#include "open3d_slam/RangeImage.hpp"
+
+#include <cmath>
+#include <limits>
+
+using namespace o3d_slam;
+
+namespace {
+const double kDegToRad = M_PI / 180.0;
+
+// row major organized scan of a floor at z = -height, rings from minElevation to maxElevation (deg)
+PointCloud scanFloor(int numRings, int numColumns, double minElevation, double maxElevation, double height) {
+	PointCloud cloud;
+	for (int r = 0; r < numRings; ++r) {
+		const double elevation = (minElevation + r * (maxElevation - minElevation) / (numRings - 1)) * kDegToRad;
+		for (int c = 0; c < numColumns; ++c) {
+			const double azimuth = -M_PI + (c + 0.5) * 2.0 * M_PI / numColumns;
+			const double range = height / std::sin(-elevation);
+			cloud.points_.push_back(range * Eigen::Vector3d(std::cos(elevation) * std::cos(azimuth),
+					std::cos(elevation) * std::sin(azimuth), std::sin(elevation)));
+		}
+	}
+	return cloud;
+}
+} // namespace
+
+TEST(RangeImage, organizedCloudSkipsMissingReturns) {
+	PointCloud cloud = scanFloor(4, 8, -20.0, -10.0, 1.5);
+	cloud.points_[3] = Eigen::Vector3d::Zero();
+	cloud.points_[10] = Eigen::Vector3d::Constant(std::numeric_limits<double>::quiet_NaN());
+	RangeImage image;
+	image.setParameters(RangeImageParameters());
+	image.setFromOrganizedCloud(cloud, 4, 8);
+	EXPECT_EQ(image.getNumRings(), 4);
+	EXPECT_EQ(image.getNumColumns(), 8);
+	EXPECT_FALSE(image.isValid(0, 3));
+	EXPECT_FALSE(image.isValid(1, 2));
+	EXPECT_TRUE(image.isValid(1, 3));
+	EXPECT_EQ(image.toPointCloud().points_.size(), 30);
+}
+
+TEST(RangeImage, ringsKeepTheClosestPointOfACell) {
+	RangeImageParameters params;
+	params.numColumns_ = 4;
+	RangeImage image;
+	image.setParameters(params);
+	PointCloud cloud;
+	cloud.points_ = { Eigen::Vector3d(5.0, 0.1, 0.0), Eigen::Vector3d(2.0, 0.05, 0.0), Eigen::Vector3d(3.0, 0.0, 0.0) };
+	image.setFromRings(cloud, { 0, 0, 0 });
+	EXPECT_EQ(image.getNumRings(), 1);
+	int numValid = 0;
+	for (int c = 0; c < image.getNumColumns(); ++c) {
+		if (image.isValid(0, c)) {
+			++numValid;
+			EXPECT_TRUE(image.getPoint(0, c).isApprox(cloud.points_[1]));
+		}
+	}
+	EXPECT_EQ(numValid, 1);
+}
+
+TEST(RangeImage, elevationGivesTheRing) {
+	RangeImageParameters params;
+	params.numColumns_ = 360;
+	RangeImage image;
+	image.setParameters(params);
+	const PointCloud cloud = scanFloor(5, 90, -20.0, -12.0, 1.5);
+	image.setFromElevation(cloud, 5, -20.0, -12.0);
+	ASSERT_EQ(image.getNumRings(), 5);
+	for (int r = 0; r < 5; ++r) {
+		const double expectedElevation = -20.0 + 2.0 * r;
+		int numValid = 0;
+		for (int c = 0; c < image.getNumColumns(); ++c) {
+			if (!image.isValid(r, c)) {
+				continue;
+			}
+			const Eigen::Vector3d &p = image.getPoint(r, c);
+			EXPECT_NEAR(std::atan2(p.z(), p.head<2>().norm()) / kDegToRad, expectedElevation, 1e-6);
+			++numValid;
+		}
+		EXPECT_EQ(numValid, 90);
+	}
+}
+
+TEST(RangeImage, floorNormalsPointUpAndFloorIsGround) {
+	RangeImageParameters params;
+	params.maxNeighbourDistance_ = 2.0;
+	RangeImage image;
+	image.setParameters(params);
+	const int numRings = 8, numColumns = 360;
+	image.setFromOrganizedCloud(scanFloor(numRings, numColumns, -30.0, -15.0, 1.5), numRings, numColumns);
+	image.estimateNormals();
+	const PointCloud cloud = image.toPointCloud();
+	ASSERT_EQ(cloud.points_.size(), numRings * numColumns);
+	ASSERT_TRUE(cloud.HasNormals());
+	for (const auto &n : cloud.normals_) {
+		EXPECT_GT(n.z(), 0.99);
+	}
+	image.computeLabels();
+	for (int r = 0; r < numRings; ++r) {
+		for (int c = 0; c < numColumns; ++c) {
+			EXPECT_EQ(image.getLabel(r, c), RangeImage::Label::Ground);
+		}
+	}
+}
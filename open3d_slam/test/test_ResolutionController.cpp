@@ -0,0 +1,92 @@
+/*
+ * test_ResolutionController.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+// GTest
+#include <gtest/gtest.h>
+
+// open3d_slam
+#include "open3d_slam/ResolutionController.hpp"
+
+using namespace o3d_slam;
+
+namespace {
+ScanResolution createFinest() {
+	ScanResolution finest;
+	finest.voxelSize_ = 0.1;
+	finest.downSamplingRatio_ = 1.0;
+	finest.maxNumIter_ = 50;
+	return finest;
+}
+
+ResolutionController createController(bool isEnabled) {
+	AdaptiveResolutionParameters p;
+	p.isEnabled_ = isEnabled;
+	p.targetLatencyMsec_ = 100.0;
+	p.maxQueueSize_ = 1;
+	ResolutionController controller;
+	controller.setParameters(p, createFinest());
+	return controller;
+}
+} // namespace
+
+TEST(ResolutionController, disabledKeepsTheFinestResolution) {
+	ResolutionController controller = createController(false);
+	for (int i = 0; i < 10; ++i) {
+		EXPECT_FALSE(controller.update(1000.0, 10));
+	}
+	EXPECT_DOUBLE_EQ(controller.getLevel(), 0.0);
+	EXPECT_DOUBLE_EQ(controller.getResolution().voxelSize_, 0.1);
+}
+
+TEST(ResolutionController, highLatencyCoarsensUpToTheBounds) {
+	ResolutionController controller = createController(true);
+	const AdaptiveResolutionParameters bounds;
+	double previousLevel = controller.getLevel();
+	for (int i = 0; i < 100; ++i) {
+		controller.update(200.0, 0);
+		EXPECT_GE(controller.getLevel(), previousLevel);
+		previousLevel = controller.getLevel();
+	}
+	EXPECT_DOUBLE_EQ(controller.getLevel(), 1.0);
+	const ScanResolution &resolution = controller.getResolution();
+	EXPECT_NEAR(resolution.voxelSize_, bounds.maxVoxelSize_, 1e-9);
+	EXPECT_NEAR(resolution.downSamplingRatio_, bounds.minDownSamplingRatio_, 1e-9);
+	EXPECT_EQ(resolution.maxNumIter_, bounds.minNumIter_);
+	EXPECT_FALSE(controller.update(200.0, 0));
+}
+
+TEST(ResolutionController, refinesOnlyWellBelowTheTarget) {
+	ResolutionController controller = createController(true);
+	for (int i = 0; i < 10; ++i) {
+		controller.update(200.0, 0);
+	}
+	// settle the latency average between the relax threshold and the target
+	for (int i = 0; i < 50; ++i) {
+		controller.update(90.0, 0);
+	}
+	const double level = controller.getLevel();
+	EXPECT_GT(level, 0.0);
+	EXPECT_FALSE(controller.update(90.0, 0));
+	EXPECT_DOUBLE_EQ(controller.getLevel(), level);
+
+	for (int i = 0; i < 100; ++i) {
+		controller.update(10.0, 0);
+	}
+	EXPECT_DOUBLE_EQ(controller.getLevel(), 0.0);
+	EXPECT_NEAR(controller.getResolution().voxelSize_, 0.1, 1e-9);
+	EXPECT_EQ(controller.getResolution().maxNumIter_, 50);
+}
+
+TEST(ResolutionController, queuedScansCoarsenRegardlessOfTheLatency) {
+	ResolutionController controller = createController(true);
+	EXPECT_TRUE(controller.update(10.0, 2));
+	EXPECT_GT(controller.getLevel(), 0.0);
+	EXPECT_GT(controller.getResolution().voxelSize_, 0.1);
+	// a scan still waiting blocks the refinement
+	const double level = controller.getLevel();
+	EXPECT_FALSE(controller.update(10.0, 1));
+	EXPECT_DOUBLE_EQ(controller.getLevel(), level);
+}
@@ -0,0 +1,110 @@
+/*
+ * test_Submap.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+// GTest
+#include <gtest/gtest.h>
+
+// open3d_slam
+#include "open3d_slam/Submap.hpp"
+#include "open3d_slam/time.hpp"
+
+using namespace o3d_slam;
+
+namespace {
+// square wall facing the sensor at the origin
+PointCloud createWall(double x, double halfSize, double spacing) {
+	PointCloud cloud;
+	for (double y = -halfSize; y <= halfSize + 1e-9; y += spacing) {
+		for (double z = -halfSize; z <= halfSize + 1e-9; z += spacing) {
+			cloud.points_.push_back(Eigen::Vector3d(x, y, z));
+		}
+	}
+	return cloud;
+}
+
+size_t countPointsCloserThan(const PointCloud &cloud, double x) {
+	size_t count = 0;
+	for (const auto &p : cloud.points_) {
+		count += p.x() < x ? 1 : 0;
+	}
+	return count;
+}
+
+MapperParameters createParameters() {
+	MapperParameters params;
+	params.mapBuilder_.carving_.occupancy_.isEnabled_ = true;
+	params.scanMatcher_.scanToMapRegType_ = ScanToMapRegistrationType::Ndt;
+	return params;
+}
+
+// small walls stay tombstoned, large ones exceed the ratio of removed points at which the map is erased
+PointCloud createFrontWall(bool isSmall) {
+	return createWall(2.05, isSmall ? 0.1 : 0.4, 0.1);
+}
+
+// scans of the back wall, rays pass through the front wall area
+void insertBackWallScans(int numScans, int *time, Submap *submap) {
+	const PointCloud scan = createWall(4.05, 1.0, 0.05);
+	for (int i = 0; i < numScans; ++i) {
+		submap->insertScan(scan, scan, Transform::Identity(), fromUniversal((*time)++), true);
+	}
+}
+
+void insertFrontWallScan(bool isSmall, int *time, Submap *submap) {
+	const PointCloud scan = createWall(4.05, 1.0, 0.05) + createFrontWall(isSmall);
+	submap->insertScan(scan, scan, Transform::Identity(), fromUniversal((*time)++), true);
+}
+} // namespace
+
+TEST(Submap, carvedPointsAreLeftOutOfTheMap) {
+	for (const bool isSmall : { true, false }) {
+		Submap submap(0, 0);
+		submap.setParameters(createParameters());
+		int time = 1;
+		insertFrontWallScan(isSmall, &time, &submap);
+		const size_t numPoints = submap.getNumMapPoints();
+		ASSERT_EQ(countPointsCloserThan(submap.getMapPointCloudCopy(), 3.0), createFrontWall(isSmall).points_.size());
+		insertBackWallScans(10, &time, &submap);
+		const PointCloud map = submap.getMapPointCloudCopy();
+		EXPECT_EQ(countPointsCloserThan(map, 3.0), 0);
+		EXPECT_EQ(map.points_.size(), numPoints - createFrontWall(isSmall).points_.size());
+		// tombstoned points are still stored until they are erased
+		EXPECT_EQ(submap.getNumMapPoints(), isSmall ? numPoints : map.points_.size());
+	}
+}
+
+TEST(Submap, reobservedSurfaceIsAddedAgain) {
+	Submap submap(0, 0);
+	submap.setParameters(createParameters());
+	int time = 1;
+	insertFrontWallScan(true, &time, &submap);
+	insertBackWallScans(10, &time, &submap);
+	ASSERT_EQ(countPointsCloserThan(submap.getMapPointCloudCopy(), 3.0), 0);
+	insertFrontWallScan(true, &time, &submap);
+	EXPECT_EQ(countPointsCloserThan(submap.getMapPointCloudCopy(), 3.0), createFrontWall(true).points_.size());
+}
+
+TEST(Submap, ndtMapOnlyHoldsTheRemainingPoints) {
+	Submap submap(0, 0);
+	const MapperParameters params = createParameters();
+	submap.setParameters(params);
+	int time = 1;
+	insertFrontWallScan(true, &time, &submap);
+	submap.getNdtMapCopy(); // maintained incrementally from now on
+	insertBackWallScans(10, &time, &submap);
+
+	NdtVoxelMap expected(Eigen::Vector3d::Constant(params.scanMatcher_.ndt_.voxelSize_),
+			params.scanMatcher_.ndt_.minNumPointsPerVoxel_);
+	expected.rebuild(submap.getMapPointCloudCopy());
+	const NdtVoxelMap ndtMap = submap.getNdtMapCopy();
+	ASSERT_EQ(ndtMap.size(), expected.size());
+	for (const auto &keyAndVoxel : expected.voxels_) {
+		const NdtVoxel *voxel = ndtMap.getVoxelPtr(keyAndVoxel.first);
+		ASSERT_NE(voxel, nullptr);
+		EXPECT_EQ(voxel->numPoints_, keyAndVoxel.second.numPoints_);
+		EXPECT_TRUE(voxel->mean_.isApprox(keyAndVoxel.second.mean_, 1e-9));
+	}
+}
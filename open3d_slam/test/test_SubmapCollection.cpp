@@ -0,0 +1,64 @@
+/*
+ * test_SubmapCollection.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+// GTest
+#include <gtest/gtest.h>
+
+// open3d_slam
+#include "open3d_slam/SubmapCollection.hpp"
+#include "open3d_slam/output.hpp"
+#include "open3d_slam/time.hpp"
+
+using namespace o3d_slam;
+
+namespace {
+PointCloud createBox(double halfSize, double spacing) {
+	PointCloud cloud;
+	for (double u = -halfSize; u <= halfSize; u += spacing) {
+		for (double v = -halfSize; v <= halfSize; v += spacing) {
+			cloud.points_.push_back(Eigen::Vector3d(u, v, -halfSize));
+			cloud.points_.push_back(Eigen::Vector3d(u, halfSize, v));
+			cloud.points_.push_back(Eigen::Vector3d(halfSize, u, v));
+		}
+	}
+	return cloud;
+}
+} // namespace
+
+TEST(SubmapCollection, saveAndLoadSession) {
+	MapperParameters params;
+	SubmapCollection submaps;
+	submaps.setParameters(params);
+	const PointCloud scan = createBox(2.0, 0.1);
+	Transform mapToRangeSensor = Transform::Identity();
+	mapToRangeSensor.translation() = Eigen::Vector3d(0.3, -0.2, 0.1);
+	ASSERT_TRUE(submaps.insertScan(scan, scan, mapToRangeSensor, fromUniversal(1)));
+	const size_t numPoints = submaps.getActiveSubmap().getMapPointCloudCopy().points_.size();
+	ASSERT_GT(numPoints, 0);
+
+	const std::string folder = ::testing::TempDir() + "open3d_slam_session_test/";
+	createDirectoryOrNoActionIfExists(folder); // false if a previous run left it behind
+	ASSERT_TRUE(submaps.saveSession(folder));
+
+	SubmapCollection loaded;
+	loaded.setParameters(params);
+	ASSERT_TRUE(loaded.loadSession(folder, Constraints(), Constraints()));
+	ASSERT_EQ(loaded.getNumSubmaps(), submaps.getNumSubmaps());
+	EXPECT_TRUE(loaded.isStartingNewTrajectory());
+	for (size_t i = 0; i < submaps.getNumSubmaps(); ++i) {
+		const Submap &original = submaps.getSubmap(i);
+		const Submap &restored = loaded.getSubmap(i);
+		EXPECT_EQ(restored.getId(), original.getId());
+		EXPECT_EQ(restored.getParentId(), original.getParentId());
+		EXPECT_TRUE(restored.getMapToSubmapOrigin().isApprox(original.getMapToSubmapOrigin(), 1e-9));
+		const PointCloud originalCloud = original.getMapPointCloudCopy();
+		const PointCloud restoredCloud = restored.getMapPointCloudCopy();
+		ASSERT_EQ(restoredCloud.points_.size(), originalCloud.points_.size());
+		for (size_t j = 0; j < originalCloud.points_.size(); ++j) {
+			EXPECT_LT((restoredCloud.points_[j] - originalCloud.points_[j]).norm(), 1e-4);
+		}
+	}
+}
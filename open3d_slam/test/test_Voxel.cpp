@@ -0,0 +1,116 @@
+/*
+ * test_Voxel.cpp
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+// GTest
+#include <gtest/gtest.h>
+
+// open3d_slam
+#include "open3d_slam/Voxel.hpp"
+
+#include <random>
+
+using namespace o3d_slam;
+
+namespace {
+PointCloud createRandomCloud(size_t numPoints, double size, unsigned int seed) {
+	std::mt19937 generator(seed);
+	std::uniform_real_distribution<double> distribution(0.0, size);
+	PointCloud cloud;
+	for (size_t i = 0; i < numPoints; ++i) {
+		cloud.points_.push_back(Eigen::Vector3d(distribution(generator), distribution(generator), distribution(generator)));
+	}
+	return cloud;
+}
+
+void expectSameDistributions(const NdtVoxelMap &map, const NdtVoxelMap &expected) {
+	ASSERT_EQ(map.size(), expected.size());
+	for (const auto &keyAndVoxel : expected.voxels_) {
+		const NdtVoxel *voxel = map.getVoxelPtr(keyAndVoxel.first);
+		ASSERT_NE(voxel, nullptr);
+		const NdtVoxel &expectedVoxel = keyAndVoxel.second;
+		EXPECT_EQ(voxel->numPoints_, expectedVoxel.numPoints_);
+		EXPECT_EQ(voxel->isValid_, expectedVoxel.isValid_);
+		if (expectedVoxel.isValid_) {
+			EXPECT_TRUE(voxel->mean_.isApprox(expectedVoxel.mean_, 1e-9));
+			EXPECT_TRUE(voxel->information_.isApprox(expectedVoxel.information_, 1e-6));
+		}
+	}
+}
+} // namespace
+
+TEST(PointCloudVoxelIndex, pointsSharingAVoxelAreAveraged) {
+	PointCloudVoxelIndex index(Eigen::Vector3d::Constant(1.0));
+	PointCloud scan;
+	scan.points_ = { Eigen::Vector3d(0.2, 0.2, 0.2), Eigen::Vector3d(1.5, 0.5, 0.5) };
+	PointCloud map;
+	index.insert(scan, &map);
+	ASSERT_EQ(map.points_.size(), 2);
+
+	scan.points_ = { Eigen::Vector3d(0.4, 0.6, 0.8), Eigen::Vector3d(2.5, 0.5, 0.5) };
+	std::vector<size_t> movedIdxs;
+	std::vector<Eigen::Vector3d> previousPositions;
+	index.insert(scan, &map, &movedIdxs, &previousPositions);
+	ASSERT_EQ(map.points_.size(), 3);
+	EXPECT_TRUE(map.points_[0].isApprox(Eigen::Vector3d(0.3, 0.4, 0.5)));
+	EXPECT_TRUE(map.points_[2].isApprox(Eigen::Vector3d(2.5, 0.5, 0.5)));
+	ASSERT_EQ(movedIdxs.size(), 1);
+	EXPECT_EQ(movedIdxs[0], 0);
+	EXPECT_TRUE(previousPositions[0].isApprox(Eigen::Vector3d(0.2, 0.2, 0.2)));
+
+	// a removed point frees its voxel, the next hit appends a new point
+	index.remove(map, { 1 });
+	scan.points_ = { Eigen::Vector3d(1.2, 0.3, 0.3) };
+	index.insert(scan, &map);
+	ASSERT_EQ(map.points_.size(), 4);
+	EXPECT_TRUE(map.points_[3].isApprox(scan.points_[0]));
+}
+
+TEST(NdtVoxelMap, incrementalUpdatesMatchARebuild) {
+	const Eigen::Vector3d voxelSize = Eigen::Vector3d::Constant(1.0);
+	PointCloudVoxelIndex index(Eigen::Vector3d::Constant(0.25));
+	NdtVoxelMap ndtMap(voxelSize, 5);
+	PointCloud map;
+	for (unsigned int seed = 0; seed < 3; ++seed) {
+		// scans after the first one move some of the map points they hit
+		const size_t nPointsBeforeInsertion = map.points_.size();
+		std::vector<size_t> movedIdxs;
+		std::vector<Eigen::Vector3d> previousPositions;
+		index.insert(createRandomCloud(400, 3.0, seed), &map, &movedIdxs, &previousPositions);
+		ndtMap.move(map, movedIdxs, previousPositions);
+		ndtMap.insert(map, nPointsBeforeInsertion);
+		if (seed > 0) {
+			EXPECT_FALSE(movedIdxs.empty());
+		}
+	}
+	NdtVoxelMap rebuilt(voxelSize, 5);
+	rebuilt.rebuild(map);
+	expectSameDistributions(ndtMap, rebuilt);
+
+	std::vector<size_t> removedIdxs;
+	std::vector<bool> isPointRemoved(map.points_.size(), false);
+	for (size_t i = 0; i < map.points_.size(); i += 3) {
+		removedIdxs.push_back(i);
+		isPointRemoved[i] = true;
+	}
+	ndtMap.remove(map, removedIdxs);
+	rebuilt.rebuild(map, isPointRemoved);
+	expectSameDistributions(ndtMap, rebuilt);
+}
+
+TEST(NdtVoxelMap, closestDistributionNeedsEnoughPoints) {
+	NdtVoxelMap ndtMap(Eigen::Vector3d::Constant(1.0), 5);
+	PointCloud cloud;
+	cloud.points_ = { Eigen::Vector3d(0.1, 0.1, 0.5), Eigen::Vector3d(0.9, 0.1, 0.5), Eigen::Vector3d(0.1, 0.9, 0.5),
+			Eigen::Vector3d(0.9, 0.9, 0.5), Eigen::Vector3d(0.5, 0.5, 0.6), Eigen::Vector3d(2.5, 0.5, 0.5) };
+	ndtMap.insert(cloud);
+	const NdtVoxel *distribution = ndtMap.getClosestDistribution(Eigen::Vector3d(0.5, 0.5, 0.5));
+	ASSERT_NE(distribution, nullptr);
+	EXPECT_TRUE(distribution->mean_.isApprox(Eigen::Vector3d(0.5, 0.5, 0.52)));
+	// the face neighbour is used when the voxel of the query has no distribution
+	EXPECT_EQ(ndtMap.getClosestDistribution(Eigen::Vector3d(1.5, 0.5, 0.5)), distribution);
+	// a single point is not a distribution
+	EXPECT_EQ(ndtMap.getClosestDistribution(Eigen::Vector3d(3.5, 0.5, 0.5)), nullptr);
+}
@@ -11,6 +11,7 @@
 #include "open3d_slam/time.hpp"
 #include "open3d_slam/typedefs.hpp"
 #include "open3d_slam/SlamWrapper.hpp"
+#include "open3d_slam/RangeDataFusion.hpp"
 
 
 namespace o3d_slam {
@@ -25,7 +26,13 @@ public:
 	virtual void startProcessing() = 0;
 	virtual void processMeasurement(const PointCloud &cloud, const Time &timestamp);
 	void accumulateAndProcessRangeData(const PointCloud &cloud, const Time &timestamp);
+	void fuseAndProcessRangeData(size_t lidarIdx, const PointCloud &cloud, const Time &timestamp);
 	void initCommonRosStuff();
+	void initRangeDataFusion();
+	void initRangeImage();
+	bool isUseRangeDataFusion() const;
+	// index of the lidar publishing on the topic, -1 if none
+	int getLidarIdx(const std::string &topic) const;
 	std::shared_ptr<SlamWrapper> getSlamPtr();
 
 
@@ -37,6 +44,9 @@ protected:
 	ros::Publisher rawCloudPub_;
 	std::string cloudTopic_;
 	std::shared_ptr<SlamWrapper> slam_;
+	std::shared_ptr<RangeDataFusion> rangeDataFusion_;
+	std::vector<std::string> lidarTopics_;
+	RangeImageParameters rangeImageParams_;
 	ros::NodeHandlePtr nh_;
 
 };
@@ -28,9 +28,9 @@ public:
 	 void processMeasurement(const PointCloud &cloud, const Time &timestamp) override;
 
 private:
-	 void cloudCallback(const sensor_msgs::PointCloud2ConstPtr &msg);
+	 void cloudCallback(const sensor_msgs::PointCloud2ConstPtr &msg, size_t lidarIdx);
 
-	ros::Subscriber cloudSubscriber_;
+	std::vector<ros::Subscriber> cloudSubscribers_;
 
 };
 
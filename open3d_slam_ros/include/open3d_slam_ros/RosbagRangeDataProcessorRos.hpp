@@ -20,6 +20,14 @@ namespace o3d_slam {
 class RosbagRangeDataProcessorRos : public DataProcessorRos  {
 
 	using BASE = DataProcessorRos;
+	struct DecodedCloud {
+		PointCloud cloud_;
+		Time time_;
+		ros::Time stamp_;
+		int lidarIdx_ = 0;
+		bool isValid_ = true;
+	};
+
 public:
 	RosbagRangeDataProcessorRos(ros::NodeHandlePtr nh);
 	~RosbagRangeDataProcessorRos() override = default;
@@ -29,10 +37,13 @@ public:
 	 void processMeasurement(const PointCloud &cloud, const Time &timestamp) override;
 
 private:
-	 void cloudCallback(const sensor_msgs::PointCloud2ConstPtr &msg);
+	 static DecodedCloud decode(const sensor_msgs::PointCloud2ConstPtr &msg, int lidarIdx,
+			 const RangeImageParameters &rangeImageParams);
 	 void readRosbag(const rosbag::Bag &bag);
 
 	std::string rosbagFilename_;
+	size_t numDecodingThreads_ = 4;
+	size_t decodingQueueSize_ = 100;
 };
 
 } // namespace o3d_slam
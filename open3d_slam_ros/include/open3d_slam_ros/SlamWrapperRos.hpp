@@ -38,6 +38,7 @@ private:
 	void tfWorker();
 	void visualizationWorker();
 	void odomPublisherWorker();
+	void extrapolatedPosePublisherWorker();
 
 	void publishMaps(const Time &time);
 	void publishDenseMap(const Time &time);
@@ -46,11 +47,13 @@ private:
 	ros::NodeHandlePtr nh_;
 	std::shared_ptr<tf2_ros::TransformBroadcaster> tfBroadcaster_;
 	ros::Publisher odometryInputPub_, mappingInputPub_, submapOriginsPub_, assembledMapPub_, denseMapPub_,
-			submapsPub_;
+			submapsPub_, meshPub_;
 	ros::Publisher scan2scanTransformPublisher_, scan2scanOdomPublisher_, scan2mapTransformPublisher_, scan2mapOdomPublisher_;
+	ros::Publisher extrapolatedOdomPublisher_;
 	ros::ServiceServer saveMapSrv_, saveSubmapsSrv_;
 	bool isVisualizationFirstTime_ = true;
-	std::thread tfWorker_, visualizationWorker_, odomPublisherWorker_;
+	std::thread tfWorker_, visualizationWorker_, odomPublisherWorker_, extrapolatedPosePublisherWorker_;
+	double extrapolatedPosePublishRate_ = 0.0;
 	Time prevPublishedTimeScanToScan_, prevPublishedTimeScanToMap_;
   Time prevPublishedTimeScanToScanOdom_, prevPublishedTimeScanToMapOdom_;
 
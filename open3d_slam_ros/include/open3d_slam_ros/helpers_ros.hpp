@@ -8,6 +8,7 @@
 #pragma once
 #include <open3d/geometry/PointCloud.h>
 #include <open3d/geometry/MeshBase.h>
+#include <open3d/geometry/TriangleMesh.h>
 #include <sensor_msgs/PointCloud2.h>
 #include <sensor_msgs/Image.h>
 #include <geometry_msgs/Pose.h>
@@ -18,6 +19,7 @@
 #include <visualization_msgs/MarkerArray.h>
 #include <ros/time.h>
 #include "open3d_slam/time.hpp"
+#include "open3d_slam/Parameters.hpp"
 
 
 namespace o3d_slam {
@@ -30,8 +32,12 @@ geometry_msgs::Point createPoint(double x, double y, double z);
 void drawAxes(const Eigen::Vector3d& p, const Eigen::Quaterniond& q, double scale, double line_width, visualization_msgs::Marker* marker);
 
 void assembleColoredPointCloud(const SubmapCollection &submaps, open3d::geometry::PointCloud *cloud);
+// meshes of all submaps that were meshed so far
+void assembleMesh(const SubmapCollection &submaps, open3d::geometry::TriangleMesh *mesh);
 
 void publishCloud(const open3d::geometry::PointCloud &cloud, const std::string &frame_id, const ros::Time &timestamp,ros::Publisher &pub);
+void publishMesh(const open3d::geometry::TriangleMesh &mesh, const std::string &frame_id, const ros::Time &timestamp,
+		ros::Publisher &pub);
 
 geometry_msgs::Pose getPose(const Eigen::MatrixXd &T);
 
@@ -43,6 +49,13 @@ void publishTfTransform(const Eigen::Matrix4d &Mat, const ros::Time &time, const
 bool lookupTransform(const std::string &target_frame, const std::string &source_frame, const ros::Time &time,const tf2_ros::Buffer &tfBuffer,
 		Eigen::Isometry3d *transform);
 
+// ring of every point from the "ring" field, false if the cloud has none
+bool readRings(const sensor_msgs::PointCloud2 &msg, std::vector<int> *rings);
+// converts through a range image if enabled, the rows of organized clouds are used as rings
+// clouds without rings are projected by elevation, returns false if the cloud could not be converted
+bool convertRangeData(const sensor_msgs::PointCloud2 &msg, const RangeImageParameters &p,
+		open3d::geometry::PointCloud *cloud);
+
 ros::Time toRos(Time time);
 
 Time fromRos(const ::ros::Time& time);
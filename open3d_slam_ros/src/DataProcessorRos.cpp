@@ -31,6 +31,58 @@ void DataProcessorRos::processMeasurement(const PointCloud &cloud, const Time &t
 	std::cout << "Warning you have not implemented processMeasurement!!! \n";
 }
 
+void DataProcessorRos::initRangeDataFusion() {
+	RangeDataFusionParameters params;
+	loadParameters(slam_->getParameterFilePath(), &params);
+	if (params.lidars_.empty()) {
+		lidarTopics_ = { cloudTopic_ };
+		return;
+	}
+	if (params.isUndistortLidars_ && slam_->getMotionCompensationParameters().isUndistortInputCloud_) {
+		throw std::runtime_error("Lidars are undistorted in the range data fusion, disable the motion compensation");
+	}
+	lidarTopics_.clear();
+	for (const auto &lidar : params.lidars_) {
+		lidarTopics_.push_back(lidar.topic_);
+		std::cout << "Range data fusion, lidar topic: " << lidar.topic_ << "\n";
+	}
+	rangeDataFusion_ = std::make_shared<RangeDataFusion>(slam_->getOdometryToRangeSensorBuffer());
+	rangeDataFusion_->setParameters(params);
+}
+
+void DataProcessorRos::initRangeImage() {
+	loadParameters(slam_->getParameterFilePath(), &rangeImageParams_);
+	if (rangeImageParams_.isUseRangeImage_) {
+		std::cout << "Converting the range data through a range image \n";
+	}
+}
+
+bool DataProcessorRos::isUseRangeDataFusion() const {
+	return rangeDataFusion_ != nullptr;
+}
+
+int DataProcessorRos::getLidarIdx(const std::string &topic) const {
+	for (size_t i = 0; i < lidarTopics_.size(); ++i) {
+		if (topic == lidarTopics_.at(i) || "/" + topic == lidarTopics_.at(i)) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+void DataProcessorRos::fuseAndProcessRangeData(size_t lidarIdx, const PointCloud &cloud, const Time &timestamp) {
+	if (!isUseRangeDataFusion()) {
+		accumulateAndProcessRangeData(cloud, timestamp);
+		return;
+	}
+	rangeDataFusion_->addRangeData(lidarIdx, cloud, timestamp);
+	PointCloud fusedCloud;
+	Time fusedTimestamp;
+	while (rangeDataFusion_->popFusedRangeData(&fusedCloud, &fusedTimestamp)) {
+		accumulateAndProcessRangeData(fusedCloud, fusedTimestamp);
+	}
+}
+
 std::shared_ptr<SlamWrapper> DataProcessorRos::getSlamPtr() {
 	return slam_;
 }
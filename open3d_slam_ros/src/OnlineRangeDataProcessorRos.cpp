@@ -24,12 +24,19 @@ void OnlineRangeDataProcessorRos::initialize() {
 	initCommonRosStuff();
 	slam_ = std::make_shared<SlamWrapperRos>(nh_);
 	slam_->loadParametersAndInitialize();
-	
+	initRangeDataFusion();
+	initRangeImage();
 }
 
 void OnlineRangeDataProcessorRos::startProcessing() {
 	slam_->startWorkers();
-	cloudSubscriber_ = nh_->subscribe(cloudTopic_, 100, &OnlineRangeDataProcessorRos::cloudCallback,this);
+	for (size_t i = 0; i < lidarTopics_.size(); ++i) {
+		const boost::function<void(const sensor_msgs::PointCloud2ConstPtr&)> callback =
+				[this, i](const sensor_msgs::PointCloud2ConstPtr &msg) {
+					cloudCallback(msg, i);
+				};
+		cloudSubscribers_.push_back(nh_->subscribe<sensor_msgs::PointCloud2>(lidarTopics_.at(i), 100, callback));
+	}
 	ros::spin();
 	slam_->stopWorkers();
 }
@@ -41,11 +48,13 @@ void OnlineRangeDataProcessorRos::processMeasurement(const PointCloud &cloud, co
 
 }
 
-void OnlineRangeDataProcessorRos::cloudCallback(const sensor_msgs::PointCloud2ConstPtr &msg) {
+void OnlineRangeDataProcessorRos::cloudCallback(const sensor_msgs::PointCloud2ConstPtr &msg, size_t lidarIdx) {
 	open3d::geometry::PointCloud cloud;
-	open3d_conversions::rosToOpen3d(msg, cloud, false);
+	if (!convertRangeData(*msg, rangeImageParams_, &cloud)) {
+		return;
+	}
 	const Time timestamp = fromRos(msg->header.stamp);
-	accumulateAndProcessRangeData(cloud, timestamp);
+	fuseAndProcessRangeData(lidarIdx, cloud, timestamp);
 }
 
 
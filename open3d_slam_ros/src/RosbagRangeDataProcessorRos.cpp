@@ -17,10 +17,23 @@
 #include "open3d_slam_ros/helpers_ros.hpp"
 #include "open3d_slam/time.hpp"
 #include "open3d_slam/frames.hpp"
+#include "open3d_slam/helpers.hpp"
+#include "open3d_slam/ThreadPool.hpp"
 #include <rosbag/view.h>
 
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+
 namespace o3d_slam {
 
+namespace {
+const size_t kSpinEveryNclouds = 20;
+} // namespace
+
 RosbagRangeDataProcessorRos::RosbagRangeDataProcessorRos(ros::NodeHandlePtr nh) :
 		BASE(nh) {
 
@@ -30,8 +43,13 @@ void RosbagRangeDataProcessorRos::initialize() {
 	initCommonRosStuff();
 	slam_ = std::make_shared<SlamWrapperRos>(nh_);
 	slam_->loadParametersAndInitialize();
+	initRangeDataFusion();
+	initRangeImage();
 	rosbagFilename_ = nh_->param<std::string>("rosbag_filepath", "");
 				std::cout << "Reading from rosbag: " << rosbagFilename_ << "\n";
+	numDecodingThreads_ = std::max(1, nh_->param<int>("num_decoding_threads", 4));
+	decodingQueueSize_ = std::max(1, nh_->param<int>("decoding_queue_size", 100));
+	slam_->setInputBufferSizeLimit(std::max(2, nh_->param<int>("input_buffer_size", 100)));
 
 }
 
@@ -59,61 +77,124 @@ void RosbagRangeDataProcessorRos::processMeasurement(const PointCloud &cloud, co
 }
 
 void RosbagRangeDataProcessorRos::readRosbag(const rosbag::Bag &bag) {
-	std::vector<std::string> topics;
-	topics.push_back(cloudTopic_);
-	rosbag::View view(bag, rosbag::TopicQuery(topics));
+	rosbag::View view(bag, rosbag::TopicQuery(lidarTopics_));
 	Timer rosbagTimer;
 	ros::Time lastTimestamp;
 	bool isFirstMessage = true;
 	Timer rosbagProcessingTimer;
-	BOOST_FOREACH(rosbag::MessageInstance const m, view) {
-		if (m.getTopic() == cloudTopic_ || ("/" + m.getTopic() == cloudTopic_)) {
-			sensor_msgs::PointCloud2::ConstPtr cloud = m.instantiate<sensor_msgs::PointCloud2>();
-			if (cloud != nullptr) {
-				if (isFirstMessage) {
-					isFirstMessage = false;
-					lastTimestamp = cloud->header.stamp;
-				}
-				//      	std::cout << "reading cloud msg with seq: " << cloud->header.seq << std::endl;
-				while (true) {
-					const bool isOdomBufferFull = slam_->getOdometryBufferSize() + 1
-							>= slam_->getOdometryBufferSizeLimit();
-					const bool isMappingBufferFull = slam_->getMappingBufferSize() + 1
-							>= slam_->getMappingBufferSizeLimit();
-
-					if (!isOdomBufferFull && !isMappingBufferFull) {
-						cloudCallback(cloud);
-						break;
-					} else {
-						std::this_thread::sleep_for(std::chrono::milliseconds(20));
-					}
-					ros::spinOnce();
-					if (!ros::ok()) {
-						slam_->stopWorkers();
-						return;
-					}
-				} // end while
-				const double elapsedWallTime = rosbagProcessingTimer.elapsedSec();
-				if (elapsedWallTime > 15.0) {
-					const double elapsedRosbagTime = (cloud->header.stamp - lastTimestamp).toSec();
-					std::cout << "ROSBAG PLAYER: Rosbag messages pulsed at: "
-							<< 100.0 * elapsedRosbagTime / elapsedWallTime << " % realtime speed \n";
-					rosbagProcessingTimer.reset();
-					lastTimestamp = cloud->header.stamp;
-				}
-				ros::spinOnce();
-			} // end if checking for the null ptr
-		} // end if checking for the right topic
+
+	// bag reading and deserialization happen on the reader thread (rosbag::Bag is not thread safe),
+	// conversion and filtering in the pool. Results are consumed here in the order they were read.
+	ThreadPool decodingPool(numDecodingThreads_);
+	std::deque<std::future<DecodedCloud>> decodedClouds;
+	std::mutex decodedCloudsMutex;
+	std::condition_variable decodedCloudsCv;
+	bool isReadingFinished = false;
+	bool isAbort = false;
+	std::thread reader([&]() {
+		for (const rosbag::MessageInstance &m : view) {
+			const int lidarIdx = getLidarIdx(m.getTopic());
+			if (lidarIdx < 0) {
+				continue;
+			}
+			sensor_msgs::PointCloud2::ConstPtr msg = m.instantiate<sensor_msgs::PointCloud2>();
+			if (msg == nullptr) {
+				continue;
+			}
+			std::unique_lock<std::mutex> lck(decodedCloudsMutex);
+			decodedCloudsCv.wait(lck, [&]() {
+				return isAbort || decodedClouds.size() < decodingQueueSize_;
+			});
+			if (isAbort) {
+				break;
+			}
+			const RangeImageParameters &rangeImageParams = rangeImageParams_;
+			decodedClouds.push_back(decodingPool.enqueue([msg, lidarIdx, &rangeImageParams]() {
+				return decode(msg, lidarIdx, rangeImageParams);
+			}));
+			decodedCloudsCv.notify_all();
+		}
+		std::lock_guard<std::mutex> lck(decodedCloudsMutex);
+		isReadingFinished = true;
+		decodedCloudsCv.notify_all();
+	});
+	auto abortReading = [&]() {
+		if (!reader.joinable()) {
+			return;
+		}
+		{
+			std::lock_guard<std::mutex> lck(decodedCloudsMutex);
+			isAbort = true;
+		}
+		decodedCloudsCv.notify_all();
+		reader.join();
+	};
+	// the reader has to be joined on every way out of here, including exceptions
+	struct ReaderGuard {
+		std::function<void()> abortReading_;
+		~ReaderGuard() {
+			abortReading_();
+		}
+	} readerGuard { abortReading };
+
+	size_t numProcessedClouds = 0;
+	while (true) {
+		std::future<DecodedCloud> decodedCloud;
+		{
+			std::unique_lock<std::mutex> lck(decodedCloudsMutex);
+			decodedCloudsCv.wait(lck, [&]() {
+				return isReadingFinished || !decodedClouds.empty();
+			});
+			if (decodedClouds.empty()) {
+				break;
+			}
+			decodedCloud = std::move(decodedClouds.front());
+			decodedClouds.pop_front();
+		}
+		decodedCloudsCv.notify_all();
+		DecodedCloud cloud;
+		try {
+			cloud = decodedCloud.get();
+		} catch (const std::exception &e) {
+			std::cerr << "Skipping a point cloud that could not be decoded: " << e.what() << "\n";
+			continue;
+		}
+		if (!cloud.isValid_) {
+			continue;
+		}
+		if (isFirstMessage) {
+			isFirstMessage = false;
+			lastTimestamp = cloud.stamp_;
+		}
+		while (!slam_->waitForInputBufferSpace(std::chrono::milliseconds(100))) {
+			if (!ros::ok()) {
+				return;
+			}
+		}
+		fuseAndProcessRangeData(cloud.lidarIdx_, cloud.cloud_, cloud.time_);
+		const double elapsedWallTime = rosbagProcessingTimer.elapsedSec();
+		if (elapsedWallTime > 15.0) {
+			const double elapsedRosbagTime = (cloud.stamp_ - lastTimestamp).toSec();
+			std::cout << "ROSBAG PLAYER: Rosbag messages pulsed at: "
+					<< 100.0 * elapsedRosbagTime / elapsedWallTime << " % realtime speed \n";
+			rosbagProcessingTimer.reset();
+			lastTimestamp = cloud.stamp_;
+		}
+		if (++numProcessedClouds % kSpinEveryNclouds == 0) {
+			ros::spinOnce();
+		}
 		if (!ros::ok()) {
-			slam_->stopWorkers();
 			return;
 		}
-	} // end foreach
+	}
+	reader.join();
 
 	const ros::Time bag_begin_time = view.getBeginTime();
 	const ros::Time bag_end_time = view.getEndTime();
-	std::cout << "Rosbag processing finished. Rosbag duration: " << (bag_end_time - bag_begin_time).toSec()
-			<< " Time elapsed for processing: " << rosbagTimer.elapsedSec() << " sec. \n \n";
+	const double rosbagDuration = (bag_end_time - bag_begin_time).toSec();
+	std::cout << "Rosbag processing finished. Rosbag duration: " << rosbagDuration
+			<< " Time elapsed for processing: " << rosbagTimer.elapsedSec() << " sec, realtime factor: "
+			<< rosbagDuration / rosbagTimer.elapsedSec() << " \n \n";
 	// a bit of a hack, this extra thread listens to ros shutdown
 	// otherwise we might get stuck in a loop
 	bool isProcessingFinished = false;
@@ -135,11 +216,14 @@ void RosbagRangeDataProcessorRos::readRosbag(const rosbag::Bag &bag) {
 	rosSpinner.join();
 }
 
-void RosbagRangeDataProcessorRos::cloudCallback(const sensor_msgs::PointCloud2ConstPtr &msg) {
-	open3d::geometry::PointCloud cloud;
-	open3d_conversions::rosToOpen3d(msg, cloud, false);
-	const Time timestamp = fromRos(msg->header.stamp);
-	accumulateAndProcessRangeData(cloud, timestamp);
+RosbagRangeDataProcessorRos::DecodedCloud RosbagRangeDataProcessorRos::decode(
+		const sensor_msgs::PointCloud2ConstPtr &msg, int lidarIdx, const RangeImageParameters &rangeImageParams) {
+	DecodedCloud decoded;
+	decoded.isValid_ = convertRangeData(*msg, rangeImageParams, &decoded.cloud_);
+	decoded.time_ = fromRos(msg->header.stamp);
+	decoded.stamp_ = msg->header.stamp;
+	decoded.lidarIdx_ = lidarIdx;
+	return decoded;
 }
 
 
@@ -24,6 +24,7 @@
 #include "open3d_slam/constraint_builders.hpp"
 #include "open3d_slam/Odometry.hpp"
 #include "nav_msgs/Odometry.h"
+#include "open3d_slam_msgs/PolygonMesh.h"
 
 #ifdef open3d_slam_ros_OPENMP_FOUND
 #include <omp.h>
@@ -56,6 +57,10 @@ SlamWrapperRos::~SlamWrapperRos() {
       odomPublisherWorker_.join();
     std::cout << "Joined odom publisher worker \n";
   }
+	if (extrapolatedPosePublisherWorker_.joinable()) {
+		extrapolatedPosePublisherWorker_.join();
+		std::cout << "Joined extrapolated pose publisher worker \n";
+	}
 }
 
 void SlamWrapperRos::startWorkers() {
@@ -70,6 +75,11 @@ void SlamWrapperRos::startWorkers() {
       odomPublisherWorker();
     });
 	}
+	if (extrapolatedPosePublishRate_ > 0.0) {
+		extrapolatedPosePublisherWorker_ = std::thread([this]() {
+			extrapolatedPosePublisherWorker();
+		});
+	}
 
 	BASE::startWorkers();
 }
@@ -122,6 +132,27 @@ void SlamWrapperRos::odomPublisherWorker() {
     }
 }
 
+void SlamWrapperRos::extrapolatedPosePublisherWorker() {
+	ros::Rate r(extrapolatedPosePublishRate_);
+	while (ros::ok()) {
+		if (isPoseExtrapolationAvailable() && extrapolatedOdomPublisher_.getNumSubscribers() > 0) {
+			const ros::Time timestamp = ros::Time::now();
+			const Transform T = getExtrapolatedMapToRangeSensor(fromRos(timestamp));
+			const geometry_msgs::TransformStamped transformMsg = o3d_slam::toRos(T.matrix(), timestamp, mapFrame,
+					rangeSensorFrame);
+			nav_msgs::Odometry odomMsg;
+			odomMsg.header = transformMsg.header;
+			odomMsg.child_frame_id = transformMsg.child_frame_id;
+			odomMsg.pose.pose.orientation = transformMsg.transform.rotation;
+			odomMsg.pose.pose.position.x = transformMsg.transform.translation.x;
+			odomMsg.pose.pose.position.y = transformMsg.transform.translation.y;
+			odomMsg.pose.pose.position.z = transformMsg.transform.translation.z;
+			extrapolatedOdomPublisher_.publish(odomMsg);
+		}
+		r.sleep();
+	}
+}
+
 void SlamWrapperRos::tfWorker() {
 
 	ros::WallRate r(20.0);
@@ -178,6 +209,7 @@ void SlamWrapperRos::loadParametersAndInitialize() {
 	denseMapPub_ = nh_->advertise<sensor_msgs::PointCloud2>("dense_map", 1, true);
 
 	submapsPub_ = nh_->advertise<sensor_msgs::PointCloud2>("submaps", 1, true);
+	meshPub_ = nh_->advertise<open3d_slam_msgs::PolygonMesh>("mesh", 1, true);
 	submapOriginsPub_ = nh_->advertise<visualization_msgs::MarkerArray>("submap_origins", 1, true);
 
 	saveMapSrv_ = nh_->advertiseService("save_map", &SlamWrapperRos::saveMapCallback, this);
@@ -187,6 +219,8 @@ void SlamWrapperRos::loadParametersAndInitialize() {
 	scan2scanOdomPublisher_ = nh_->advertise<nav_msgs::Odometry>("scan2scan_odometry", 1, true);
 	scan2mapTransformPublisher_ = nh_->advertise<geometry_msgs::TransformStamped>("scan2map_transform", 1, true);
   scan2mapOdomPublisher_ = nh_->advertise<nav_msgs::Odometry>("scan2map_odometry", 1, true);
+	extrapolatedOdomPublisher_ = nh_->advertise<nav_msgs::Odometry>("scan2map_extrapolated_odometry", 1, false);
+	extrapolatedPosePublishRate_ = nh_->param<double>("extrapolated_pose_publish_rate", 0.0);
 
 	//	auto &logger = open3d::utility::Logger::GetInstance();
 	//	logger.SetVerbosityLevel(open3d::utility::VerbosityLevel::Debug);
@@ -251,6 +285,11 @@ void SlamWrapperRos::publishMaps(const Time &time) {
 		voxelize(visualizationParameters_.submapVoxelSize_, &cloud);
 		o3d_slam::publishCloud(cloud, o3d_slam::frames::mapFrame, timestamp, submapsPub_);
 	}
+	if (mapperParams_.meshing_.isEnabled_ && meshPub_.getNumSubscribers() > 0) {
+		open3d::geometry::TriangleMesh mesh;
+		o3d_slam::assembleMesh(mapper_->getSubmaps(), &mesh);
+		o3d_slam::publishMesh(mesh, o3d_slam::frames::mapFrame, timestamp, meshPub_);
+	}
 
 	visualizationUpdateTimer_.reset();
 	isVisualizationFirstTime_ = false;
@@ -7,6 +7,7 @@
 
 #include "open3d_slam_ros/helpers_ros.hpp"
 #include "open3d_slam/SubmapCollection.hpp"
+#include "open3d_slam/RangeImage.hpp"
 #include <random>
 // ros stuff
 #include "open3d_conversions/open3d_conversions.h"
@@ -16,11 +17,24 @@
 #include <tf2/convert.h>
 #include <tf2_eigen/tf2_eigen.h>
 #include <nav_msgs/Odometry.h>
+#include <sensor_msgs/point_cloud2_iterator.h>
 #include "open3d_slam_ros/Color.hpp"
+#include "open3d_slam_msgs/PolygonMesh.h"
 
 
 namespace o3d_slam {
 
+namespace {
+template<typename T>
+void readIntField(const sensor_msgs::PointCloud2 &msg, const std::string &name, std::vector<int> *values) {
+	sensor_msgs::PointCloud2ConstIterator<T> it(msg, name);
+	values->resize(msg.height * msg.width);
+	for (size_t i = 0; i < values->size(); ++i, ++it) {
+		(*values)[i] = static_cast<int>(*it);
+	}
+}
+} // namespace
+
 void publishSubmapCoordinateAxes(const SubmapCollection &submaps, const std::string &frame_id,
 		const ros::Time &timestamp, const ros::Publisher &pub) {
 	visualization_msgs::MarkerArray msg;
@@ -71,6 +85,15 @@ void assembleColoredPointCloud(const SubmapCollection &submaps, open3d::geometry
 	}
 }
 
+void assembleMesh(const SubmapCollection &submaps, open3d::geometry::TriangleMesh *mesh) {
+	for (size_t j = 0; j < submaps.getNumSubmaps(); ++j) {
+		const auto submapMesh = submaps.getSubmap(j).getMesh();
+		if (submapMesh != nullptr) {
+			*mesh += *submapMesh;
+		}
+	}
+}
+
 void publishCloud(const open3d::geometry::PointCloud &cloud, const std::string &frame_id, const ros::Time &timestamp,
 		ros::Publisher &pub) {
 	if (pub.getNumSubscribers() > 0) {
@@ -82,6 +105,17 @@ void publishCloud(const open3d::geometry::PointCloud &cloud, const std::string &
 	}
 }
 
+void publishMesh(const open3d::geometry::TriangleMesh &mesh, const std::string &frame_id, const ros::Time &timestamp,
+		ros::Publisher &pub) {
+	if (pub.getNumSubscribers() > 0) {
+		open3d_slam_msgs::PolygonMesh msg;
+		open3d_conversions::open3dToRos(mesh, frame_id, msg);
+		msg.cloud.header.stamp = timestamp;
+		msg.header.stamp = timestamp;
+		pub.publish(msg);
+	}
+}
+
 void publishTfTransform(const Eigen::Matrix4d &Mat, const ros::Time &time, const std::string &frame,
 		const std::string &childFrame, tf2_ros::TransformBroadcaster *broadcaster) {
 	geometry_msgs::TransformStamped transformStamped = o3d_slam::toRos(Mat, time, frame, childFrame);
@@ -163,6 +197,74 @@ void drawAxes(const Eigen::Vector3d &p, const Eigen::Quaterniond &q, double scal
 	tf::quaternionEigenToMsg(q, marker->pose.orientation);
 }
 
+bool readRings(const sensor_msgs::PointCloud2 &msg, std::vector<int> *rings) {
+	const std::string ringField = "ring";
+	for (const auto &field : msg.fields) {
+		if (field.name != ringField) {
+			continue;
+		}
+		switch (field.datatype) {
+		case sensor_msgs::PointField::UINT8:
+			readIntField<uint8_t>(msg, ringField, rings);
+			return true;
+		case sensor_msgs::PointField::UINT16:
+			readIntField<uint16_t>(msg, ringField, rings);
+			return true;
+		case sensor_msgs::PointField::INT16:
+			readIntField<int16_t>(msg, ringField, rings);
+			return true;
+		case sensor_msgs::PointField::UINT32:
+			readIntField<uint32_t>(msg, ringField, rings);
+			return true;
+		case sensor_msgs::PointField::INT32:
+			readIntField<int32_t>(msg, ringField, rings);
+			return true;
+		case sensor_msgs::PointField::FLOAT32:
+			readIntField<float>(msg, ringField, rings);
+			return true;
+		default:
+			std::cerr << "Unsupported datatype of the ring field: " << static_cast<int>(field.datatype) << "\n";
+			return false;
+		}
+	}
+	return false;
+}
+
+bool convertRangeData(const sensor_msgs::PointCloud2 &msg, const RangeImageParameters &p,
+		open3d::geometry::PointCloud *cloud) {
+	cloud->Clear();
+	open3d_conversions::rosToOpen3d(msg, *cloud, false);
+	const size_t numPointsInMsg = static_cast<size_t>(msg.height) * msg.width;
+	if (cloud->points_.size() != numPointsInMsg) {
+		// the converter only knows rgb or intensity as the fourth field, read xyz only for any other layout
+		cloud->Clear();
+		open3d_conversions::rosToOpen3d(msg, *cloud, true);
+	}
+	if (!p.isUseRangeImage_) {
+		return true;
+	}
+	if (cloud->points_.size() != numPointsInMsg) {
+		std::cerr << "Range image: converted " << cloud->points_.size() << " points from a cloud with "
+				<< numPointsInMsg << " points, skipping the cloud \n";
+		cloud->Clear();
+		return false;
+	}
+	RangeImage rangeImage;
+	rangeImage.setParameters(p);
+	std::vector<int> rings;
+	if (msg.height > 1) {
+		rangeImage.setFromOrganizedCloud(*cloud, msg.height, msg.width);
+	} else if (readRings(msg, &rings) && rings.size() == cloud->points_.size()) {
+		rangeImage.setFromRings(*cloud, rings);
+	} else {
+		rangeImage.setFromElevation(*cloud, p.numRings_, p.minElevation_, p.maxElevation_);
+	}
+	if (p.isEstimateNormals_) {
+		rangeImage.estimateNormals();
+	}
+	*cloud = rangeImage.toPointCloud();
+	return true;
+}
 
 ros::Time toRos(Time time) {
 	int64_t uts_timestamp = toUniversal(time);